@@ -0,0 +1,78 @@
+// checksum_bench.cpp - Incremental vs full checksum on a synthetic RC3-sized save
+#include "../src/core/save_file.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+static std::string WriteSyntheticSave(size_t size) {
+    std::vector<uint8_t> buf(size);
+    uint32_t x = 0xC0FFEEu;
+    for (size_t i = 0; i < size; i++) {
+        x = x * 1664525u + 1013904223u;
+        buf[i] = (uint8_t)(x >> 24);
+    }
+
+    std::string path = "checksum_bench_save.bin";
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(buf.data()), buf.size());
+    return path;
+}
+
+static double MicrosSince(std::chrono::steady_clock::time_point start) {
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+int main() {
+    const size_t SAVE_SIZE = 2 * 1024 * 1024;
+    std::string path = WriteSyntheticSave(SAVE_SIZE);
+
+    SaveFile save;
+    auto loadStart = std::chrono::steady_clock::now();
+    if (!save.Load(path)) {
+        printf("Failed to load %s\n", path.c_str());
+        return 1;
+    }
+    printf("Load (read + block CRCs): %.1f us\n", MicrosSince(loadStart));
+
+    // Bolt edit, then the checksum work a Save would do
+    const int ROUNDS = 1000;
+    double incrementalTotal = 0;
+    double fullTotal = 0;
+    int mismatches = 0;
+    uint32_t x = 12345;
+
+    for (int round = 0; round < ROUNDS; round++) {
+        x = x * 1664525u + 1013904223u;
+        save.WriteInt32(36, (int32_t)(x % 9999999));
+
+        // Every tenth round also scatters edits across the file, including
+        // the block that holds the checksum hole
+        if (round % 10 == 0) {
+            for (int i = 0; i < 8; i++) {
+                x = x * 1664525u + 1013904223u;
+                save.WriteByte(x % SAVE_SIZE, (uint8_t)(x >> 8));
+            }
+            save.WriteByte(SAVE_SIZE - 5, (uint8_t)round);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        uint32_t incremental = save.CalculateChecksumIncremental();
+        incrementalTotal += MicrosSince(start);
+
+        start = std::chrono::steady_clock::now();
+        uint32_t full = save.CalculateChecksum();
+        fullTotal += MicrosSince(start);
+
+        if (incremental != full) mismatches++;
+    }
+
+    printf("Incremental checksum: %.2f us/save\n", incrementalTotal / ROUNDS);
+    printf("Full checksum:        %.2f us/save\n", fullTotal / ROUNDS);
+    printf("Bit-identical:        %s (%d mismatches in %d rounds)\n",
+           mismatches == 0 ? "yes" : "NO", mismatches, ROUNDS);
+
+    std::remove(path.c_str());
+    return mismatches == 0 ? 0 : 1;
+}
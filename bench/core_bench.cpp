@@ -0,0 +1,306 @@
+// core_bench.cpp - Latency of the core save operations, with JSON output
+//
+//   core_bench [--iterations <n>] [--json <file>] [--dir <scratch dir>]
+//
+// A deterministic synthetic save is generated for each game at the middle of
+// its size class: table fields hold plausible values, everything else is
+// seeded noise, so every run and every machine sees the same bytes. Each
+// operation is timed one call at a time and reported as p50/p99. On Linux,
+// cycles, instructions and cache misses are read per call where the kernel
+// allows perf_event_open; elsewhere (or when it is denied) they are omitted.
+// --json writes the same numbers in a form two runs can be diffed with.
+#include "../src/core/game_detect.h"
+#include "../src/core/save_file.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    // Hardware counters for the calling thread; Available() is false when the
+    // kernel refuses them (containers, perf_event_paranoid) or off Linux
+    class PerfCounters {
+    public:
+        static const int COUNT = 3;     // cycles, instructions, cache misses
+
+        PerfCounters() {
+            for (int& fd : fds) fd = -1;
+#ifdef __linux__
+            const uint64_t CONFIGS[COUNT] = {
+                PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+            };
+            for (int i = 0; i < COUNT; i++) {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = CONFIGS[i];
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+                if (fds[i] < 0) {
+                    Close();
+                    return;
+                }
+            }
+#endif
+        }
+
+        ~PerfCounters() { Close(); }
+
+        bool Available() const { return fds[0] >= 0; }
+
+        void Start() {
+#ifdef __linux__
+            if (!Available()) return;
+            for (int fd : fds) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        void Stop(uint64_t out[COUNT]) {
+            for (int i = 0; i < COUNT; i++) out[i] = 0;
+#ifdef __linux__
+            if (!Available()) return;
+            for (int i = 0; i < COUNT; i++) {
+                ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+                if (read(fds[i], &out[i], sizeof(out[i])) != (ssize_t)sizeof(out[i])) out[i] = 0;
+            }
+#endif
+        }
+
+    private:
+        int fds[COUNT];
+
+        void Close() {
+#ifdef __linux__
+            for (int& fd : fds) {
+                if (fd >= 0) close(fd);
+                fd = -1;
+            }
+#endif
+        }
+    };
+
+    const char* COUNTER_NAMES[PerfCounters::COUNT] = {"cycles", "instructions", "cache_misses"};
+
+    struct Result {
+        std::string op;
+        std::string game;
+        size_t bytes;
+        int iterations;
+        double p50, p99, mean;                      // Microseconds
+        double counters[PerfCounters::COUNT];       // Mean per call
+    };
+
+    uint32_t rng;
+
+    uint32_t Next() {
+        rng = rng * 1664525u + 1013904223u;
+        return rng >> 8;
+    }
+
+    // Middle of the size class game_detect.cpp assigns to each game
+    size_t SizeClass(GameType type) {
+        switch (type) {
+            case GameType::RAC1_VITA: return 750000;
+            case GameType::RAC2_VITA: return 1000000;
+            default: return 1300000;
+        }
+    }
+
+    std::vector<uint8_t> MakeSave(GameType type) {
+        rng = 0x5EED + (uint32_t)type;
+        std::vector<uint8_t> bytes(SizeClass(type));
+        for (uint8_t& byte : bytes) byte = (Next() % 3 == 0) ? (uint8_t)Next() : 0;
+
+        GameData game(type);
+        auto putInt = [&](uint32_t offset, int32_t minValue, int32_t maxValue) {
+            if (offset == 0 || offset + 4 > bytes.size()) return;
+            int32_t value = minValue + (int32_t)(Next() % (uint32_t)(maxValue - minValue + 1));
+            std::memcpy(&bytes[offset], &value, 4);
+        };
+        for (const GameValue& value : game.values) putInt(value.offset, value.min_value, value.max_value);
+        for (const GameValue& value : game.extra_values) putInt(value.offset, value.min_value, value.max_value);
+        for (const GameWeapon& weapon : game.weapons) putInt(weapon.ammo_offset, weapon.min_ammo, weapon.max_ammo);
+        for (const GameGadget& gadget : game.gadgets) bytes[gadget.offset] = Next() % 2;
+        for (const GameUnlockable& unlockable : game.unlockables) bytes[unlockable.offset] = Next() % 2;
+        return bytes;
+    }
+
+    bool WriteFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return (bool)file;
+    }
+
+    double Percentile(std::vector<double>& sorted, double fraction) {
+        size_t index = (size_t)(fraction * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    // Times body() once per iteration after a few untimed warm-up calls
+    template <typename Body>
+    Result Measure(const char* op, GameType type, size_t bytes, int iterations, PerfCounters& perf, Body body) {
+        const int WARMUP = 3;
+        for (int i = 0; i < WARMUP; i++) body(i);
+
+        std::vector<double> micros(iterations);
+        double totals[PerfCounters::COUNT] = {};
+        for (int i = 0; i < iterations; i++) {
+            uint64_t counts[PerfCounters::COUNT];
+            auto start = std::chrono::steady_clock::now();
+            perf.Start();
+            body(i);
+            perf.Stop(counts);
+            micros[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            for (int c = 0; c < PerfCounters::COUNT; c++) totals[c] += (double)counts[c];
+        }
+
+        Result result;
+        result.op = op;
+        result.game = GetGameName(type);
+        result.bytes = bytes;
+        result.iterations = iterations;
+        double sum = 0.0;
+        for (double value : micros) sum += value;
+        result.mean = sum / iterations;
+        std::sort(micros.begin(), micros.end());
+        result.p50 = Percentile(micros, 0.50);
+        result.p99 = Percentile(micros, 0.99);
+        for (int c = 0; c < PerfCounters::COUNT; c++) result.counters[c] = totals[c] / iterations;
+        return result;
+    }
+
+    void PrintResult(const Result& result, bool counters) {
+        printf("%-14s %-26s %8zu %10.2f %10.2f", result.op.c_str(), result.game.c_str(), result.bytes,
+               result.p50, result.p99);
+        if (counters) {
+            printf(" %12.0f %12.0f %10.0f", result.counters[0], result.counters[1], result.counters[2]);
+        }
+        printf("\n");
+    }
+
+    bool WriteJson(const std::string& path, const std::vector<Result>& results, bool counters) {
+        FILE* file = fopen(path.c_str(), "w");
+        if (!file) return false;
+
+        fprintf(file, "{\n  \"benchmark\": \"core_bench\",\n  \"units\": \"microseconds\",\n");
+        fprintf(file, "  \"hardware_counters\": %s,\n  \"results\": [\n", counters ? "true" : "false");
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& result = results[i];
+            fprintf(file, "    {\"op\": \"%s\", \"game\": \"%s\", \"bytes\": %zu, \"iterations\": %d, "
+                          "\"p50\": %.3f, \"p99\": %.3f, \"mean\": %.3f",
+                    result.op.c_str(), result.game.c_str(), result.bytes, result.iterations,
+                    result.p50, result.p99, result.mean);
+            if (counters) {
+                for (int c = 0; c < PerfCounters::COUNT; c++) {
+                    fprintf(file, ", \"%s\": %.0f", COUNTER_NAMES[c], result.counters[c]);
+                }
+            }
+            fprintf(file, "}%s\n", i + 1 < results.size() ? "," : "");
+        }
+        fprintf(file, "  ]\n}\n");
+        return fclose(file) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    int iterations = 200;
+    std::string jsonPath;
+    std::string scratchDir = ".";
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (arg == "--dir" && i + 1 < argc) {
+            scratchDir = argv[++i];
+        } else {
+            printf("Usage: core_bench [--iterations <n>] [--json <file>] [--dir <scratch dir>]\n");
+            return arg == "-h" || arg == "--help" ? 0 : 2;
+        }
+    }
+
+    PerfCounters perf;
+    bool counters = perf.Available();
+    printf("%d iterations per operation; hardware counters %s\n\n", iterations,
+           counters ? "on" : "unavailable");
+    printf("%-14s %-26s %8s %10s %10s", "operation", "game", "bytes", "p50 us", "p99 us");
+    if (counters) printf(" %12s %12s %10s", "cycles", "instructions", "misses");
+    printf("\n");
+
+    std::vector<Result> results;
+    auto record = [&](const Result& result) {
+        PrintResult(result, counters);
+        results.push_back(result);
+    };
+
+    volatile int sink = 0;
+    for (int type = 1; type < GAME_TYPE_COUNT; type++) {
+        GameType game = (GameType)type;
+        std::vector<uint8_t> bytes = MakeSave(game);
+        std::string path = scratchDir + "/core_bench_" + std::to_string(type) + ".bin";
+        if (!WriteFile(path, bytes)) {
+            printf("Cannot write %s\n", path.c_str());
+            return 1;
+        }
+
+        SaveFile save;
+        size_t size = bytes.size();
+        record(Measure("load", game, size, iterations, perf, [&](int) {
+            sink = save.Load(path);
+        }));
+        record(Measure("checksum", game, size, iterations, perf, [&](int) {
+            sink = (int)save.CalculateChecksum();
+        }));
+        record(Measure("detect", game, size, iterations, perf, [&](int) {
+            sink = (int)DetectGameType(save.GetView());
+        }));
+        record(Measure("game_data", game, size, iterations, perf, [&](int) {
+            GameData data(game);
+            sink = (int)data.values.size();
+        }));
+
+        // One changed value per save, as when a single field is edited
+        GameData data(game);
+        uint32_t offset = data.values.size() > 0 && data.values[0].offset != 0 ? data.values[0].offset : 64;
+        record(Measure("save", game, size, iterations, perf, [&](int i) {
+            save.WriteInt32(offset, i);
+            sink = save.Save();
+        }));
+        record(Measure("load_edit_save", game, size, iterations, perf, [&](int i) {
+            SaveFile cycle;
+            cycle.Load(path);
+            cycle.WriteInt32(offset, i + 1);
+            sink = cycle.Save();
+        }));
+
+        std::remove(path.c_str());
+    }
+
+    if (!jsonPath.empty()) {
+        if (!WriteJson(jsonPath, results, counters)) {
+            printf("Cannot write %s\n", jsonPath.c_str());
+            return 1;
+        }
+        printf("\nWrote %s\n", jsonPath.c_str());
+    }
+    return 0;
+}
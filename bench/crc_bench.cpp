@@ -0,0 +1,59 @@
+// crc_bench.cpp - MB/s per CRC-32 kernel at each game's save size class
+#include "../src/core/crc32.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+static std::vector<uint8_t> MakeBuffer(size_t size, uint32_t seed) {
+    std::vector<uint8_t> buf(size);
+    uint32_t x = seed;
+    for (size_t i = 0; i < size; i++) {
+        x = x * 1664525u + 1013904223u;
+        buf[i] = (uint8_t)(x >> 24);
+    }
+    return buf;
+}
+
+int main() {
+    struct SizeClass { const char* label; size_t bytes; };
+    const SizeClass sizes[] = {
+        {"RC1 (700 KB)", 700 * 1024},
+        {"RC2 (900 KB)", 900 * 1024},
+        {"RC3 (2 MB)", 2 * 1024 * 1024},
+    };
+
+    printf("Active kernel: %s\n\n", Crc32::KernelName(Crc32::ActiveKernel()));
+    printf("%-14s %-12s %10s %12s\n", "size", "kernel", "MB/s", "crc");
+
+    int failures = 0;
+    for (const SizeClass& size : sizes) {
+        std::vector<uint8_t> buf = MakeBuffer(size.bytes, 0x5A17u);
+        uint32_t reference = Crc32::Update(Crc32::Kernel::ZLIB, 0, buf.data(), buf.size());
+
+        for (int k = (int)Crc32::Kernel::BITWISE; k < (int)Crc32::Kernel::COUNT; k++) {
+            Crc32::Kernel kernel = (Crc32::Kernel)k;
+            if (!Crc32::IsSupported(kernel)) continue;
+
+            // Aim for ~64 MB of work per kernel, less for the slow baseline
+            int iterations = (int)((64u << 20) / buf.size());
+            if (kernel == Crc32::Kernel::BITWISE) iterations = 2;
+
+            uint32_t crc = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++) {
+                crc = Crc32::Update(kernel, 0, buf.data(), buf.size());
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            double seconds = std::chrono::duration<double>(end - start).count();
+            double mbps = (double)buf.size() * iterations / (1024.0 * 1024.0) / seconds;
+            bool ok = (crc == reference);
+            if (!ok) failures++;
+
+            printf("%-14s %-12s %10.1f   0x%08X%s\n", size.label, Crc32::KernelName(kernel),
+                   mbps, crc, ok ? "" : "  MISMATCH");
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
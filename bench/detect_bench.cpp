@@ -0,0 +1,168 @@
+// detect_bench.cpp - Game detection accuracy and throughput
+//
+// Without arguments a synthetic corpus is generated from the game tables:
+// table fields get plausible values, everything else is noise, and sizes
+// are drawn from each game's range with extra samples near the range
+// boundaries and outside them. Passing a directory with rac1/, rac2/,
+// rac3/ and unknown/ subdirectories measures real saves instead.
+#include "../src/core/game_detect.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+struct Sample {
+    std::vector<uint8_t> bytes;
+    GameType expected;
+    bool nearBoundary;
+};
+
+static uint32_t rng = 0x5EED;
+
+static uint32_t Next() {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+}
+
+static GameType SizeOnly(size_t fileSize) {
+    // The detection this replaced, kept for comparison
+    if (fileSize >= 650000 && fileSize <= 850000) return GameType::RAC1_VITA;
+    if (fileSize >= 850000 && fileSize <= 1150000) return GameType::RAC2_VITA;
+    if (fileSize >= 1150000) return GameType::RAC3_VITA;
+    return GameType::UNKNOWN;
+}
+
+static Sample MakeSample(GameType type) {
+    static const size_t RANGES[][2] = {{0, 0}, {650000, 850000}, {850000, 1150000}, {1150000, 2000000}};
+    Sample sample;
+    sample.expected = type;
+    sample.nearBoundary = false;
+
+    size_t size;
+    uint32_t mode = Next() % 10;
+    if (type == GameType::UNKNOWN) {
+        size = 10000 + Next() % 2000000;
+    } else if (mode < 3) {
+        // Within 10 KB of either edge of the range
+        size_t edge = RANGES[(int)type][Next() % 2];
+        size = edge - 10000 + Next() % 20000;
+        sample.nearBoundary = true;
+    } else if (mode < 4) {
+        // Another version of the game with a different save size
+        size = RANGES[(int)type][0] * (85 + Next() % 30) / 100;
+        sample.nearBoundary = true;
+    } else {
+        size = RANGES[(int)type][0] + Next() % (RANGES[(int)type][1] - RANGES[(int)type][0]);
+    }
+
+    // Only the header area matters to detection; the rest stays zero
+    sample.bytes.assign(size, 0);
+    size_t noisy = std::min<size_t>(size, 8192);
+    for (size_t i = 0; i < noisy; i++) {
+        if (Next() % 3 == 0) sample.bytes[i] = (uint8_t)Next();
+    }
+    if (type == GameType::UNKNOWN) return sample;
+
+    // Fields a played save of this game would hold; some never touched
+    GameData game(type);
+    auto putInt = [&](uint32_t offset, int32_t minValue, int32_t maxValue) {
+        if (offset == 0 || offset + 4 > size) return;
+        int32_t value = (Next() % 4 == 0) ? 0 : minValue + (int32_t)(Next() % (uint32_t)(maxValue - minValue + 1));
+        std::memcpy(&sample.bytes[offset], &value, 4);
+    };
+    for (const GameValue& value : game.values) putInt(value.offset, value.min_value, value.max_value);
+    for (const GameValue& value : game.extra_values) putInt(value.offset, value.min_value, value.max_value);
+    for (const GameWeapon& weapon : game.weapons) putInt(weapon.ammo_offset, weapon.min_ammo, weapon.max_ammo);
+    for (const GameGadget& gadget : game.gadgets) sample.bytes[gadget.offset] = Next() % 2;
+    for (const GameUnlockable& unlockable : game.unlockables) sample.bytes[unlockable.offset] = Next() % 2;
+    return sample;
+}
+
+static void LoadCorpus(const std::string& root, std::vector<Sample>& corpus) {
+    const char* DIRS[] = {"unknown", "rac1", "rac2", "rac3"};
+    for (int type = 0; type < GAME_TYPE_COUNT; type++) {
+        std::string dirPath = root + "/" + DIRS[type];
+        DIR* dir = opendir(dirPath.c_str());
+        if (!dir) continue;
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] == '.') continue;
+            std::ifstream file(dirPath + "/" + entry->d_name, std::ios::binary);
+            Sample sample;
+            sample.bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            sample.expected = (GameType)type;
+            sample.nearBoundary = false;
+            corpus.push_back(std::move(sample));
+        }
+        closedir(dir);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<Sample> corpus;
+    bool synthetic = argc < 2;
+    if (synthetic) {
+        for (int i = 0; i < 400; i++) {
+            corpus.push_back(MakeSample((GameType)(i % GAME_TYPE_COUNT)));
+        }
+    } else {
+        LoadCorpus(argv[1], corpus);
+        if (corpus.empty()) {
+            printf("No saves found under %s\n", argv[1]);
+            return 1;
+        }
+    }
+
+    int correct = 0, sizeCorrect = 0, boundary = 0, boundaryCorrect = 0, boundarySizeCorrect = 0;
+    float confidenceRight = 0, confidenceWrong = 0;
+    for (const Sample& sample : corpus) {
+        DetectionResult result = GameDetect::Detect(ByteView(sample.bytes.data(), sample.bytes.size()));
+        bool ok = result.type == sample.expected;
+        bool sizeOk = SizeOnly(sample.bytes.size()) == sample.expected;
+        correct += ok;
+        sizeCorrect += sizeOk;
+        (ok ? confidenceRight : confidenceWrong) += result.confidence;
+        if (sample.nearBoundary) {
+            boundary++;
+            boundaryCorrect += ok;
+            boundarySizeCorrect += sizeOk;
+        }
+    }
+
+    int wrong = (int)corpus.size() - correct;
+    printf("%s corpus: %zu saves\n", synthetic ? "Synthetic" : "Real", corpus.size());
+    printf("  signature detection: %5.1f%% correct (mean confidence %.2f right, %.2f wrong)\n",
+           100.0 * correct / corpus.size(), correct ? confidenceRight / correct : 0.0f,
+           wrong ? confidenceWrong / wrong : 0.0f);
+    printf("  size-only detection: %5.1f%% correct\n", 100.0 * sizeCorrect / corpus.size());
+    if (boundary > 0) {
+        printf("  near/outside size ranges (%d saves): %.1f%% vs %.1f%% size-only\n", boundary,
+               100.0 * boundaryCorrect / boundary, 100.0 * boundarySizeCorrect / boundary);
+    }
+    for (int type = 1; type < GAME_TYPE_COUNT; type++) {
+        printf("  cache lines read for %s: %zu\n", GetGameName((GameType)type),
+               GameDetect::CacheLinesTouched((GameType)type));
+    }
+
+    // Throughput over the in-memory corpus
+    const int ROUNDS = 200;
+    int sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (const Sample& sample : corpus) {
+            sink += (int)GameDetect::Detect(ByteView(sample.bytes.data(), sample.bytes.size())).type;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double perSecond = ROUNDS * corpus.size() / seconds;
+    printf("\nThroughput: %.0f detections/s (%.0f ns each)%s\n", perSecond, 1e9 / perSecond,
+           sink == -1 ? " " : "");
+
+    // The synthetic corpus is built from the same tables, so anything short
+    // of near-perfect there is a regression
+    return (synthetic && correct * 100 < (int)corpus.size() * 98) ? 1 : 0;
+}
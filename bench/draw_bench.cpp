@@ -0,0 +1,254 @@
+// draw_bench.cpp - Draw list replay cost per screen on the software backend
+//
+//   draw_bench [drawlist_NNN.bin ...]
+//
+// Replays draw lists captured on the Vita (two-finger tap on the rear
+// touchpad writes ux0:/data/slimseditor/drawlist_NNN.bin) or, with no
+// arguments, lists recorded here in the shape of the app's screens. Each is
+// submitted batched and immediate (one call per command, as drawing
+// straight to SDL did) into a 960x544 software target; the draw calls,
+// state changes and CPU time per frame are reported, and both modes must
+// produce the same pixels.
+#include "../src/ui/draw_list.h"
+#include "../src/ui/soft_draw_backend.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static const DrawColor BACKGROUND = {20, 20, 30, 255};
+static const DrawColor PANEL = {26, 31, 46, 255};
+static const DrawColor PANEL_DARK = {15, 20, 30, 255};
+static const DrawColor ACCENT = {78, 204, 163, 255};
+static const DrawColor TEXT = {255, 255, 255, 255};
+static const DrawColor TEXT_DIM = {138, 155, 168, 255};
+static const DrawColor SELECTED = {15, 52, 96, 255};
+static const DrawColor BORDER = {45, 55, 72, 255};
+
+struct Screen {
+    std::string name;
+    DrawList list;
+};
+
+template <typename F>
+static double MedianMicros(int runs, F&& body) {
+    std::vector<double> micros;
+    for (int run = 0; run < runs; run++) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(micros.begin(), micros.end());
+    return micros[micros.size() / 2];
+}
+
+// A layer as RetainedFrame records it: clip, clear, contents, unclip
+template <typename F>
+static void Layer(DrawList& list, DrawRect area, F&& contents) {
+    list.Clip(area);
+    list.Fill(area, BACKGROUND);
+    contents();
+    list.NoClip();
+}
+
+static void Header(DrawList& list) {
+    Layer(list, DrawRect{0, 0, 960, 80}, [&] {
+        list.Fill(DrawRect{0, 0, 960, 80}, PANEL);
+        list.Fill(DrawRect{0, 78, 960, 2}, ACCENT);
+        list.Fill(DrawRect{15, 15, 50, 50}, ACCENT);
+        list.Outline(DrawRect{15, 15, 50, 50}, ACCENT);
+        list.Text("Ratchet & Clank 2 HD", 75, 15, TEXT);
+        list.Text("UNSAVED CHANGES", 75, 45, DrawColor{255, 193, 7, 255});
+        list.Fill(DrawRect{720, 20, 100, 40}, ACCENT);
+        list.Outline(DrawRect{720, 20, 100, 40}, BORDER);
+        list.TextCentered("SAVE", 770, 29, TEXT);
+        list.Fill(DrawRect{830, 20, 100, 40}, DrawColor{244, 67, 54, 255});
+        list.Outline(DrawRect{830, 20, 100, 40}, BORDER);
+        list.TextCentered("BACK", 880, 29, TEXT);
+    });
+    Layer(list, DrawRect{0, 80, 960, 40}, [&] {
+        const char* tabs[] = {"Values", "Weapons", "Gadgets", "Unlocks", "Hex"};
+        for (int i = 0; i < 5; i++) {
+            list.Fill(DrawRect{i * 192, 80, 192, 40}, i == 0 ? SELECTED : PANEL_DARK);
+            if (i == 0) list.Fill(DrawRect{0, 117, 192, 3}, ACCENT);
+            list.Outline(DrawRect{i * 192, 80, 192, 40}, BORDER);
+            list.TextCentered(tabs[i], i * 192 + 96, 89, i == 0 ? ACCENT : TEXT);
+        }
+    });
+}
+
+static void Footer(DrawList& list, const char* text) {
+    Layer(list, DrawRect{0, 500, 960, 44}, [&] {
+        list.Fill(DrawRect{0, 500, 960, 44}, PANEL_DARK);
+        list.TextCentered(text, 480, 510, TEXT_DIM);
+    });
+}
+
+static void FileBrowser(DrawList& list) {
+    Layer(list, DrawRect{0, 0, 960, 120}, [&] {
+        list.Fill(DrawRect{0, 0, 960, 80}, PANEL);
+        list.Text("FILE BROWSER", 20, 15, ACCENT);
+        list.Text("ux0:/data/slimseditor/saves", 20, 50, TEXT_DIM);
+        list.Fill(DrawRect{0, 80, 960, 40}, SELECTED);
+        list.Text("D-Pad: Navigate | X: Select | O: Parent | []: Refresh", 20, 90, TEXT);
+    });
+    Layer(list, DrawRect{0, 120, 960, 380}, [&] {
+        char name[64];
+        for (int i = 0; i < 6; i++) {
+            int y = 140 + i * 60;
+            list.Fill(DrawRect{10, y - 5, 940, 55}, i == 1 ? SELECTED : PANEL);
+            snprintf(name, sizeof(name), "%sPCSA0000%d", i < 2 ? "[DIR] " : "", i);
+            list.Text(name, 25, y + 5, i == 1 ? ACCENT : TEXT);
+            if (i >= 2) list.TextRight("812.4 KB", 920, y + 5, TEXT_DIM);
+        }
+    });
+    Layer(list, DrawRect{0, 500, 960, 44}, [&] {
+        list.Fill(DrawRect{0, 500, 960, 44}, PANEL_DARK);
+        list.Text("14 items | Selected: 2/14", 20, 510, TEXT_DIM);
+    });
+}
+
+static void ValuesRows(DrawList& list) {
+    char value[16];
+    for (int i = 0; i < 6; i++) {
+        int y = 140 + i * 60;
+        bool selected = i == 2;
+        list.Fill(DrawRect{15, y - 5, 930, 55}, selected ? DrawColor{25, 72, 126, 255} : PANEL);
+        if (selected) list.Fill(DrawRect{15, y - 5, 5, 55}, ACCENT);
+        list.Outline(DrawRect{15, y - 5, 930, 55}, selected ? ACCENT : BORDER);
+        list.Text("Bolts", 30, y + 5, selected ? ACCENT : TEXT);
+        snprintf(value, sizeof(value), "%d", 150000 + i * 1234);
+        list.TextRight(value, 920, y + 5, DrawColor{98, 224, 183, 255});
+        list.Text("Current bolt count", 30, y + 30, TEXT_DIM);
+    }
+}
+
+static void SaveEditorValues(DrawList& list, bool editing) {
+    Header(list);
+    Layer(list, DrawRect{0, 120, 960, 380}, [&] {
+        ValuesRows(list);
+        if (editing) list.Blend(DrawRect{0, 0, 960, 544}, DrawColor{0, 0, 0, 200});
+    });
+    if (editing) {
+        Layer(list, DrawRect{98, 118, 764, 304}, [&] {
+            list.Fill(DrawRect{100, 120, 760, 300}, PANEL);
+            for (int i = 0; i < 3; i++) list.Outline(DrawRect{100 - i, 120 - i, 760 + i * 2, 300 + i * 2}, ACCENT);
+            list.TextCentered("EDIT VALUE", 480, 145, ACCENT);
+            list.TextCentered("152468", 480, 200, DrawColor{98, 224, 183, 255});
+            list.TextCentered("Step: +/-100", 480, 245, TEXT_DIM);
+            list.TextCentered("Range: 0 - 4294967", 480, 280, TEXT_DIM);
+            list.TextCentered("UP/DOWN: Adjust | LEFT: Min | RIGHT: Max", 480, 335, TEXT);
+            list.TextCentered("L/R: Change Step | X: Save | O: Cancel", 480, 365, TEXT);
+        });
+    }
+    Footer(list, "X: Edit/Toggle | O: Back | START: Save | L/R: Tabs | TRI/SQR: Undo/Redo");
+}
+
+static void SaveEditorHex(DrawList& list) {
+    Header(list);
+    Layer(list, DrawRect{0, 120, 960, 380}, [&] {
+        // A few known fields highlighted, then every cell, cursor, scrollbar
+        for (int r = 0; r < 14; r += 3) {
+            int y = 130 + r * 24;
+            list.Fill(DrawRect{118, y, 4 * 30 - 4, 22}, DrawColor{60, 40, 90, 255});
+            list.Fill(DrawRect{635, y, 4 * 14, 22}, DrawColor{60, 40, 90, 255});
+        }
+        char cell[8];
+        for (int r = 0; r < 14; r++) {
+            int y = 130 + r * 24;
+            snprintf(cell, sizeof(cell), "%06X", 0x1A40 + r * 16);
+            list.Text(cell, 25, y, TEXT_DIM);
+            for (int c = 0; c < 16; c++) {
+                uint8_t byte = (uint8_t)(r * 37 + c * 11);
+                snprintf(cell, sizeof(cell), "%02X", byte);
+                list.Text(cell, 120 + c * 30 + (c >= 8 ? 8 : 0), y, byte ? TEXT : TEXT_DIM);
+            }
+            for (int c = 0; c < 16; c++) {
+                char ascii[2] = {(char)('!' + (r * 16 + c) % 90), 0};
+                list.Text(ascii, 635 + c * 14, y, TEXT_DIM);
+            }
+        }
+        list.Outline(DrawRect{178, 178, 28, 22}, ACCENT);
+        list.Outline(DrawRect{663, 178, 14, 22}, ACCENT);
+        list.Fill(DrawRect{920, 130, 20, 336}, PANEL_DARK);
+        list.Fill(DrawRect{920, 160, 20, 24}, SELECTED);
+        list.Text("0x001A62  = 0x4C (76)  int32 19020", 25, 472, TEXT_DIM);
+    });
+    Footer(list, "X: Edit Byte | SELECT: Go To | O: Back | START: Save | L/R: Tabs | TRI/SQR: Undo/Redo");
+}
+
+static bool ReadFile(const char* path, std::vector<uint8_t>& out) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    uint8_t buffer[65536];
+    size_t got;
+    out.clear();
+    while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        out.insert(out.end(), buffer, buffer + got);
+    }
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::vector<Screen> screens;
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            std::vector<uint8_t> bytes;
+            Screen screen;
+            if (!ReadFile(argv[i], bytes) || !screen.list.Deserialize(bytes.data(), bytes.size(), screen.name)) {
+                printf("%s: not a draw list\n", argv[i]);
+                return 1;
+            }
+            screens.push_back(std::move(screen));
+        }
+    } else {
+        screens.resize(4);
+        screens[0].name = "file_browser";
+        FileBrowser(screens[0].list);
+        screens[1].name = "save_editor_values";
+        SaveEditorValues(screens[1].list, false);
+        screens[2].name = "save_editor_values_editing";
+        SaveEditorValues(screens[2].list, true);
+        screens[3].name = "save_editor_hex";
+        SaveEditorHex(screens[3].list);
+    }
+
+    const int RUNS = 101;
+    bool ok = true;
+    printf("%-28s %5s | %11s | %11s | %5s %5s | %17s\n", "screen", "cmds", "draw calls", "state chg",
+           "rects", "text", "us/frame");
+    printf("%-28s %5s | %5s %5s | %5s %5s | %5s %5s | %8s %8s\n", "", "", "batch", "immed", "batch", "immed",
+           "", "", "batch", "immed");
+
+    for (Screen& screen : screens) {
+        // The serialised form must round-trip exactly
+        std::vector<uint8_t> bytes, again;
+        screen.list.Serialize(screen.name, bytes);
+        DrawList copy;
+        std::string name;
+        bool roundTrip = copy.Deserialize(bytes.data(), bytes.size(), name) && name == screen.name;
+        copy.Serialize(name, again);
+        roundTrip = roundTrip && again == bytes;
+
+        SoftDrawBackend batched(960, 544), immediate(960, 544);
+        DrawStats batchStats, immediateStats;
+        double batchUs = MedianMicros(RUNS, [&] {
+            batched.Clear(BACKGROUND);
+            batchStats = screen.list.Submit(batched, DrawList::SubmitMode::BATCHED);
+        });
+        double immediateUs = MedianMicros(RUNS, [&] {
+            immediate.Clear(BACKGROUND);
+            immediateStats = screen.list.Submit(immediate, DrawList::SubmitMode::IMMEDIATE);
+        });
+        bool samePixels = batched.Checksum() == immediate.Checksum();
+
+        printf("%-28s %5zu | %5zu %5zu | %5zu %5zu | %5zu %5zu | %8.1f %8.1f%s%s\n", screen.name.c_str(),
+               screen.list.GetCommandCount(), batchStats.drawCalls, immediateStats.drawCalls,
+               batchStats.stateChanges, immediateStats.stateChanges, batchStats.rects, batchStats.textRuns,
+               batchUs, immediateUs, samePixels ? "" : "  PIXELS DIFFER", roundTrip ? "" : "  ROUND TRIP FAILED");
+        ok = ok && samePixels && roundTrip;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,306 @@
+// offset_db_bench.cpp - Offset database compile, load and lookup cost
+//
+//   offset_db_bench [fields per category]
+//
+// Builds database JSON for all three games with a few thousand fields each
+// (a community table grown well past the built-in ones), compiles it, then
+// times loading the binary and fetching GameData. The round trip of the
+// built-in tables through export, compile and load is checked field by field.
+#include "../src/core/crc32.h"
+#include "../src/core/field_presets.h"
+#include "../src/core/offset_db.h"
+#include "../src/core/save_file.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+template <typename F>
+static double MedianMicros(int runs, F&& body) {
+    std::vector<double> micros;
+    for (int run = 0; run < runs; run++) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(micros.begin(), micros.end());
+    return micros[micros.size() / 2];
+}
+
+static std::string MakeJson(int perCategory) {
+    static const char* GAMES[] = {"rac1", "rac2", "rac3"};
+    std::string json = "{\"games\": [";
+    char line[256];
+    for (int g = 0; g < 3; g++) {
+        json += std::string(g ? ",\n{" : "\n{") + "\"game\": \"" + GAMES[g] + "\"";
+        for (const char* key : {"values", "weapons", "extra_values"}) {
+            json += std::string(", \"") + key + "\": [";
+            for (int i = 0; i < perCategory; i++) {
+                snprintf(line, sizeof(line), "%s\n{\"name\": \"%s %d\", \"description\": \"Field %d of %s\", "
+                         "\"offset\": \"0x%X\", \"min\": 0, \"max\": %d, \"size\": 4}",
+                         i ? "," : "", key, i, i, key, 0x1000 + i * 4, 1000 + i);
+                json += line;
+            }
+            json += "]";
+        }
+        for (const char* key : {"gadgets", "unlockables"}) {
+            json += std::string(", \"") + key + "\": [";
+            for (int i = 0; i < perCategory; i++) {
+                snprintf(line, sizeof(line), "%s\n{\"name\": \"%s %d\", \"description\": \"Flag %d\", "
+                         "\"offset\": %d, \"bit\": %d}", i ? "," : "", key, i, i, 0x8000 + i / 8, i % 8);
+                json += line;
+            }
+            json += "]";
+        }
+        json += "}";
+    }
+    return json + "\n]}\n";
+}
+
+template <typename T, typename Same>
+static bool SameTable(const TableView<T>& a, const TableView<T>& b, Same same) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (strcmp(a[i].name, b[i].name) != 0 || strcmp(a[i].description, b[i].description) != 0) return false;
+        if (!same(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+static bool RoundTripBuiltIn() {
+    std::vector<uint8_t> compiled;
+    std::string error;
+    OffsetDatabase db;
+    if (!OffsetDatabase::Compile(OffsetDatabase::ExportBuiltIn(), compiled, error) || !db.LoadFromMemory(compiled)) {
+        printf("  built-in round trip failed: %s%s\n", error.c_str(), db.GetError().c_str());
+        return false;
+    }
+
+    auto sameValue = [](const GameValue& a, const GameValue& b) {
+        return a.offset == b.offset && a.min_value == b.min_value && a.max_value == b.max_value && a.byte_size == b.byte_size;
+    };
+    auto sameWeapon = [](const GameWeapon& a, const GameWeapon& b) {
+        return a.ammo_offset == b.ammo_offset && a.min_ammo == b.min_ammo && a.max_ammo == b.max_ammo && a.byte_size == b.byte_size;
+    };
+    auto sameFlag = [](const auto& a, const auto& b) { return a.offset == b.offset && a.bit_index == b.bit_index; };
+
+    for (int t = 1; t < 4; t++) {
+        GameData builtIn((GameType)t), loaded;
+        if (!db.GetGame((GameType)t, loaded) || strcmp(builtIn.name, loaded.name) != 0 ||
+            !SameTable(builtIn.values, loaded.values, sameValue) ||
+            !SameTable(builtIn.weapons, loaded.weapons, sameWeapon) ||
+            !SameTable(builtIn.extra_values, loaded.extra_values, sameValue) ||
+            !SameTable(builtIn.gadgets, loaded.gadgets, sameFlag) ||
+            !SameTable(builtIn.unlockables, loaded.unlockables, sameFlag)) {
+            printf("  built-in round trip differs for %s\n", builtIn.name);
+            return false;
+        }
+    }
+    return true;
+}
+
+// One rac1 value named Narrow with the given offset, limits and size
+static std::string RangeJson(const std::string& numbers) {
+    return "{\"games\": [{\"game\": \"rac1\", \"values\": [{\"name\": \"Narrow\", \"description\": \"\", " +
+           numbers + "}]}]}";
+}
+
+static std::string NarrowJson(int size) {
+    return RangeJson("\"offset\": 16, \"min\": 0, \"max\": 255, \"size\": " + std::to_string(size));
+}
+
+// Recomputes the CRC after a record has been patched by hand
+static void Reseal(std::vector<uint8_t>& db) {
+    uint32_t crc = Crc32::Update(0, &db[28], db.size() - 28);
+    memcpy(&db[24], &crc, 4);
+}
+
+// Every reader and writer of a range field uses 32 bits, so a narrower
+// field would overwrite the bytes after it. Sizes other than 4 must be
+// refused by both Compile and Load; a 4-byte field must leave the byte
+// after it alone.
+static bool NarrowFieldsRejected() {
+    std::vector<uint8_t> compiled;
+    std::string error;
+    if (OffsetDatabase::Compile(NarrowJson(1), compiled, error)) {
+        printf("  size-1 field compiled\n");
+        return false;
+    }
+    if (!OffsetDatabase::Compile(NarrowJson(4), compiled, error)) {
+        printf("  size-4 field failed to compile: %s\n", error.c_str());
+        return false;
+    }
+
+    // One game, so the lone range record follows the header and game table
+    std::vector<uint8_t> patched = compiled;
+    const size_t SIZE_AT = 28 + 8 + 8 * (int)OffsetCategory::COUNT + 20;
+    patched[SIZE_AT] = 1;
+    Reseal(patched);
+    OffsetDatabase db;
+    if (db.LoadFromMemory(patched)) {
+        printf("  size-1 field loaded\n");
+        return false;
+    }
+
+    // Field at 16..19, sentinel at 20
+    const char* path = "offset_db_bench.bin";
+    std::vector<uint8_t> bytes(64, 0);
+    bytes[20] = 0xA5;
+    FILE* file = fopen(path, "wb");
+    bool written = file && fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    if (file) fclose(file);
+
+    SaveFile save;
+    GameData game;
+    bool ok = written && db.LoadFromMemory(compiled) && db.GetGame(GameType::RAC1_VITA, game) && save.Load(path) &&
+              FieldPresets::SetField("Narrow=200", save, game) == 1 &&
+              save.ReadInt32(16) == 200 && save.ReadByte(20) == 0xA5;
+    remove(path);
+    if (!ok) printf("  size-4 field write touched its neighbour\n");
+    return ok;
+}
+
+// The header sits outside the CRC, so bad counts there must be caught by
+// the bounds checks, without throwing and without 32-bit wraparound
+static bool CorruptHeaderRejected(const std::vector<uint8_t>& compiled) {
+    struct Case {
+        const char* what;
+        size_t at;
+        uint32_t value;
+    };
+    // 0x05555556 games of 48 bytes is 0x100000020 bytes: 0x20 once wrapped
+    static const Case CASES[] = {
+        {"game count 0xFFFFFFFF", 8, 0xFFFFFFFFu},
+        {"game count wrapping 32 bits", 8, 0x05555556u},
+        {"record count 0xFFFFFFFF", 12, 0xFFFFFFFFu},
+        {"record count off by one", 12, 0},
+    };
+
+    bool ok = true;
+    for (const Case& c : CASES) {
+        std::vector<uint8_t> bytes = compiled;
+        uint32_t value = c.value;
+        if (c.at == 12 && value == 0) {
+            memcpy(&value, &bytes[12], 4);
+            value++;
+        }
+        memcpy(&bytes[c.at], &value, 4);
+
+        OffsetDatabase db;
+        bool loaded;
+        try {
+            loaded = db.LoadFromMemory(bytes);
+        } catch (...) {
+            printf("  %s: threw\n", c.what);
+            ok = false;
+            continue;
+        }
+        if (loaded) {
+            printf("  %s: loaded\n", c.what);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Compile only writes bits 0..7; a loaded flag must obey the same rule
+static bool BadFlagBitRejected() {
+    std::vector<uint8_t> compiled;
+    std::string error;
+    const char* json = "{\"games\": [{\"game\": \"rac1\", \"gadgets\": [{\"name\": \"Flag\", \"description\": \"\", "
+                       "\"offset\": 16, \"bit\": 7}]}]}";
+    OffsetDatabase db;
+    if (!OffsetDatabase::Compile(json, compiled, error) || !db.LoadFromMemory(compiled)) {
+        printf("  bit 7 flag failed: %s%s\n", error.c_str(), db.GetError().c_str());
+        return false;
+    }
+
+    // The lone flag record follows the header and game table
+    const size_t BIT_AT = 28 + 8 + 8 * (int)OffsetCategory::COUNT + 12;
+    compiled[BIT_AT] = 8;
+    Reseal(compiled);
+    if (db.LoadFromMemory(compiled)) {
+        printf("  bit 8 flag loaded\n");
+        return false;
+    }
+    return true;
+}
+
+// Numbers int64_t can't hold exactly must fail to compile, not be cast,
+// and so must limits an int32 can't hold
+static bool BadNumbersRejected() {
+    static const char* OFFSETS[] = {"1e30", "-1e30", "nan", "inf", "-inf", "16.5", "\"0x10000000000000000\""};
+    // Limits outside int32 would wrap into other, valid-looking limits
+    static const char* LIMITS[] = {"\"min\": -2147483649, \"max\": 0", "\"min\": 0, \"max\": 2147483648",
+                                   "\"min\": 0, \"max\": 4294967295"};
+
+    bool ok = true;
+    for (const char* offset : OFFSETS) {
+        std::vector<uint8_t> compiled;
+        std::string error;
+        std::string json = RangeJson(std::string("\"offset\": ") + offset + ", \"min\": 0, \"max\": 255, \"size\": 4");
+        if (OffsetDatabase::Compile(json, compiled, error)) {
+            printf("  offset %s compiled\n", offset);
+            ok = false;
+        }
+    }
+    for (const char* limits : LIMITS) {
+        std::vector<uint8_t> compiled;
+        std::string error;
+        if (OffsetDatabase::Compile(RangeJson(std::string("\"offset\": 16, ") + limits + ", \"size\": 4"), compiled, error)) {
+            printf("  %s compiled\n", limits);
+            ok = false;
+        }
+    }
+    std::vector<uint8_t> compiled;
+    std::string error;
+    if (!OffsetDatabase::Compile(RangeJson("\"offset\": 16, \"min\": -2147483648, \"max\": 2147483647, \"size\": 4"),
+                                 compiled, error)) {
+        printf("  full int32 range failed to compile: %s\n", error.c_str());
+        ok = false;
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    int perCategory = argc > 1 ? std::atoi(argv[1]) : 2000;
+    std::string json = MakeJson(perCategory);
+
+    std::vector<uint8_t> compiled;
+    std::string error;
+    double compileUs = MedianMicros(5, [&] {
+        if (!OffsetDatabase::Compile(json, compiled, error)) printf("Compile failed: %s\n", error.c_str());
+    });
+
+    OffsetDatabase db;
+    double loadUs = MedianMicros(21, [&] { db.LoadFromMemory(compiled); });
+    bool ok = db.IsLoaded() && db.GetFieldCount() == (size_t)perCategory * 5 * 3;
+
+    GameData game;
+    size_t fields = 0;
+    const int LOOKUPS = 100000;
+    double lookupUs = MedianMicros(5, [&] {
+        for (int i = 0; i < LOOKUPS; i++) {
+            db.GetGame((GameType)(1 + i % 3), game);
+            fields += game.values.size();
+        }
+    });
+    ok = ok && fields > 0 && game.values[perCategory - 1].offset == 0x1000u + (perCategory - 1) * 4;
+
+    bool roundTrip = RoundTripBuiltIn();
+    bool narrow = NarrowFieldsRejected();
+    bool corrupt = CorruptHeaderRejected(compiled);
+    bool badNumbers = BadNumbersRejected();
+    bool badBit = BadFlagBitRejected();
+    printf("%zu fields: JSON %zu bytes, compiled %zu bytes\n", db.GetFieldCount(), json.size(), compiled.size());
+    printf("  compile %9.0f us\n", compileUs);
+    printf("  load    %9.0f us (%.1f ns per field)\n", loadUs, loadUs * 1000.0 / std::max<size_t>(1, db.GetFieldCount()));
+    printf("  GetGame %9.1f ns\n", lookupUs * 1000.0 / LOOKUPS);
+    printf("  contents: %s, built-in round trip: %s, narrow fields: %s, corrupt header: %s, bad numbers: %s, "
+           "bad flag bit: %s\n", ok ? "ok" : "WRONG", roundTrip ? "ok" : "WRONG", narrow ? "rejected" : "WRONG",
+           corrupt ? "rejected" : "WRONG", badNumbers ? "rejected" : "WRONG", badBit ? "rejected" : "WRONG");
+    return ok && roundTrip && narrow && corrupt && badNumbers && badBit ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+// parallel_crc_bench.cpp - Thread scaling of the parallel checksum path
+#include "../src/core/crc32.h"
+#include "../src/core/parallel.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+static std::vector<uint8_t> MakeBuffer(size_t size, uint32_t seed) {
+    std::vector<uint8_t> buf(size);
+    uint32_t x = seed;
+    for (size_t i = 0; i < size; i++) {
+        x = x * 1664525u + 1013904223u;
+        buf[i] = (uint8_t)(x >> 24);
+    }
+    return buf;
+}
+
+int main() {
+    struct SizeClass { const char* label; size_t bytes; };
+    const SizeClass sizes[] = {
+        {"2 MB", 2u << 20},
+        {"64 MB", 64u << 20},
+    };
+    const int threadCounts[] = {1, 2, 4, 8};
+
+    printf("Kernel: %s, default threads: %d\n\n",
+           Crc32::KernelName(Crc32::ActiveKernel()), Parallel::DefaultThreadCount());
+    printf("%-7s %8s %10s %9s %8s\n", "size", "threads", "MB/s", "ms", "speedup");
+
+    int failures = 0;
+    for (const SizeClass& size : sizes) {
+        std::vector<uint8_t> buf = MakeBuffer(size.bytes, 0x3C3Cu);
+        uint32_t reference = Crc32::Update(0, buf.data(), buf.size());
+        double baseline = 0;
+
+        for (int threads : threadCounts) {
+            int iterations = (int)((256u << 20) / buf.size());
+            if (iterations < 2) iterations = 2;
+
+            uint32_t crc = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++) {
+                crc = Crc32::UpdateParallel(0, buf.data(), buf.size(), threads);
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            double seconds = std::chrono::duration<double>(end - start).count() / iterations;
+            double mbps = (double)buf.size() / (1024.0 * 1024.0) / seconds;
+            if (threads == 1) baseline = seconds;
+            if (crc != reference) failures++;
+
+            printf("%-7s %8d %10.1f %9.3f %7.2fx%s\n", size.label, threads, mbps,
+                   seconds * 1000.0, baseline / seconds, crc == reference ? "" : "  MISMATCH");
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
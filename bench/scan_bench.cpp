@@ -0,0 +1,108 @@
+// scan_bench.cpp - Value scanner correctness and time per narrowing step
+//
+// A 2 MB save is "played" through a few steps: a handful of counters move
+// each step and the rest stays put. Every step is checked against a plain
+// per-offset loop, for each value width, starting both from a known value
+// and from every offset (the millions-of-candidates case).
+#include "../src/core/value_scanner.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static uint32_t rng = 0x5CA7;
+
+static uint32_t Next() {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+}
+
+static int32_t Read(const std::vector<uint8_t>& save, size_t offset, uint32_t width) {
+    if (width == 1) return (int8_t)save[offset];
+    if (width == 2) {
+        int16_t value;
+        std::memcpy(&value, &save[offset], 2);
+        return value;
+    }
+    int32_t value;
+    std::memcpy(&value, &save[offset], 4);
+    return value;
+}
+
+struct Step {
+    ScanPredicate predicate;
+    const char* label;
+};
+
+int main() {
+    const size_t SIZE = 2 * 1024 * 1024;
+    const uint32_t COUNTER = 0x1234;            // The value being hunted
+
+    // Mostly zero with some noise, like a save's unused slots
+    std::vector<std::vector<uint8_t>> saves(5, std::vector<uint8_t>(SIZE, 0));
+    for (size_t i = 0; i < SIZE; i++) {
+        if (Next() % 4 == 0) saves[0][i] = (uint8_t)Next();
+    }
+    int32_t counter = 1000;
+    std::memcpy(&saves[0][COUNTER], &counter, 4);
+    for (size_t s = 1; s < saves.size(); s++) {
+        saves[s] = saves[s - 1];
+        for (int edit = 0; edit < 64; edit++) saves[s][Next() % SIZE] = (uint8_t)Next();
+        counter += (s == 1) ? 0 : (s == 3) ? -5 : 25;
+        std::memcpy(&saves[s][COUNTER], &counter, 4);
+    }
+    const Step STEPS[] = {
+        {ScanPredicate::UNCHANGED, "unchanged"},
+        {ScanPredicate::INCREASED, "increased"},
+        {ScanPredicate::DECREASED, "decreased"},
+        {ScanPredicate::CHANGED, "changed"},
+    };
+
+    bool ok = true;
+    for (uint32_t width : {1u, 2u, 4u}) {
+        for (int known = 0; known < 2; known++) {
+            ValueScanner scanner;
+            ByteView first(saves[0].data(), SIZE);
+            int32_t start = width == 4 ? 1000 : (int32_t)saves[0][COUNTER];
+
+            auto begin = std::chrono::steady_clock::now();
+            size_t count = known ? scanner.First(first, width, start) : scanner.First(first, width);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+            std::vector<uint8_t> expected(SIZE - width + 1, 0);
+            for (size_t offset = 0; offset < expected.size(); offset++) {
+                expected[offset] = known ? Read(saves[0], offset, width) == (width == 1 ? (int8_t)start : start) : 1;
+            }
+            printf("int%-2u %-8s %9zu candidates %7.2f ms\n", width * 8, known ? "=value" : "any", count, ms);
+
+            for (size_t s = 1; s < saves.size(); s++) {
+                const Step& step = STEPS[s - 1];
+                begin = std::chrono::steady_clock::now();
+                count = scanner.Next(ByteView(saves[s].data(), SIZE), step.predicate);
+                ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+                size_t expectedCount = 0;
+                for (size_t offset = 0; offset < expected.size(); offset++) {
+                    if (!expected[offset]) continue;
+                    int32_t before = Read(saves[s - 1], offset, width);
+                    int32_t after = Read(saves[s], offset, width);
+                    bool keep = step.predicate == ScanPredicate::CHANGED ? after != before
+                              : step.predicate == ScanPredicate::UNCHANGED ? after == before
+                              : step.predicate == ScanPredicate::INCREASED ? after > before
+                              : after < before;
+                    expected[offset] = keep;
+                    expectedCount += keep;
+                }
+                bool correct = count == expectedCount;
+                std::vector<uint32_t> offsets;
+                scanner.GetCandidates(offsets, (size_t)-1);
+                for (uint32_t offset : offsets) correct = correct && expected[offset];
+                ok = ok && correct;
+
+                printf("      %-10s %9zu candidates %7.2f ms  %s%s\n", step.label, count, ms,
+                       scanner.IsDense() ? "bitmap" : "sorted", correct ? "" : "  WRONG");
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
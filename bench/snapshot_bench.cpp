@@ -0,0 +1,85 @@
+// snapshot_bench.cpp - Gathering every field of the largest game table
+#include "../src/core/field_snapshot.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+static double NanosPer(std::chrono::steady_clock::time_point start, int rounds) {
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+}
+
+int main() {
+    const std::string path = "snapshot_bench.bin";
+    std::vector<uint8_t> buf(1300000);
+    uint32_t x = 0xF1E1D5u;
+    for (size_t i = 0; i < buf.size(); i++) {
+        x = x * 1664525u + 1013904223u;
+        buf[i] = (uint8_t)(x >> 24);
+    }
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(buf.data()), buf.size());
+    }
+
+    SaveFile save;
+    if (!save.Load(path)) {
+        printf("Failed to load %s\n", path.c_str());
+        return 1;
+    }
+
+    GameData game(GameType::RAC3_VITA);
+    FieldSnapshot snapshot;
+    snapshot.Build(game);
+    size_t rows = 0;
+    for (int group = 0; group < (int)FieldGroup::COUNT; group++) {
+        rows += snapshot.GetCount((FieldGroup)group);
+    }
+
+    const int ROUNDS = 20000;
+    size_t sink = 0;
+
+    // What the render code used to do for every row, every frame
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        char textBuf[64];
+        for (const GameValue& value : game.values) {
+            sink += snprintf(textBuf, sizeof(textBuf), "%d", save.ReadInt32(value.offset));
+        }
+        for (const GameValue& value : game.extra_values) {
+            sink += snprintf(textBuf, sizeof(textBuf), "%d", save.ReadInt32(value.offset));
+        }
+        for (const GameWeapon& weapon : game.weapons) {
+            sink += snprintf(textBuf, sizeof(textBuf), "%d / %d", save.ReadInt32(weapon.ammo_offset), weapon.max_ammo);
+        }
+        for (const GameGadget& gadget : game.gadgets) sink += save.ReadBool(gadget.offset, gadget.bit_index);
+        for (const GameUnlockable& unlockable : game.unlockables) {
+            sink += save.ReadBool(unlockable.offset, unlockable.bit_index);
+        }
+    }
+    double perRowRead = NanosPer(start, ROUNDS);
+
+    // Snapshot after an edit that changes one field
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        save.WriteInt32(36, round);
+        sink += snapshot.Refresh(save);
+    }
+    double gatherOneChanged = NanosPer(start, ROUNDS);
+
+    // Snapshot on frames where nothing changed
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        sink += snapshot.Refresh(save);
+    }
+    double unchanged = NanosPer(start, ROUNDS);
+
+    printf("%s: %zu fields\n", game.name, rows);
+    printf("  read + format every row:     %8.0f ns\n", perRowRead);
+    printf("  snapshot gather, one change: %8.0f ns\n", gatherOneChanged);
+    printf("  snapshot, nothing changed:   %8.1f ns%s\n", unchanged, sink == 0 ? " " : "");
+
+    std::remove(path.c_str());
+    return 0;
+}
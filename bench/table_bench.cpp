@@ -0,0 +1,42 @@
+// table_bench.cpp - Heap traffic and time spent on the game tables
+#include "../src/data/rac_vita_games_data.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Counts every allocation, including those made by static initialisers
+static size_t allocations = 0;
+static size_t allocatedBytes = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    allocatedBytes += size;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+int main() {
+    printf("Before main: %zu allocations, %zu bytes\n", allocations, allocatedBytes);
+
+    const int OPENS = 100000;
+    size_t startAllocations = allocations;
+    size_t startBytes = allocatedBytes;
+    size_t rows = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < OPENS; i++) {
+        GameData game((GameType)(1 + i % 3));
+        rows += game.values.size() + game.weapons.size() + game.gadgets.size() +
+                game.unlockables.size() + game.extra_values.size();
+    }
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    printf("Per GameData: %.1f allocations, %.0f bytes, %.3f us (%zu rows)\n",
+           (double)(allocations - startAllocations) / OPENS,
+           (double)(allocatedBytes - startBytes) / OPENS, micros / OPENS, rows / OPENS);
+    return 0;
+}
@@ -1,15 +1,18 @@
 // app.cpp - WITH static member definitions
 #include "app.h"
 #include "utils/colors.h"
+#include "core/offset_db.h"
 #include <psp2/touch.h>
 #include <psp2/io/stat.h>
+#include <cstdio>
 
 // DEFINE the static members here (only once in the entire program)
 uint32_t InputState::oldButtons = 0;
 bool InputState::oldTouchPressed = false;
 
 App::App() 
-    : window(nullptr), renderer(nullptr), font(nullptr),
+    : window(nullptr), renderer(nullptr), font(nullptr), text(nullptr),
+      frame(nullptr), hud(nullptr), drawBackend(nullptr),
       state(AppState::FILE_BROWSER), fileBrowser(nullptr), 
       saveEditor(nullptr), running(true) {
 }
@@ -64,33 +67,65 @@ bool App::Initialize() {
         return false;
     }
     
-    // Enable touch
+    // Enable touch; the rear pad toggles the perf HUD
     sceTouchSetSamplingState(SCE_TOUCH_PORT_FRONT, SCE_TOUCH_SAMPLING_STATE_START);
+    sceTouchSetSamplingState(SCE_TOUCH_PORT_BACK, SCE_TOUCH_SAMPLING_STATE_START);
     
     // Create directories
     sceIoMkdir("ux0:/data", 0777);
     sceIoMkdir("ux0:/data/slimseditor", 0777);
     sceIoMkdir("ux0:/data/slimseditor/saves", 0777);
     
+    // Optional offset database; without one the built-in tables are used
+    GameTables::LoadDatabase("ux0:/data/slimseditor/offsets.bin");
+    
     // Initialize UI components
-    fileBrowser = new FileBrowser(renderer, font);
-    saveEditor = new SaveEditor(renderer, font);
+    text = new TextRenderer(renderer, font);
+    drawBackend = new SdlDrawBackend(renderer, text);
+    frame = new RetainedFrame(renderer, &drawList, 960, 544, Colors::Background());
+    hud = new PerfHud(renderer, text);
+    fileBrowser = new FileBrowser(&drawList, text);
+    saveEditor = new SaveEditor(&drawList, text);
     
     return true;
 }
 
 void App::Run() {
+    FrameScheduler scheduler;
+    
     while (running) {
+        scheduler.WaitForNextFrame();
+        hud->BeginFrame();
         HandleEvents();
+        hud->Mark(PerfPhase::EVENTS);
+        
         Update();
-        Render();
-        SDL_Delay(16); // ~60 FPS
+        hud->Mark(PerfPhase::UPDATE);
+        bool changed = Render();
+        hud->Mark(PerfPhase::RENDER);
+        bool presented = Present(changed);
+        hud->Mark(PerfPhase::PRESENT);
+        scheduler.FrameDone(presented);
+        
+        hud->SetTotal(PerfCounter::GLYPHS, text->GetGlyphsRasterised());
+        hud->SetTotal(PerfCounter::TEXTURES, text->GetTexturesCreated());
+        hud->SetTotal(PerfCounter::FILL_RECTS, PerfHud::GetFillRectCount());
+        hud->SetTotal(PerfCounter::SAVE_READS, saveFile.GetReadCount());
+        hud->SetTotal(PerfCounter::ALLOCATIONS, PerfHud::GetAllocationCount());
+        hud->SetTotal(PerfCounter::DIR_SCANS, fileBrowser->GetScanCount());
+        hud->SetTotal(PerfCounter::DIR_CACHE_HITS, fileBrowser->GetCacheHits());
+        hud->Set(PerfCounter::INPUT_LATENCY, scheduler.GetLastLatencyMicros());
+        hud->EndFrame();
     }
 }
 
 void App::Shutdown() {
     if (saveEditor) delete saveEditor;
     if (fileBrowser) delete fileBrowser;
+    if (hud) delete hud;
+    if (frame) delete frame;
+    if (drawBackend) delete drawBackend;
+    if (text) delete text;
     if (font) TTF_CloseFont(font);
     if (renderer) SDL_DestroyRenderer(renderer);
     if (window) SDL_DestroyWindow(window);
@@ -116,6 +151,8 @@ void App::HandleEvents() {
 }
 
 void App::Update() {
+    hud->Update();
+    
     if (state == AppState::FILE_BROWSER) {
         fileBrowser->Update(input);
         
@@ -125,6 +162,7 @@ void App::Update() {
             if (saveFile.Load(path)) {
                 saveEditor->SetSaveFile(&saveFile);
                 state = AppState::SAVE_EDITOR;
+                frame->Invalidate();
             }
         }
     } else if (state == AppState::SAVE_EDITOR) {
@@ -132,24 +170,70 @@ void App::Update() {
         
         if (saveEditor->WantsToGoBack()) {
             saveEditor->ResetBackFlag();
+            saveEditor->FlushSaves();
             state = AppState::FILE_BROWSER;
+            frame->Invalidate();
         }
     }
 }
 
-void App::Render() {
-    // Clear screen
-    SDL_Color bg = Colors::Background();
-    SDL_SetRenderDrawColor(renderer, bg.r, bg.g, bg.b, bg.a);
-    SDL_RenderClear(renderer);
+// Returns true when any layer was redrawn
+bool App::Render() {
+    // A capture wants the whole screen, not just what changed
+    bool capture = hud->TakeCaptureRequest();
+    if (capture) {
+        frame->Invalidate();
+    }
     
-    // Render current state
+    if (!frame->Begin()) {
+        // No render targets: clear and draw everything, every frame
+        SDL_Color bg = Colors::Background();
+        SDL_SetRenderDrawColor(renderer, bg.r, bg.g, bg.b, bg.a);
+        SDL_RenderClear(renderer);
+    }
+    
+    // Record the current state; only layers whose contents changed draw
+    drawList.Clear();
     if (state == AppState::FILE_BROWSER) {
-        fileBrowser->Render();
+        fileBrowser->Render(*frame);
     } else if (state == AppState::SAVE_EDITOR) {
-        saveEditor->Render();
+        saveEditor->Render(*frame);
     }
     
-    // Present
+    if (capture) {
+        CaptureDrawList();
+    }
+    drawList.Submit(*drawBackend);
+    
+    return frame->End();
+}
+
+// Saves this frame's draw list for replay on the host (bench/draw_bench)
+void App::CaptureDrawList() {
+    std::string screen = state == AppState::SAVE_EDITOR ? saveEditor->GetScreenName() : "file_browser";
+    std::vector<uint8_t> bytes;
+    drawList.Serialize(screen, bytes);
+    
+    std::string path = PerfHud::FreePath("drawlist", ".bin");
+    FILE* file = path.empty() ? nullptr : fopen(path.c_str(), "wb");
+    bool ok = file && fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    if (file && fclose(file) != 0) ok = false;
+    
+    if (ok) {
+        printf("Captured %s draw list (%zu commands) to %s\n", screen.c_str(), drawList.GetCommandCount(), path.c_str());
+    } else {
+        printf("Draw list capture failed\n");
+    }
+}
+
+// Returns false when nothing changed and the frame was skipped
+bool App::Present(bool changed) {
+    if (!changed && !hud->NeedsDraw()) {
+        return false;
+    }
+    
+    frame->Compose();
+    hud->Render();
     SDL_RenderPresent(renderer);
+    return true;
 }
\ No newline at end of file
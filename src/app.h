@@ -4,6 +4,12 @@
 #include <SDL2/SDL_ttf.h>
 #include "ui/file_browser.h"
 #include "ui/save_editor.h"
+#include "ui/text_renderer.h"
+#include "ui/retained_frame.h"
+#include "ui/frame_scheduler.h"
+#include "ui/perf_hud.h"
+#include "ui/draw_list.h"
+#include "ui/sdl_draw_backend.h"
 #include "core/save_file.h"
 #include "utils/input.h"
 
@@ -24,11 +30,18 @@ public:
 private:
     void HandleEvents();
     void Update();
-    void Render();
+    bool Render();
+    bool Present(bool changed);
+    void CaptureDrawList();
     
     SDL_Window* window;
     SDL_Renderer* renderer;
     TTF_Font* font;
+    TextRenderer* text;
+    RetainedFrame* frame;
+    PerfHud* hud;
+    DrawList drawList;
+    SdlDrawBackend* drawBackend;
     
     AppState state;
     InputState input;
@@ -0,0 +1,616 @@
+// slims_cli.cpp - Headless batch detect / validate / edit for save folders
+//
+//   slims_cli [options] <file-or-directory>...
+//
+// Every file is loaded, detected and checksum-validated; with --apply or
+// --set it is also edited and saved back through the same page-granular,
+// journaled path the Vita app uses. Files are processed in parallel.
+// --diff compares two saves instead and names the table fields that moved;
+// --scan narrows down where an unknown value lives over a series of saves.
+#include "../core/backup_store.h"
+#include "../core/field_presets.h"
+#include "../core/game_detect.h"
+#include "../core/offset_db.h"
+#include "../core/parallel.h"
+#include "../core/save_diff.h"
+#include "../core/save_file.h"
+#include "../core/value_scanner.h"
+#include "../core/work_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    struct Options {
+        std::vector<std::string> presets;
+        std::vector<std::string> assignments;
+        std::vector<std::string> inputs;
+        std::string diffOld;
+        std::string diffNew;
+        std::string backupDir;
+        std::string restorePath;
+        uint32_t restoreVersion = 0;
+        bool listVersions = false;
+        std::string offsetsPath;
+        std::string compileIn;
+        std::string compileOut;
+        std::string exportPath;
+        std::vector<std::string> scanSteps;
+        uint32_t scanWidth = 4;
+        GameType forcedGame = GameType::UNKNOWN;
+        float minConfidence = 0.25f;
+        int threads = 0;
+        bool fixChecksum = false;
+        bool dryRun = false;
+        bool recursive = false;
+    };
+
+    struct FileResult {
+        std::string path;
+        bool loaded = false;
+        GameType game = GameType::UNKNOWN;
+        float confidence = 0.0f;
+        bool checksumValid = false;
+        int changes = 0;
+        size_t fileBytes = 0;
+        size_t bytesWritten = 0;
+        std::string note;
+    };
+
+    void PrintUsage() {
+        printf("Usage: slims_cli [options] <file-or-directory>...\n"
+               "\n"
+               "  -a, --apply <preset>      Apply a named edit (repeatable)\n"
+               "  -s, --set <Field=value>   Set one field by its table name (repeatable)\n"
+               "  -c, --fix-checksum        Rewrite the trailing CRC-32 after editing\n"
+               "  -n, --dry-run             Edit in memory only; write nothing\n"
+               "  -j, --threads <n>         Worker threads (default: all cores)\n"
+               "  -r, --recursive           Descend into subdirectories\n"
+               "  -g, --game <rac1|rac2|rac3>  Skip detection\n"
+               "      --min-confidence <x>  Leave files detected below this alone (default 0.25)\n"
+               "  -d, --diff <old> <new>    List changed byte ranges and the fields they hit\n"
+               "  -S, --scan <file>:<test>  Narrow down an unknown offset, one save per step;\n"
+               "                            test is =N, any, changed, unchanged, increased\n"
+               "                            or decreased (the first step takes =N or any)\n"
+               "  -w, --width <1|2|4>       Value size in bytes for --scan (default 4)\n"
+               "  -b, --backup-dir <dir>    Back up each file there before it is overwritten\n"
+               "      --versions            List the backed-up versions of each file\n"
+               "      --restore <n> <file>  Put version n back (the current file is backed up)\n"
+               "      --offsets <file.bin>  Use a compiled offset database over the built-in tables\n"
+               "      --compile-offsets <in.json> <out.bin>  Compile an offset database\n"
+               "      --export-offsets <out.json>  Write the built-in tables as database JSON\n"
+               "  -l, --list-presets        Show the available presets\n"
+               "  -h, --help\n"
+               "\n"
+               "Directories contribute their *.bin files; files named directly are\n"
+               "always processed.\n");
+    }
+
+    void PrintPresets() {
+        for (const FieldPreset& preset : FieldPresets::All()) {
+            printf("  %-16s %s\n", preset.name, preset.description);
+        }
+    }
+
+    const char* ShortGameName(GameType type) {
+        switch (type) {
+            case GameType::RAC1_VITA: return "RC1";
+            case GameType::RAC2_VITA: return "RC2";
+            case GameType::RAC3_VITA: return "RC3";
+            default: return "???";
+        }
+    }
+
+    // Returns 0 to continue, otherwise the exit code
+    int ParseArgs(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto value = [&](const char* what) -> const char* {
+                if (i + 1 >= argc) {
+                    fprintf(stderr, "%s needs %s\n", arg.c_str(), what);
+                    return nullptr;
+                }
+                return argv[++i];
+            };
+
+            if (arg == "-h" || arg == "--help") {
+                PrintUsage();
+                return -1;
+            } else if (arg == "-l" || arg == "--list-presets") {
+                PrintPresets();
+                return -1;
+            } else if (arg == "-d" || arg == "--diff") {
+                const char* oldPath = value("two save files");
+                const char* newPath = oldPath ? value("two save files") : nullptr;
+                if (!newPath) return 2;
+                options.diffOld = oldPath;
+                options.diffNew = newPath;
+            } else if (arg == "-S" || arg == "--scan") {
+                const char* step = value("file:test");
+                if (!step) return 2;
+                options.scanSteps.push_back(step);
+            } else if (arg == "-w" || arg == "--width") {
+                const char* width = value("1, 2 or 4");
+                if (!width) return 2;
+                options.scanWidth = (uint32_t)std::atoi(width);
+                if (options.scanWidth != 1 && options.scanWidth != 2 && options.scanWidth != 4) {
+                    fprintf(stderr, "Scan width must be 1, 2 or 4\n");
+                    return 2;
+                }
+            } else if (arg == "-b" || arg == "--backup-dir") {
+                const char* dir = value("a directory");
+                if (!dir) return 2;
+                options.backupDir = dir;
+            } else if (arg == "--versions") {
+                options.listVersions = true;
+            } else if (arg == "--restore") {
+                const char* version = value("a version and a file");
+                const char* path = version ? value("a version and a file") : nullptr;
+                if (!path) return 2;
+                options.restoreVersion = (uint32_t)std::atoi(version);
+                options.restorePath = path;
+            } else if (arg == "--offsets") {
+                const char* path = value("a compiled database");
+                if (!path) return 2;
+                options.offsetsPath = path;
+            } else if (arg == "--compile-offsets") {
+                const char* in = value("a JSON file and an output file");
+                const char* out = in ? value("a JSON file and an output file") : nullptr;
+                if (!out) return 2;
+                options.compileIn = in;
+                options.compileOut = out;
+            } else if (arg == "--export-offsets") {
+                const char* path = value("an output file");
+                if (!path) return 2;
+                options.exportPath = path;
+            } else if (arg == "-a" || arg == "--apply") {
+                const char* name = value("a preset name");
+                if (!name) return 2;
+                if (!FieldPresets::Find(name)) {
+                    fprintf(stderr, "Unknown preset '%s'; available:\n", name);
+                    PrintPresets();
+                    return 2;
+                }
+                options.presets.push_back(name);
+            } else if (arg == "-s" || arg == "--set") {
+                const char* assignment = value("Field=value");
+                if (!assignment) return 2;
+                options.assignments.push_back(assignment);
+            } else if (arg == "-c" || arg == "--fix-checksum") {
+                options.fixChecksum = true;
+            } else if (arg == "-n" || arg == "--dry-run") {
+                options.dryRun = true;
+            } else if (arg == "-r" || arg == "--recursive") {
+                options.recursive = true;
+            } else if (arg == "-j" || arg == "--threads") {
+                const char* count = value("a thread count");
+                if (!count) return 2;
+                options.threads = std::atoi(count);
+            } else if (arg == "--min-confidence") {
+                const char* confidence = value("a number");
+                if (!confidence) return 2;
+                options.minConfidence = (float)std::atof(confidence);
+            } else if (arg == "-g" || arg == "--game") {
+                const char* game = value("rac1, rac2 or rac3");
+                if (!game) return 2;
+                std::string name = game;
+                if (name == "rac1") options.forcedGame = GameType::RAC1_VITA;
+                else if (name == "rac2") options.forcedGame = GameType::RAC2_VITA;
+                else if (name == "rac3") options.forcedGame = GameType::RAC3_VITA;
+                else {
+                    fprintf(stderr, "Unknown game '%s'\n", game);
+                    return 2;
+                }
+            } else if (!arg.empty() && arg[0] == '-') {
+                fprintf(stderr, "Unknown option %s\n", arg.c_str());
+                return 2;
+            } else {
+                options.inputs.push_back(arg);
+            }
+        }
+
+        if ((options.listVersions || !options.restorePath.empty()) && options.backupDir.empty()) {
+            fprintf(stderr, "--versions and --restore need --backup-dir\n");
+            return 2;
+        }
+        if (options.inputs.empty() && options.diffOld.empty() && options.scanSteps.empty() &&
+            options.restorePath.empty() && options.compileIn.empty() && options.exportPath.empty()) {
+            PrintUsage();
+            return 2;
+        }
+        return 0;
+    }
+
+    bool IsSaveName(const fs::path& path) {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        return extension == ".bin";
+    }
+
+    std::vector<std::string> CollectFiles(const Options& options) {
+        std::vector<std::string> files;
+        std::error_code error;
+        for (const std::string& input : options.inputs) {
+            if (!fs::is_directory(input, error)) {
+                files.push_back(input);
+                continue;
+            }
+
+            auto add = [&](const fs::directory_entry& entry) {
+                if (entry.is_regular_file(error) && IsSaveName(entry.path())) {
+                    files.push_back(entry.path().string());
+                }
+            };
+            if (options.recursive) {
+                for (const auto& entry : fs::recursive_directory_iterator(input, error)) add(entry);
+            } else {
+                for (const auto& entry : fs::directory_iterator(input, error)) add(entry);
+            }
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    void ProcessFile(const Options& options, BackupStore* backups, SaveFile& save, FileResult& result) {
+        if (!save.Load(result.path)) {
+            result.note = "cannot read";
+            return;
+        }
+        result.loaded = true;
+        result.fileBytes = save.GetSize();
+        result.checksumValid = save.IsChecksumValid();
+
+        if (options.forcedGame != GameType::UNKNOWN) {
+            result.game = options.forcedGame;
+            result.confidence = 1.0f;
+        } else {
+            DetectionResult detection = GameDetect::Detect(save.GetView());
+            result.game = detection.type;
+            result.confidence = detection.confidence;
+        }
+
+        bool wantsEdits = !options.presets.empty() || !options.assignments.empty();
+        if (!wantsEdits && !options.fixChecksum) return;
+
+        if (wantsEdits) {
+            if (result.game == GameType::UNKNOWN || result.confidence < options.minConfidence) {
+                result.note = "skipped: game not recognised with enough confidence";
+                return;
+            }
+
+            GameData game = GameTables::Get(result.game);
+            for (const std::string& preset : options.presets) {
+                result.changes += FieldPresets::Apply(preset, save, game);
+            }
+            for (const std::string& assignment : options.assignments) {
+                int changed = FieldPresets::SetField(assignment, save, game);
+                if (changed < 0) {
+                    result.note += (result.note.empty() ? "no field '" : ", no field '") + assignment + "'";
+                } else {
+                    result.changes += changed;
+                }
+            }
+        }
+
+        if (options.fixChecksum) {
+            save.RecalculateChecksum();
+        }
+
+        if (!options.dryRun && save.IsModified()) {
+            if (backups && !backups->BackupFile(result.path)) {
+                result.note += result.note.empty() ? "backup failed, not saved" : ", backup failed, not saved";
+                return;
+            }
+            if (save.Save()) {
+                result.bytesWritten = save.GetLastSaveStats().bytesWritten;
+            } else {
+                result.note += result.note.empty() ? "save failed" : ", save failed";
+            }
+        }
+    }
+
+    void PrintBytes(ByteView view, const DiffRange& range) {
+        const uint32_t SHOWN = 8;
+        for (uint32_t i = 0; i < std::min(range.length, SHOWN); i++) {
+            if (range.offset + i < view.size()) printf("%02X", view[range.offset + i]);
+            else printf("--");
+        }
+        if (range.length > SHOWN) printf("..");
+    }
+
+    int32_t FieldValue(ByteView view, const FieldRef& field) {
+        if (field.length == 1) return field.offset < view.size() ? view[field.offset] : 0;
+        return (int32_t)view.ReadU32(field.offset);
+    }
+
+    int RunDiff(const Options& options) {
+        SaveFile oldSave, newSave;
+        if (!oldSave.Load(options.diffOld) || !newSave.Load(options.diffNew)) {
+            fprintf(stderr, "Cannot read %s\n", oldSave.IsLoaded() ? options.diffNew.c_str() : options.diffOld.c_str());
+            return 1;
+        }
+        ByteView before = oldSave.GetView();
+        ByteView after = newSave.GetView();
+
+        GameType type = options.forcedGame;
+        if (type == GameType::UNKNOWN) type = DetectGameType(after);
+        FieldIndex index;
+        if (type != GameType::UNKNOWN) index.Build(GameTables::Get(type));
+
+        std::vector<DiffRange> ranges;
+        SaveDiff::Compare(before, after, ranges);
+
+        size_t changedBytes = 0, unknownRanges = 0;
+        std::vector<const FieldRef*> fields;
+        for (const DiffRange& range : ranges) {
+            changedBytes += range.length;
+            printf("0x%06X %6u  ", range.offset, range.length);
+            PrintBytes(before, range);
+            printf(" -> ");
+            PrintBytes(after, range);
+            printf("\n");
+
+            fields.clear();
+            index.Find(range.offset, range.length, fields);
+            unknownRanges += fields.empty();
+            for (const FieldRef* field : fields) {
+                printf("           %s (%s): %d -> %d\n", field->name, FieldIndex::KindName(field->kind),
+                       FieldValue(before, *field), FieldValue(after, *field));
+            }
+        }
+
+        printf("\n%zu ranges, %zu bytes changed, %zu outside known fields (%s tables)\n", ranges.size(),
+               changedBytes, unknownRanges, type == GameType::UNKNOWN ? "no" : GetGameName(type));
+        return 0;
+    }
+
+    // "=N" sets value; "any" is only valid as the first step
+    bool ParseScanTest(const std::string& test, bool first, ScanPredicate& predicate, int32_t& value, bool& any) {
+        any = false;
+        if (!test.empty() && test[0] == '=') {
+            char* end = nullptr;
+            long number = std::strtol(test.c_str() + 1, &end, 0);
+            if (end == test.c_str() + 1 || *end != '\0') return false;
+            predicate = ScanPredicate::EQUALS;
+            value = (int32_t)number;
+            return true;
+        }
+        if (first) {
+            any = test == "any";
+            return any;
+        }
+        if (test == "changed") predicate = ScanPredicate::CHANGED;
+        else if (test == "unchanged") predicate = ScanPredicate::UNCHANGED;
+        else if (test == "increased") predicate = ScanPredicate::INCREASED;
+        else if (test == "decreased") predicate = ScanPredicate::DECREASED;
+        else return false;
+        return true;
+    }
+
+    int RunScan(const Options& options) {
+        const size_t SHOWN = 20;
+        ValueScanner scanner;
+        SaveFile save;
+        GameType type = options.forcedGame;
+
+        for (size_t i = 0; i < options.scanSteps.size(); i++) {
+            const std::string& step = options.scanSteps[i];
+            size_t colon = step.rfind(':');
+            std::string path = step.substr(0, colon);
+            std::string test = colon == std::string::npos ? "" : step.substr(colon + 1);
+
+            ScanPredicate predicate = ScanPredicate::EQUALS;
+            int32_t value = 0;
+            bool any = false;
+            if (colon == std::string::npos || !ParseScanTest(test, i == 0, predicate, value, any)) {
+                fprintf(stderr, "Bad scan step '%s'\n", step.c_str());
+                return 2;
+            }
+            if (!save.Load(path)) {
+                fprintf(stderr, "Cannot read %s\n", path.c_str());
+                return 1;
+            }
+            if (type == GameType::UNKNOWN) type = DetectGameType(save.GetView());
+
+            auto start = std::chrono::steady_clock::now();
+            size_t count;
+            if (i == 0) {
+                count = any ? scanner.First(save.GetView(), options.scanWidth)
+                            : scanner.First(save.GetView(), options.scanWidth, value);
+            } else {
+                count = scanner.Next(save.GetView(), predicate, value);
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            printf("%-40s %-10s %9zu candidates  %.2f ms\n", path.c_str(), test.c_str(), count, ms);
+        }
+
+        FieldIndex index;
+        if (type != GameType::UNKNOWN) index.Build(GameTables::Get(type));
+        std::vector<uint32_t> offsets;
+        std::vector<const FieldRef*> fields;
+        scanner.GetCandidates(offsets, SHOWN);
+        if (!offsets.empty()) printf("\n");
+        for (uint32_t offset : offsets) {
+            printf("0x%06X  %11d", offset, scanner.GetValue(offset));
+            fields.clear();
+            index.Find(offset, options.scanWidth, fields);
+            for (const FieldRef* field : fields) printf("  %s (%s)", field->name, FieldIndex::KindName(field->kind));
+            printf("\n");
+        }
+        if (scanner.GetCount() > offsets.size()) printf("... %zu more\n", scanner.GetCount() - offsets.size());
+        return 0;
+    }
+
+    int ListVersions(const Options& options, const std::vector<std::string>& files) {
+        BackupStore backups(options.backupDir);
+        for (const std::string& path : files) {
+            std::vector<BackupVersion> versions = backups.ListVersions(path);
+            printf("%s: %zu versions\n", path.c_str(), versions.size());
+            for (const BackupVersion& version : versions) {
+                time_t when = (time_t)version.time;
+                char stamp[32];
+                strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", localtime(&when));
+                printf("  %4u  %s  %8u bytes  crc %08X\n", version.sequence, stamp, version.fileSize, version.fileCrc);
+            }
+        }
+        return 0;
+    }
+
+    int RunRestore(const Options& options) {
+        BackupStore backups(options.backupDir);
+        std::vector<uint8_t> bytes;
+        if (!backups.Restore(options.restorePath, options.restoreVersion, bytes)) {
+            fprintf(stderr, "No intact version %u of %s\n", options.restoreVersion, options.restorePath.c_str());
+            return 1;
+        }
+        if (!backups.BackupFile(options.restorePath)) {
+            fprintf(stderr, "Cannot back up %s first; not restoring\n", options.restorePath.c_str());
+            return 1;
+        }
+        FILE* file = fopen(options.restorePath.c_str(), "wb");
+        bool ok = file && fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        ok = file && fclose(file) == 0 && ok;
+        printf("%s %s to version %u (%zu bytes)\n", ok ? "Restored" : "Failed to restore",
+               options.restorePath.c_str(), options.restoreVersion, bytes.size());
+        return ok ? 0 : 1;
+    }
+
+    bool ReadText(const std::string& path, std::string& out) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) return false;
+        char buffer[64 * 1024];
+        size_t got;
+        while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0) out.append(buffer, got);
+        bool ok = !ferror(file);
+        fclose(file);
+        return ok;
+    }
+
+    bool WriteBytes(const std::string& path, const void* data, size_t size) {
+        FILE* file = fopen(path.c_str(), "wb");
+        bool ok = file && fwrite(data, 1, size, file) == size;
+        return file && fclose(file) == 0 && ok;
+    }
+
+    int RunCompileOffsets(const Options& options) {
+        std::string json, error;
+        if (!ReadText(options.compileIn, json)) {
+            fprintf(stderr, "Cannot read %s\n", options.compileIn.c_str());
+            return 1;
+        }
+        std::vector<uint8_t> compiled;
+        if (!OffsetDatabase::Compile(json, compiled, error)) {
+            fprintf(stderr, "%s: %s\n", options.compileIn.c_str(), error.c_str());
+            return 1;
+        }
+
+        // Read it back the way the app will before calling it done
+        OffsetDatabase check;
+        if (!check.LoadFromMemory(compiled)) {
+            fprintf(stderr, "Compiled database does not load: %s\n", check.GetError().c_str());
+            return 1;
+        }
+        if (!WriteBytes(options.compileOut, compiled.data(), compiled.size())) {
+            fprintf(stderr, "Cannot write %s\n", options.compileOut.c_str());
+            return 1;
+        }
+        printf("Compiled %zu games, %zu fields into %s (%zu bytes)\n", check.GetGameCount(), check.GetFieldCount(),
+               options.compileOut.c_str(), compiled.size());
+        return 0;
+    }
+
+    int RunExportOffsets(const Options& options) {
+        std::string json = OffsetDatabase::ExportBuiltIn();
+        if (!WriteBytes(options.exportPath, json.data(), json.size())) {
+            fprintf(stderr, "Cannot write %s\n", options.exportPath.c_str());
+            return 1;
+        }
+        printf("Wrote the built-in tables to %s\n", options.exportPath.c_str());
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    int parsed = ParseArgs(argc, argv, options);
+    if (parsed != 0) return parsed < 0 ? 0 : parsed;
+    if (!options.compileIn.empty()) return RunCompileOffsets(options);
+    if (!options.exportPath.empty()) return RunExportOffsets(options);
+    if (!options.offsetsPath.empty()) {
+        std::string error;
+        if (!GameTables::LoadDatabase(options.offsetsPath, &error)) {
+            fprintf(stderr, "%s: %s\n", options.offsetsPath.c_str(), error.c_str());
+            return 1;
+        }
+    }
+    if (!options.diffOld.empty()) return RunDiff(options);
+    if (!options.scanSteps.empty()) return RunScan(options);
+    if (!options.restorePath.empty()) return RunRestore(options);
+
+    std::vector<std::string> files = CollectFiles(options);
+    if (files.empty()) {
+        fprintf(stderr, "No save files found\n");
+        return 1;
+    }
+    if (options.listVersions) return ListVersions(options, files);
+
+    // Files are the unit of parallelism; hashing inside one file stays serial
+    Parallel::SetThreadCount(1);
+    int threads = options.threads > 0 ? options.threads : Parallel::DefaultThreadCount();
+    threads = std::min<int>(threads, (int)files.size());
+
+    std::unique_ptr<BackupStore> backups;
+    if (!options.backupDir.empty()) backups.reset(new BackupStore(options.backupDir));
+
+    std::vector<FileResult> results(files.size());
+    auto start = std::chrono::steady_clock::now();
+    size_t steals = 0;
+    {
+        // One SaveFile per worker so its load buffer is reused file to file
+        std::vector<SaveFile> saves(threads);
+        WorkPool pool(threads);
+        for (size_t i = 0; i < files.size(); i++) {
+            results[i].path = files[i];
+            pool.Submit([&, i](int worker) {
+                ProcessFile(options, backups.get(), saves[worker], results[i]);
+            });
+        }
+        pool.Wait();
+        steals = pool.GetStealCount();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t totalBytes = 0, written = 0, failures = 0, badChecksums = 0;
+    for (const FileResult& result : results) {
+        totalBytes += result.fileBytes;
+        written += result.bytesWritten;
+        failures += !result.loaded;
+        badChecksums += result.loaded && !result.checksumValid;
+
+        if (!result.loaded) {
+            printf("%-48s  %s\n", result.path.c_str(), result.note.c_str());
+            continue;
+        }
+        printf("%-48s  %s %4.2f  checksum %-8s  %3d changed  %7zu written%s%s\n",
+               result.path.c_str(), ShortGameName(result.game), result.confidence,
+               result.checksumValid ? "ok" : "MISMATCH", result.changes, result.bytesWritten,
+               result.note.empty() ? "" : "  ", result.note.c_str());
+    }
+
+    double megabytes = totalBytes / (1024.0 * 1024.0);
+    printf("\n%zu files (%zu unreadable, %zu checksum mismatches), %.1f MB read, %zu bytes written%s\n",
+           files.size(), failures, badChecksums, megabytes, written, options.dryRun ? " (dry run)" : "");
+    printf("%.3f s on %d threads: %.0f files/s, %.1f MB/s (%zu tasks stolen)\n", seconds, threads,
+           files.size() / seconds, megabytes / seconds, steals);
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,467 @@
+// backup_store.cpp - Deduplicated, compressed version history of save files
+#include "backup_store.h"
+#include "crc32.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+namespace {
+
+    const char CHUNK_MAGIC[4] = {'S', 'L', 'M', 'C'};
+    const char MANIFEST_MAGIC[4] = {'S', 'L', 'M', 'B'};
+    const uint32_t MANIFEST_FORMAT = 1;
+    const size_t MANIFEST_HEADER = 40;
+    const size_t MANIFEST_ENTRY = 16;       // hash, crc, length
+    const uint8_t ENTRY_FROM_PARENT = 0;
+    const uint8_t ENTRY_LITERAL = 1;
+    const size_t CHUNK_HEADER = 12;         // magic, length, depth
+    const size_t CHUNK_BASE = 20;           // Delta chunks: the base's hash, crc, length; skip
+
+    // Boundary when the top log2(AVG_CHUNK) bits of the gear hash are zero
+    const int AVG_BITS = 13;
+    static_assert(BackupStore::AVG_CHUNK == (size_t)1 << AVG_BITS, "AVG_CHUNK must match AVG_BITS");
+    const uint64_t BOUNDARY_MASK = ((1ull << AVG_BITS) - 1) << (64 - AVG_BITS);
+
+    // Random 64-bit value per byte (splitmix64); the hash shifts left once per
+    // byte, so it only ever depends on the last 64 bytes
+    struct GearTable {
+        uint64_t gear[256];
+
+        constexpr GearTable() : gear() {
+            uint64_t state = 0x5EEDB4C4u;
+            for (int i = 0; i < 256; i++) {
+                state += 0x9E3779B97F4A7C15ull;
+                uint64_t z = state;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                gear[i] = z ^ (z >> 31);
+            }
+        }
+    };
+
+    constexpr GearTable GEAR;
+
+    size_t ChunkLength(const uint8_t* p, size_t available) {
+        if (available <= BackupStore::MIN_CHUNK) return available;
+        size_t end = std::min(available, BackupStore::MAX_CHUNK);
+
+        // Bytes before the minimum only need to warm the hash up
+        uint64_t hash = 0;
+        for (size_t i = BackupStore::MIN_CHUNK - 64; i < end; i++) {
+            hash = (hash << 1) + GEAR.gear[p[i]];
+            if (i >= BackupStore::MIN_CHUNK && (hash & BOUNDARY_MASK) == 0) return i + 1;
+        }
+        return end;
+    }
+
+    uint64_t Hash64(const uint8_t* p, size_t length) {
+        uint64_t hash = 0x9E3779B97F4A7C15ull ^ length;
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, p + i, 8);
+            hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+            hash ^= hash >> 29;
+        }
+        for (; i < length; i++) {
+            hash = (hash ^ p[i]) * 0xC4CEB9FE1A85EC53ull;
+        }
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    void Put32(std::vector<uint8_t>& out, uint32_t value) {
+        uint8_t bytes[4];
+        std::memcpy(bytes, &value, 4);
+        out.insert(out.end(), bytes, bytes + 4);
+    }
+
+    void Put64(std::vector<uint8_t>& out, uint64_t value) {
+        Put32(out, (uint32_t)value);
+        Put32(out, (uint32_t)(value >> 32));
+    }
+
+    uint32_t Get32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, 4);
+        return value;
+    }
+
+    uint64_t Get64(const uint8_t* p) {
+        return Get32(p) | ((uint64_t)Get32(p + 4) << 32);
+    }
+
+    bool ReadAll(const std::string& path, std::vector<uint8_t>& out) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) return false;
+        bool ok = fseek(file, 0, SEEK_END) == 0;
+        long size = ok ? ftell(file) : -1;
+        ok = size >= 0 && fseek(file, 0, SEEK_SET) == 0;
+        if (ok) {
+            out.resize((size_t)size);
+            ok = size == 0 || fread(out.data(), 1, out.size(), file) == out.size();
+        }
+        fclose(file);
+        return ok;
+    }
+
+    // Written under a temporary name and renamed, so a torn write never
+    // leaves a file that looks complete
+    bool WriteAtomically(const std::string& path, const std::vector<uint8_t>& bytes) {
+        std::string temp = path + ".tmp";
+        FILE* file = fopen(temp.c_str(), "wb");
+        if (!file) return false;
+        bool ok = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        ok = (fclose(file) == 0) && ok;
+        if (ok) {
+            std::remove(path.c_str());
+            ok = std::rename(temp.c_str(), path.c_str()) == 0;
+        }
+        if (!ok) std::remove(temp.c_str());
+        return ok;
+    }
+
+    std::string ManifestName(uint32_t sequence) {
+        char name[16];
+        snprintf(name, sizeof(name), "%08u.man", sequence);
+        return name;
+    }
+
+    bool Exists(const std::string& path) {
+        struct stat info;
+        return stat(path.c_str(), &info) == 0;
+    }
+
+    // mkdir -p; components that already exist (or, like "ux0:", cannot be
+    // created) are skipped
+    bool MakeDirs(const std::string& path) {
+        for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1)) {
+            std::string part = path.substr(0, slash);
+            if (!part.empty() && !Exists(part)) mkdir(part.c_str(), 0777);
+            if (slash == std::string::npos) break;
+        }
+        return Exists(path);
+    }
+}
+
+BackupStore::BackupStore(const std::string& rootDir) : root(rootDir) {
+    while (root.size() > 1 && root.back() == '/') root.pop_back();
+}
+
+std::string BackupStore::VersionDir(const std::string& savePath) const {
+    // One directory per save, named after its full path
+    std::string key = savePath;
+    for (char& c : key) {
+        if (c == '/' || c == '\\' || c == ':') c = '_';
+    }
+    return root + "/versions/" + key;
+}
+
+std::string BackupStore::ChunkPath(const ChunkRef& chunk) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx%08x", (unsigned long long)chunk.hash, chunk.crc);
+    return root + "/chunks/" + std::string(name, 2) + "/" + name + ".z";
+}
+
+bool BackupStore::Backup(const std::string& savePath, ByteView contents) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Manifest manifest;
+    for (size_t pos = 0; pos < contents.size();) {
+        size_t length = ChunkLength(contents.data() + pos, contents.size() - pos);
+        const uint8_t* bytes = contents.data() + pos;
+        manifest.chunks.push_back(ChunkRef{Hash64(bytes, length), Crc32::Update(0, bytes, length), (uint32_t)length});
+        pos += length;
+    }
+    manifest.version.fileSize = (uint32_t)contents.size();
+    manifest.version.fileCrc = Crc32::Update(0, contents.data(), contents.size());
+    manifest.version.chunkCount = (uint32_t)manifest.chunks.size();
+    manifest.version.time = (uint64_t)std::time(nullptr);
+    stats.bytesIn += contents.size();
+
+    std::string dir = VersionDir(savePath);
+    if (!MakeDirs(dir)) return false;
+
+    std::vector<uint32_t> sequences = Sequences(dir);
+    manifest.version.sequence = sequences.empty() ? 1 : sequences.back() + 1;
+    Manifest newest;
+    bool hasNewest = !sequences.empty() && ReadManifest(dir, sequences.back(), newest);
+    if (hasNewest && newest.version.fileSize == manifest.version.fileSize &&
+        newest.version.fileCrc == manifest.version.fileCrc && newest.chunks == manifest.chunks) {
+        stats.versionsSkipped++;
+        return true;
+    }
+
+    // A changed chunk is stored against the newest version's chunk holding
+    // the same file offset; an edit that moved a boundary still lines up
+    size_t pos = 0, basePos = 0, baseIndex = 0;
+    for (const ChunkRef& chunk : manifest.chunks) {
+        const ChunkRef* base = nullptr;
+        if (hasNewest) {
+            while (baseIndex < newest.chunks.size() && basePos + newest.chunks[baseIndex].length <= pos) {
+                basePos += newest.chunks[baseIndex++].length;
+            }
+            if (baseIndex < newest.chunks.size()) base = &newest.chunks[baseIndex];
+        }
+        if (!StoreChunk(chunk, contents.data() + pos, base, (uint32_t)(pos - basePos))) return false;
+        pos += chunk.length;
+    }
+
+    // Keyframes every so often keep manifest chains short
+    bool keyframe = !hasNewest || (manifest.version.sequence - 1) % MANIFEST_KEYFRAME == 0;
+    if (!WriteManifest(dir, manifest, keyframe ? nullptr : &newest)) return false;
+    stats.versionsStored++;
+    return true;
+}
+
+bool BackupStore::BackupFile(const std::string& savePath) {
+    std::vector<uint8_t> contents;
+    if (!ReadAll(savePath, contents)) return !Exists(savePath);
+    return Backup(savePath, ByteView(contents.data(), contents.size()));
+}
+
+bool BackupStore::StoreChunk(const ChunkRef& chunk, const uint8_t* bytes, const ChunkRef* base, uint32_t skip) {
+    std::string path = ChunkPath(chunk);
+    if (knownChunks.count(path) || Exists(path)) {
+        knownChunks.insert(path);
+        stats.chunksReused++;
+        return true;
+    }
+
+    std::vector<uint8_t> out;
+    out.insert(out.end(), CHUNK_MAGIC, CHUNK_MAGIC + 4);
+    Put32(out, chunk.length);
+
+    // XOR against the bytes this chunk replaced, from `skip` into the base:
+    // the few edited bytes in a field of zeros, which zlib shrinks to almost
+    // nothing. Bytes past the end of the base are stored as they are.
+    std::vector<uint8_t> baseBytes, delta;
+    uint32_t baseDepth = 0, depth = 0;
+    const uint8_t* payload = bytes;
+    if (base && skip < base->length && LoadBase(*base, baseBytes, &baseDepth) && baseDepth < MAX_DELTA_DEPTH) {
+        delta.assign(bytes, bytes + chunk.length);
+        uint32_t overlap = std::min(chunk.length, base->length - skip);
+        for (uint32_t i = 0; i < overlap; i++) delta[i] ^= baseBytes[skip + i];
+        payload = delta.data();
+        depth = baseDepth + 1;
+        Put32(out, depth);
+        Put64(out, base->hash);
+        Put32(out, base->crc);
+        Put32(out, base->length);
+        Put32(out, skip);
+    } else {
+        Put32(out, 0);
+    }
+
+    size_t header = out.size();
+    uLongf packedSize = compressBound(chunk.length);
+    out.resize(header + packedSize);
+    if (compress2(&out[header], &packedSize, payload, chunk.length, Z_DEFAULT_COMPRESSION) != Z_OK) return false;
+    out.resize(header + packedSize);
+
+    MakeDirs(path.substr(0, path.rfind('/')));
+    if (!WriteAtomically(path, out)) return false;
+
+    knownChunks.insert(path);
+    Remember(path, depth, bytes, chunk.length);
+    stats.chunksWritten++;
+    stats.bytesWritten += out.size();
+    return true;
+}
+
+bool BackupStore::LoadBase(const ChunkRef& chunk, std::vector<uint8_t>& out, uint32_t* depth) {
+    auto it = recent.find(ChunkPath(chunk));
+    if (it == recent.end()) return LoadChunk(chunk, out, depth);
+    out = it->second.bytes;
+    *depth = it->second.depth;
+    return true;
+}
+
+void BackupStore::Remember(const std::string& path, uint32_t depth, const uint8_t* bytes, uint32_t length) {
+    recent[path] = RecentChunk{depth, std::vector<uint8_t>(bytes, bytes + length)};
+    recentOrder.push_back(path);
+    recentBytes += length;
+    while (recentBytes > RECENT_CACHE_BYTES && !recentOrder.empty()) {
+        auto it = recent.find(recentOrder.front());
+        if (it != recent.end()) {
+            recentBytes -= it->second.bytes.size();
+            recent.erase(it);
+        }
+        recentOrder.pop_front();
+    }
+}
+
+bool BackupStore::LoadChunk(const ChunkRef& chunk, std::vector<uint8_t>& out, uint32_t* depth) const {
+    std::vector<uint8_t> packed;
+    if (!ReadAll(ChunkPath(chunk), packed)) return false;
+    if (packed.size() < CHUNK_HEADER || std::memcmp(packed.data(), CHUNK_MAGIC, 4) != 0) return false;
+    if (Get32(&packed[4]) != chunk.length) return false;
+
+    *depth = Get32(&packed[8]);
+    size_t header = CHUNK_HEADER;
+    std::vector<uint8_t> base;
+    uint32_t skip = 0;
+    if (*depth > 0) {
+        if (*depth > MAX_DELTA_DEPTH || packed.size() < CHUNK_HEADER + CHUNK_BASE) return false;
+        ChunkRef baseRef{Get64(&packed[12]), Get32(&packed[20]), Get32(&packed[24])};
+        skip = Get32(&packed[28]);
+        uint32_t baseDepth;
+        // Depth strictly falls along a chain, so a corrupt store cannot loop
+        if (skip >= baseRef.length || !LoadChunk(baseRef, base, &baseDepth) || baseDepth >= *depth) {
+            return false;
+        }
+        header += CHUNK_BASE;
+    }
+
+    size_t start = out.size();
+    out.resize(start + chunk.length);
+    uLongf rawSize = chunk.length;
+    if (uncompress(&out[start], &rawSize, &packed[header], packed.size() - header) != Z_OK ||
+        rawSize != chunk.length) {
+        return false;
+    }
+    if (!base.empty()) {
+        size_t overlap = std::min<size_t>(chunk.length, base.size() - skip);
+        for (size_t i = 0; i < overlap; i++) out[start + i] ^= base[skip + i];
+    }
+    return Crc32::Update(0, &out[start], chunk.length) == chunk.crc;
+}
+
+bool BackupStore::ReadManifest(const std::string& dir, uint32_t sequence, Manifest& manifest, uint32_t hops) const {
+    std::vector<uint8_t> in;
+    if (!ReadAll(dir + "/" + ManifestName(sequence), in)) return false;
+    if (in.size() < MANIFEST_HEADER + 4 || std::memcmp(in.data(), MANIFEST_MAGIC, 4) != 0) return false;
+    if (Get32(&in[4]) != MANIFEST_FORMAT) return false;
+
+    size_t body = in.size() - 4;
+    if (Get32(&in[body]) != Crc32::Update(0, in.data(), body)) return false;
+
+    BackupVersion& version = manifest.version;
+    version.sequence = Get32(&in[8]);
+    version.time = Get64(&in[12]);
+    version.fileSize = Get32(&in[20]);
+    version.fileCrc = Get32(&in[24]);
+    version.chunkCount = Get32(&in[28]);
+    manifest.parent = Get32(&in[32]);
+    uint32_t packedSize = Get32(&in[36]);
+    if (body != MANIFEST_HEADER + packedSize || version.sequence != sequence) return false;
+
+    // Parents are older versions, and only so many steps back
+    Manifest parent;
+    if (manifest.parent != 0) {
+        if (manifest.parent >= sequence || hops + 1 >= MANIFEST_KEYFRAME) return false;
+        if (!ReadManifest(dir, manifest.parent, parent, hops + 1)) return false;
+    }
+
+    std::vector<uint8_t> entries((size_t)version.chunkCount * (1 + MANIFEST_ENTRY));
+    uLongf entriesSize = entries.size();
+    if (uncompress(entries.data(), &entriesSize, &in[MANIFEST_HEADER], packedSize) != Z_OK) return false;
+
+    manifest.chunks.resize(version.chunkCount);
+    size_t pos = 0;
+    for (size_t i = 0; i < manifest.chunks.size(); i++) {
+        if (pos >= entriesSize) return false;
+        if (entries[pos++] == ENTRY_FROM_PARENT) {
+            if (i >= parent.chunks.size()) return false;
+            manifest.chunks[i] = parent.chunks[i];
+            continue;
+        }
+        if (pos + MANIFEST_ENTRY > entriesSize) return false;
+        const uint8_t* entry = &entries[pos];
+        manifest.chunks[i] = ChunkRef{Get64(entry), Get32(entry + 8), Get32(entry + 12)};
+        pos += MANIFEST_ENTRY;
+    }
+    return pos == entriesSize;
+}
+
+bool BackupStore::WriteManifest(const std::string& dir, const Manifest& manifest, const Manifest* parent) {
+    // One tag byte per chunk; unchanged runs are zeros and compress away
+    std::vector<uint8_t> entries;
+    entries.reserve(manifest.chunks.size() * (1 + MANIFEST_ENTRY));
+    for (size_t i = 0; i < manifest.chunks.size(); i++) {
+        const ChunkRef& chunk = manifest.chunks[i];
+        if (parent && i < parent->chunks.size() && parent->chunks[i] == chunk) {
+            entries.push_back(ENTRY_FROM_PARENT);
+            continue;
+        }
+        entries.push_back(ENTRY_LITERAL);
+        Put64(entries, chunk.hash);
+        Put32(entries, chunk.crc);
+        Put32(entries, chunk.length);
+    }
+    uLongf packedSize = compressBound(entries.size());
+    std::vector<uint8_t> packed(packedSize);
+    if (compress2(packed.data(), &packedSize, entries.data(), entries.size(), Z_DEFAULT_COMPRESSION) != Z_OK) {
+        return false;
+    }
+
+    std::vector<uint8_t> out;
+    out.reserve(MANIFEST_HEADER + packedSize + 4);
+    out.insert(out.end(), MANIFEST_MAGIC, MANIFEST_MAGIC + 4);
+    Put32(out, MANIFEST_FORMAT);
+    Put32(out, manifest.version.sequence);
+    Put64(out, manifest.version.time);
+    Put32(out, manifest.version.fileSize);
+    Put32(out, manifest.version.fileCrc);
+    Put32(out, manifest.version.chunkCount);
+    Put32(out, parent ? parent->version.sequence : 0);
+    Put32(out, (uint32_t)packedSize);
+    out.insert(out.end(), packed.begin(), packed.begin() + packedSize);
+    Put32(out, Crc32::Update(0, out.data(), out.size()));
+
+    if (!WriteAtomically(dir + "/" + ManifestName(manifest.version.sequence), out)) return false;
+    stats.bytesWritten += out.size();
+    return true;
+}
+
+std::vector<uint32_t> BackupStore::Sequences(const std::string& dir) const {
+    std::vector<uint32_t> sequences;
+    DIR* handle = opendir(dir.c_str());
+    if (!handle) return sequences;
+    while (dirent* entry = readdir(handle)) {
+        unsigned sequence;
+        char suffix[8];
+        if (sscanf(entry->d_name, "%u.%7s", &sequence, suffix) == 2 && std::strcmp(suffix, "man") == 0) {
+            sequences.push_back(sequence);
+        }
+    }
+    closedir(handle);
+    std::sort(sequences.begin(), sequences.end());
+    return sequences;
+}
+
+
+std::vector<BackupVersion> BackupStore::ListVersions(const std::string& savePath) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<BackupVersion> versions;
+    std::string dir = VersionDir(savePath);
+    for (uint32_t sequence : Sequences(dir)) {
+        Manifest manifest;
+        if (ReadManifest(dir, sequence, manifest)) versions.push_back(manifest.version);
+    }
+    return versions;
+}
+
+bool BackupStore::Restore(const std::string& savePath, uint32_t sequence, std::vector<uint8_t>& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Manifest manifest;
+    if (!ReadManifest(VersionDir(savePath), sequence, manifest)) return false;
+
+    out.clear();
+    out.reserve(manifest.version.fileSize);
+    for (const ChunkRef& chunk : manifest.chunks) {
+        uint32_t depth;
+        if (!LoadChunk(chunk, out, &depth)) return false;
+    }
+    return out.size() == manifest.version.fileSize &&
+           Crc32::Update(0, out.data(), out.size()) == manifest.version.fileCrc;
+}
+
+BackupStats BackupStore::GetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
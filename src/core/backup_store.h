@@ -0,0 +1,118 @@
+// backup_store.h - Deduplicated, compressed version history of save files
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "byte_view.h"
+
+struct BackupVersion {
+    uint32_t sequence;      // 1 for the oldest version of a save
+    uint64_t time;          // Seconds since the epoch, when it was stored
+    uint32_t fileSize;
+    uint32_t fileCrc;
+    uint32_t chunkCount;
+};
+
+struct BackupStats {
+    size_t versionsStored = 0;
+    size_t versionsSkipped = 0;     // Identical to the newest stored version
+    size_t chunksWritten = 0;
+    size_t chunksReused = 0;
+    size_t bytesIn = 0;
+    size_t bytesWritten = 0;        // Compressed chunks plus manifests
+};
+
+// Saves are cut into content-defined chunks (a gear rolling hash picks the
+// boundaries, so an edit only changes the chunks around it), each unique
+// chunk is stored once, zlib-compressed, and a version is a small manifest
+// listing its chunks. Successive versions of a save share almost all of
+// them, so a long history costs little more than one compressed copy:
+// - a new chunk is stored as the zlib'd XOR against the previous version's
+//   chunk at the same file offset, which is nearly all zeros;
+// - a manifest only spells out the entries that differ from its parent's.
+// Both chains are cut at a fixed depth so a restore never walks far.
+//
+// Layout under the root directory:
+//   chunks/<2 hex>/<id>.z           "SLMC" | raw length | depth | [base, skip] | zlib
+//   versions/<save key>/<seq>.man   "SLMB" header | zlib'd entries | crc32
+// A chunk id is a 64-bit multiplicative hash plus the CRC-32 of its bytes;
+// restores check every chunk's and the whole file's CRC as well.
+//
+// All methods are thread-safe; one store may serve several save workers.
+class BackupStore {
+public:
+    explicit BackupStore(const std::string& rootDir);
+
+    // Stores the bytes as the newest version of savePath. Returns false on
+    // an I/O error; a version identical to the newest one is not stored
+    // again (and counts as success).
+    bool Backup(const std::string& savePath, ByteView contents);
+
+    // Reads savePath from disk and backs it up; a missing file is fine
+    bool BackupFile(const std::string& savePath);
+
+    // Oldest first
+    std::vector<BackupVersion> ListVersions(const std::string& savePath);
+    bool Restore(const std::string& savePath, uint32_t sequence, std::vector<uint8_t>& out);
+
+    const std::string& GetRoot() const { return root; }
+    BackupStats GetStats();
+
+    // Content-defined chunking bounds
+    static const size_t MIN_CHUNK = 2 * 1024;
+    static const size_t AVG_CHUNK = 8 * 1024;     // Power of two
+    static const size_t MAX_CHUNK = 32 * 1024;
+
+    // Longest chain of XOR deltas, and of manifests relying on a parent
+    static const uint32_t MAX_DELTA_DEPTH = 64;
+    static const uint32_t MANIFEST_KEYFRAME = 32;
+
+    // Raw bytes of recently stored chunks, so the next version's deltas do
+    // not have to replay their chains from disk
+    static const size_t RECENT_CACHE_BYTES = 256 * 1024;
+
+private:
+    struct ChunkRef {
+        uint64_t hash;
+        uint32_t crc;
+        uint32_t length;
+
+        bool operator==(const ChunkRef& other) const {
+            return hash == other.hash && crc == other.crc && length == other.length;
+        }
+    };
+
+    struct Manifest {
+        BackupVersion version;
+        uint32_t parent = 0;            // Sequence the entries are relative to
+        std::vector<ChunkRef> chunks;
+    };
+
+    std::string root;
+    std::mutex mutex;
+    std::unordered_set<std::string> knownChunks;    // Confirmed on disk this session
+    BackupStats stats;
+
+    struct RecentChunk {
+        uint32_t depth;
+        std::vector<uint8_t> bytes;
+    };
+    std::unordered_map<std::string, RecentChunk> recent;
+    std::deque<std::string> recentOrder;            // Oldest first
+    size_t recentBytes = 0;
+
+    std::string VersionDir(const std::string& savePath) const;
+    std::string ChunkPath(const ChunkRef& chunk) const;
+    bool StoreChunk(const ChunkRef& chunk, const uint8_t* bytes, const ChunkRef* base, uint32_t skip);
+    bool LoadChunk(const ChunkRef& chunk, std::vector<uint8_t>& out, uint32_t* depth) const;
+    bool LoadBase(const ChunkRef& chunk, std::vector<uint8_t>& out, uint32_t* depth);
+    void Remember(const std::string& path, uint32_t depth, const uint8_t* bytes, uint32_t length);
+    bool ReadManifest(const std::string& dir, uint32_t sequence, Manifest& manifest, uint32_t hops = 0) const;
+    bool WriteManifest(const std::string& dir, const Manifest& manifest, const Manifest* parent);
+    std::vector<uint32_t> Sequences(const std::string& dir) const;
+};
@@ -0,0 +1,73 @@
+// byte_buffer.cpp - Uninitialised, pooled byte buffer for save data
+#include "byte_buffer.h"
+#include <mutex>
+#include <vector>
+
+namespace {
+
+    struct PooledBuffer {
+        std::unique_ptr<uint8_t[]> buffer;
+        size_t capacity;
+    };
+
+    std::mutex poolMutex;
+    std::vector<PooledBuffer> pool;
+}
+
+void ByteBuffer::resize(size_t size) {
+    if (size > capacity) {
+        Release();
+        buffer = BufferPool::Acquire(size, &capacity);
+    }
+    length = size;
+}
+
+void ByteBuffer::Release() {
+    if (buffer) {
+        BufferPool::Release(std::move(buffer), capacity);
+    }
+    capacity = 0;
+    length = 0;
+}
+
+namespace BufferPool {
+
+    std::unique_ptr<uint8_t[]> Acquire(size_t size, size_t* capacity) {
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+
+            // Smallest pooled buffer that fits
+            size_t best = pool.size();
+            for (size_t i = 0; i < pool.size(); i++) {
+                if (pool[i].capacity >= size &&
+                    (best == pool.size() || pool[i].capacity < pool[best].capacity)) {
+                    best = i;
+                }
+            }
+            if (best < pool.size()) {
+                std::unique_ptr<uint8_t[]> buffer = std::move(pool[best].buffer);
+                *capacity = pool[best].capacity;
+                pool.erase(pool.begin() + best);
+                return buffer;
+            }
+        }
+
+        // Default-initialised: no memset
+        *capacity = size;
+        return std::unique_ptr<uint8_t[]>(new uint8_t[size]);
+    }
+
+    void Release(std::unique_ptr<uint8_t[]> buffer, size_t capacity) {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (pool.size() >= MAX_POOLED) {
+            // Keep the larger buffers; saves only come in three sizes
+            size_t smallest = 0;
+            for (size_t i = 1; i < pool.size(); i++) {
+                if (pool[i].capacity < pool[smallest].capacity) smallest = i;
+            }
+            if (pool[smallest].capacity >= capacity) return;
+            pool.erase(pool.begin() + smallest);
+        }
+        pool.push_back(PooledBuffer{std::move(buffer), capacity});
+    }
+}
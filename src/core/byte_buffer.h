@@ -0,0 +1,49 @@
+// byte_buffer.h - Uninitialised, pooled byte buffer for save data
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "byte_view.h"
+
+// Holds a save's bytes. Resizing does not zero-fill (the bytes are about to
+// be read from disk anyway) and memory comes from a small process-wide pool,
+// so opening saves one after another reuses the same allocation.
+// Lower-case accessors so it drops in where a std::vector<uint8_t> was.
+class ByteBuffer {
+public:
+    ByteBuffer() : capacity(0), length(0) {}
+    ~ByteBuffer() { Release(); }
+
+    ByteBuffer(const ByteBuffer&) = delete;
+    ByteBuffer& operator=(const ByteBuffer&) = delete;
+
+    // Contents after a resize are unspecified, not preserved
+    void resize(size_t size);
+    void Release();
+
+    uint8_t* data() { return buffer.get(); }
+    const uint8_t* data() const { return buffer.get(); }
+    size_t size() const { return length; }
+    uint8_t* begin() { return buffer.get(); }
+    uint8_t* end() { return buffer.get() + length; }
+    const uint8_t* begin() const { return buffer.get(); }
+    const uint8_t* end() const { return buffer.get() + length; }
+    uint8_t& operator[](size_t i) { return buffer[i]; }
+    const uint8_t& operator[](size_t i) const { return buffer[i]; }
+
+    ByteView View() const { return ByteView(buffer.get(), length); }
+
+private:
+    std::unique_ptr<uint8_t[]> buffer;
+    size_t capacity;
+    size_t length;
+};
+
+namespace BufferPool {
+    // Buffers kept for reuse once released; enough for one open save plus
+    // the one being loaded next
+    const size_t MAX_POOLED = 2;
+
+    std::unique_ptr<uint8_t[]> Acquire(size_t size, size_t* capacity);
+    void Release(std::unique_ptr<uint8_t[]> buffer, size_t capacity);
+}
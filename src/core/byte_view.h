@@ -0,0 +1,35 @@
+// byte_view.h - Read-only, non-owning view of a byte range
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Valid only while the owner's buffer is; a SaveFile's view dies on the
+// next Load. operator[] is unchecked, like ByteBuffer's; ReadU32 past the
+// end returns 0, like SaveFile's own readers, and Sub clamps to the view.
+struct ByteView {
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+
+    ByteView() {}
+    ByteView(const uint8_t* b, size_t len) : bytes(b), length(len) {}
+
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    const uint8_t* begin() const { return bytes; }
+    const uint8_t* end() const { return bytes + length; }
+    uint8_t operator[](size_t i) const { return bytes[i]; }
+
+    ByteView Sub(size_t offset, size_t len) const {
+        if (offset > length) offset = length;
+        if (len > length - offset) len = length - offset;
+        return ByteView(bytes + offset, len);
+    }
+
+    uint32_t ReadU32(size_t offset) const {
+        uint32_t value = 0;
+        if (offset <= length && length - offset >= 4) std::memcpy(&value, bytes + offset, 4);
+        return value;
+    }
+};
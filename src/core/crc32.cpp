@@ -0,0 +1,392 @@
+// crc32.cpp - Table-driven, slice-by-N and carry-less-multiply CRC-32 kernels
+#include "crc32.h"
+#include "parallel.h"
+#include <cstring>
+#include <vector>
+#include <zlib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CRC32_HAVE_CLMUL 1
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Slice-by-N kernels assume a little-endian target (Vita and x86 are)"
+#endif
+
+namespace {
+
+    constexpr uint32_t POLY = 0xEDB88320u;
+
+    // t[0] is the classic byte table; t[k][i] advances t[k-1][i] by one more
+    // zero byte, which lets slice-by-N retire N input bytes per lookup round.
+    struct SliceTables {
+        uint32_t t[16][256];
+
+        constexpr SliceTables() : t() {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? (c >> 1) ^ POLY : (c >> 1);
+                }
+                t[0][i] = c;
+            }
+            for (uint32_t i = 0; i < 256; i++) {
+                for (int s = 1; s < 16; s++) {
+                    t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+                }
+            }
+        }
+    };
+
+    constexpr SliceTables TABLES;
+
+    // a(x) * b(x) mod p(x), bit-reflected (zlib's multmodp)
+    constexpr uint32_t MultModP(uint32_t a, uint32_t b) {
+        uint32_t m = 1u << 31;
+        uint32_t p = 0;
+        for (;;) {
+            if (a & m) {
+                p ^= b;
+                if ((a & (m - 1)) == 0) break;
+            }
+            m >>= 1;
+            b = (b & 1) ? (b >> 1) ^ POLY : (b >> 1);
+        }
+        return p;
+    }
+
+    // x2n[k] = x^(2^k) mod p(x)
+    struct PowerTable {
+        uint32_t x2n[32];
+
+        constexpr PowerTable() : x2n() {
+            uint32_t p = 1u << 30;  // x^1
+            x2n[0] = p;
+            for (int n = 1; n < 32; n++) {
+                x2n[n] = p = MultModP(p, p);
+            }
+        }
+    };
+
+    constexpr PowerTable POWERS;
+
+    inline uint32_t Load32(const uint8_t* p) {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    // Raw kernels work on the pre-inverted CRC register.
+    uint32_t RawBytes(uint32_t crc, const uint8_t* p, size_t len) {
+        const auto& t = TABLES.t;
+        while (len--) {
+            crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+    uint32_t RawBitwise(uint32_t crc, const uint8_t* p, size_t len) {
+        while (len--) {
+            crc ^= *p++;
+            for (int j = 0; j < 8; j++) {
+                crc = (crc & 1) ? (crc >> 1) ^ POLY : (crc >> 1);
+            }
+        }
+        return crc;
+    }
+
+    uint32_t RawSlice8(uint32_t crc, const uint8_t* p, size_t len) {
+        const auto& t = TABLES.t;
+        while (len >= 8) {
+            uint32_t one = Load32(p) ^ crc;
+            uint32_t two = Load32(p + 4);
+            crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF] ^
+                  t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24] ^
+                  t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF] ^
+                  t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+            p += 8;
+            len -= 8;
+        }
+        return RawBytes(crc, p, len);
+    }
+
+    uint32_t RawSlice16(uint32_t crc, const uint8_t* p, size_t len) {
+        const auto& t = TABLES.t;
+        while (len >= 16) {
+            uint32_t one = Load32(p) ^ crc;
+            uint32_t two = Load32(p + 4);
+            uint32_t three = Load32(p + 8);
+            uint32_t four = Load32(p + 12);
+            crc = t[15][one & 0xFF] ^ t[14][(one >> 8) & 0xFF] ^
+                  t[13][(one >> 16) & 0xFF] ^ t[12][one >> 24] ^
+                  t[11][two & 0xFF] ^ t[10][(two >> 8) & 0xFF] ^
+                  t[9][(two >> 16) & 0xFF] ^ t[8][two >> 24] ^
+                  t[7][three & 0xFF] ^ t[6][(three >> 8) & 0xFF] ^
+                  t[5][(three >> 16) & 0xFF] ^ t[4][three >> 24] ^
+                  t[3][four & 0xFF] ^ t[2][(four >> 8) & 0xFF] ^
+                  t[1][(four >> 16) & 0xFF] ^ t[0][four >> 24];
+            p += 16;
+            len -= 16;
+        }
+        return RawBytes(crc, p, len);
+    }
+
+#ifdef CRC32_HAVE_CLMUL
+    // Folding with PCLMULQDQ (Gopal et al., "Fast CRC Computation for
+    // Generic Polynomials Using PCLMULQDQ"). Needs len >= 64, len % 16 == 0.
+    __attribute__((target("pclmul,sse4.1")))
+    uint32_t RawClmulBlocks(uint32_t crc, const uint8_t* buf, size_t len) {
+        alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+        alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+        alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+        alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+        __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+        x1 = _mm_loadu_si128((const __m128i*)(buf + 0x00));
+        x2 = _mm_loadu_si128((const __m128i*)(buf + 0x10));
+        x3 = _mm_loadu_si128((const __m128i*)(buf + 0x20));
+        x4 = _mm_loadu_si128((const __m128i*)(buf + 0x30));
+        x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+        x0 = _mm_load_si128((const __m128i*)k1k2);
+        buf += 64;
+        len -= 64;
+
+        // Fold four lanes in parallel
+        while (len >= 64) {
+            x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+            x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+            x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+            x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+            x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+            x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+            x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+            x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+            y5 = _mm_loadu_si128((const __m128i*)(buf + 0x00));
+            y6 = _mm_loadu_si128((const __m128i*)(buf + 0x10));
+            y7 = _mm_loadu_si128((const __m128i*)(buf + 0x20));
+            y8 = _mm_loadu_si128((const __m128i*)(buf + 0x30));
+            x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+            x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+            x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+            x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+            buf += 64;
+            len -= 64;
+        }
+
+        // Fold the four lanes into one
+        x0 = _mm_load_si128((const __m128i*)k3k4);
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+        // Remaining 16-byte blocks
+        while (len >= 16) {
+            x2 = _mm_loadu_si128((const __m128i*)buf);
+            x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+            x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+            x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+            buf += 16;
+            len -= 16;
+        }
+
+        // 128 -> 64 bits
+        x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+        x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+        x1 = _mm_srli_si128(x1, 8);
+        x1 = _mm_xor_si128(x1, x2);
+        x0 = _mm_loadl_epi64((const __m128i*)k5k0);
+        x2 = _mm_srli_si128(x1, 4);
+        x1 = _mm_and_si128(x1, x3);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_xor_si128(x1, x2);
+
+        // Barrett reduction to 32 bits
+        x0 = _mm_load_si128((const __m128i*)poly);
+        x2 = _mm_and_si128(x1, x3);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+        x2 = _mm_and_si128(x2, x3);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x1 = _mm_xor_si128(x1, x2);
+
+        return (uint32_t)_mm_extract_epi32(x1, 1);
+    }
+
+    uint32_t RawClmul(uint32_t crc, const uint8_t* p, size_t len) {
+        if (len >= 64) {
+            size_t blocks = len & ~(size_t)15;
+            crc = RawClmulBlocks(crc, p, blocks);
+            p += blocks;
+            len -= blocks;
+        }
+        return RawSlice16(crc, p, len);
+    }
+#endif
+
+    uint32_t UpdateBitwise(uint32_t crc, const uint8_t* p, size_t len) {
+        return ~RawBitwise(~crc, p, len);
+    }
+
+    uint32_t UpdateSlice8(uint32_t crc, const uint8_t* p, size_t len) {
+        return ~RawSlice8(~crc, p, len);
+    }
+
+    uint32_t UpdateSlice16(uint32_t crc, const uint8_t* p, size_t len) {
+        return ~RawSlice16(~crc, p, len);
+    }
+
+#ifdef CRC32_HAVE_CLMUL
+    uint32_t UpdateClmul(uint32_t crc, const uint8_t* p, size_t len) {
+        return ~RawClmul(~crc, p, len);
+    }
+#endif
+
+    uint32_t UpdateZlib(uint32_t crc, const uint8_t* p, size_t len) {
+        // zlib takes a uInt length; feed oversized spans in pieces
+        const size_t MAX_CHUNK = 1u << 30;
+        while (len > 0) {
+            size_t n = len < MAX_CHUNK ? len : MAX_CHUNK;
+            crc = (uint32_t)crc32(crc, p, (uInt)n);
+            p += n;
+            len -= n;
+        }
+        return crc;
+    }
+
+    using UpdateFn = uint32_t (*)(uint32_t, const uint8_t*, size_t);
+
+    UpdateFn FunctionFor(Crc32::Kernel kernel) {
+        switch (kernel) {
+            case Crc32::Kernel::BITWISE:     return UpdateBitwise;
+            case Crc32::Kernel::SLICE_BY_8:  return UpdateSlice8;
+            case Crc32::Kernel::SLICE_BY_16: return UpdateSlice16;
+#ifdef CRC32_HAVE_CLMUL
+            case Crc32::Kernel::CLMUL:       return UpdateClmul;
+#endif
+            case Crc32::Kernel::ZLIB:        return UpdateZlib;
+            default:                         return nullptr;
+        }
+    }
+
+    Crc32::Kernel BestKernel() {
+        if (Crc32::IsSupported(Crc32::Kernel::CLMUL)) {
+            return Crc32::Kernel::CLMUL;
+        }
+#if defined(__arm__) || defined(__aarch64__)
+        // Cortex-A9 has a 32 KB L1D; the 16 KB slice-by-16 tables would
+        // compete with the save buffer for it
+        return Crc32::Kernel::SLICE_BY_8;
+#else
+        return Crc32::Kernel::SLICE_BY_16;
+#endif
+    }
+
+    struct Dispatch {
+        Crc32::Kernel kernel;
+        UpdateFn fn;
+    };
+
+    Dispatch& Active() {
+        static Dispatch dispatch = {BestKernel(), FunctionFor(BestKernel())};
+        return dispatch;
+    }
+}
+
+namespace Crc32 {
+
+    uint32_t Update(uint32_t crc, const uint8_t* data, size_t len) {
+        return Active().fn(crc, data, len);
+    }
+
+    uint32_t Update(Kernel kernel, uint32_t crc, const uint8_t* data, size_t len) {
+        if (kernel == Kernel::AUTO || !IsSupported(kernel)) {
+            return Update(crc, data, len);
+        }
+        return FunctionFor(kernel)(crc, data, len);
+    }
+
+    uint32_t UpdateParallel(uint32_t crc, const uint8_t* data, size_t len, int threads) {
+        std::vector<uint32_t> parts(threads > 1 ? threads : 1);
+        std::vector<size_t> lengths(parts.size());
+
+        int chunks = Parallel::ForChunks(len, PARALLEL_MIN_CHUNK, threads,
+            [&](int chunk, size_t begin, size_t end) {
+                parts[chunk] = Update(0, data + begin, end - begin);
+                lengths[chunk] = end - begin;
+            });
+
+        for (int i = 0; i < chunks; i++) {
+            crc = Combine(crc, parts[i], lengths[i]);
+        }
+        return crc;
+    }
+
+    uint32_t MakeCombineOp(size_t lenB) {
+        // x^(8 * lenB) mod p(x)
+        uint32_t p = 1u << 31;  // x^0
+        unsigned k = 3;
+        while (lenB) {
+            if (lenB & 1) p = MultModP(POWERS.x2n[k & 31], p);
+            lenB >>= 1;
+            k++;
+        }
+        return p;
+    }
+
+    uint32_t CombineWithOp(uint32_t crcA, uint32_t crcB, uint32_t op) {
+        return MultModP(op, crcA) ^ crcB;
+    }
+
+    uint32_t Combine(uint32_t crcA, uint32_t crcB, size_t lenB) {
+        return CombineWithOp(crcA, crcB, MakeCombineOp(lenB));
+    }
+
+    bool IsSupported(Kernel kernel) {
+        switch (kernel) {
+            case Kernel::AUTO:
+            case Kernel::BITWISE:
+            case Kernel::SLICE_BY_8:
+            case Kernel::SLICE_BY_16:
+            case Kernel::ZLIB:
+                return true;
+            case Kernel::CLMUL:
+#ifdef CRC32_HAVE_CLMUL
+                return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#else
+                return false;
+#endif
+            default:
+                return false;
+        }
+    }
+
+    const char* KernelName(Kernel kernel) {
+        switch (kernel) {
+            case Kernel::AUTO:        return "auto";
+            case Kernel::BITWISE:     return "bitwise";
+            case Kernel::SLICE_BY_8:  return "slice-by-8";
+            case Kernel::SLICE_BY_16: return "slice-by-16";
+            case Kernel::CLMUL:       return "clmul";
+            case Kernel::ZLIB:        return "zlib";
+            default:                  return "unknown";
+        }
+    }
+
+    Kernel ActiveKernel() {
+        return Active().kernel;
+    }
+
+    void SetKernel(Kernel kernel) {
+        if (kernel == Kernel::AUTO || !IsSupported(kernel)) {
+            kernel = BestKernel();
+        }
+        Active() = {kernel, FunctionFor(kernel)};
+    }
+}
@@ -0,0 +1,41 @@
+// crc32.h - Pluggable CRC-32 engine (zlib-compatible polynomial 0xEDB88320)
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Crc32 {
+
+    enum class Kernel {
+        AUTO = 0,       // Best kernel the running CPU supports
+        BITWISE,        // Original bit-at-a-time loop, kept as a baseline
+        SLICE_BY_8,     // 8 KB of tables, friendliest to small L1 caches (Vita)
+        SLICE_BY_16,    // 16 KB of tables, fastest portable kernel on hosts
+        CLMUL,          // x86 PCLMULQDQ folding, runtime-detected
+        ZLIB,           // zlib's crc32(), used as the reference
+        COUNT
+    };
+
+    // CRC state is the finished zlib-style value: start from 0 and feed
+    // spans in order, e.g. Update(Update(0, a, n), b, m) == crc32(a ++ b).
+    uint32_t Update(uint32_t crc, const uint8_t* data, size_t len);
+    uint32_t Update(Kernel kernel, uint32_t crc, const uint8_t* data, size_t len);
+
+    // Hashes len bytes as up to `threads` chunks on worker threads and merges
+    // the partial CRCs with Combine. Small buffers stay on one thread.
+    uint32_t UpdateParallel(uint32_t crc, const uint8_t* data, size_t len, int threads);
+    static const size_t PARALLEL_MIN_CHUNK = 256 * 1024;
+
+    // CRC of A ++ B from crc(A), crc(B) and B's length (zlib crc32_combine).
+    // For repeated merges over equal lengths, build the operator once.
+    uint32_t Combine(uint32_t crcA, uint32_t crcB, size_t lenB);
+    uint32_t MakeCombineOp(size_t lenB);
+    uint32_t CombineWithOp(uint32_t crcA, uint32_t crcB, uint32_t op);
+
+    bool IsSupported(Kernel kernel);
+    const char* KernelName(Kernel kernel);
+
+    // Kernel used by Update(crc, data, len). Setting AUTO or an unsupported
+    // kernel falls back to the runtime-detected best choice.
+    Kernel ActiveKernel();
+    void SetKernel(Kernel kernel);
+}
@@ -0,0 +1,82 @@
+// dir_cache.cpp - LRU cache of directory listings, revalidated by directory mtime
+#include "dir_cache.h"
+#include <iterator>
+
+DirCache::DirCache(size_t budgetBytes) : budget(budgetBytes), bytes(0) {
+}
+
+bool DirCache::ReadStamp(const std::string& path, uint64_t& stamp) {
+    FileEntry info;
+    if (!StatEntry(path, info) || !info.isDirectory) return false;
+    stamp = info.stamp;
+    return true;
+}
+
+size_t DirCache::Cost(const std::string& path, const std::vector<FileEntry>& entries) {
+    size_t cost = sizeof(Listing) + path.size() * 2;        // Listing and map key
+    for (const FileEntry& entry : entries) {
+        cost += sizeof(FileEntry) + entry.name.size() + entry.fullPath.size();
+    }
+    return cost;
+}
+
+bool DirCache::Lookup(const std::string& path, uint64_t stamp, std::vector<FileEntry>& out) {
+    auto found = byPath.find(path);
+    if (found == byPath.end()) {
+        stats.misses++;
+        return false;
+    }
+    Position listing = found->second;
+    if (listing->stamp != stamp || !Revalidate(*listing)) {
+        stats.stale++;
+        Remove(listing);
+        return false;
+    }
+
+    stats.hits++;
+    order.splice(order.begin(), order, listing);
+    out.insert(out.end(), listing->entries.begin(), listing->entries.end());
+    return true;
+}
+
+bool DirCache::Revalidate(Listing& listing) {
+    // The names are those scanned; sizes and times may have moved. An entry
+    // that is gone or changed kind means the stamp missed something.
+    FileEntry now;
+    for (FileEntry& entry : listing.entries) {
+        if (!StatEntry(entry.fullPath, now) || now.isDirectory != entry.isDirectory) return false;
+        if (now.size != entry.size || now.stamp != entry.stamp) {
+            entry.size = now.size;
+            entry.stamp = now.stamp;
+            stats.refreshed++;
+        }
+    }
+    return true;
+}
+
+void DirCache::Store(const std::string& path, uint64_t stamp, std::vector<FileEntry> entries) {
+    Invalidate(path);
+
+    size_t cost = Cost(path, entries);
+    if (cost > budget) return;
+
+    while (bytes + cost > budget && !order.empty()) {
+        Remove(std::prev(order.end()));
+        stats.evictions++;
+    }
+
+    order.push_front(Listing{path, stamp, std::move(entries), cost});
+    byPath[path] = order.begin();
+    bytes += cost;
+}
+
+void DirCache::Invalidate(const std::string& path) {
+    auto found = byPath.find(path);
+    if (found != byPath.end()) Remove(found->second);
+}
+
+void DirCache::Remove(Position position) {
+    bytes -= position->bytes;
+    byPath.erase(position->path);
+    order.erase(position);
+}
@@ -0,0 +1,66 @@
+// dir_cache.h - LRU cache of directory listings, revalidated by directory mtime
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "dir_scanner.h"
+
+// Keeps the listings of recently visited directories so showing one again,
+// going back up the tree or refreshing, needs no directory read. The
+// directory's modification time says whether entries were added, removed
+// or renamed; a listing is stored with the stamp read before its scan
+// started, so one touched during the scan is read again next time. That
+// time doesn't move when a file inside is rewritten, so a hit also stats
+// each entry and takes its current size and time into the listing.
+//
+// Listings are charged roughly what they hold in memory; the least
+// recently used are dropped to stay within the budget, and a listing
+// bigger than the whole budget is not kept at all.
+class DirCache {
+public:
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;          // Not cached
+        size_t stale = 0;           // Cached, but the directory changed since
+        size_t refreshed = 0;       // Entries of a hit whose size or time moved
+        size_t evictions = 0;
+    };
+
+    explicit DirCache(size_t budgetBytes);
+
+    // Directory modification time, packed so that later is larger; false
+    // if the directory can't be read
+    static bool ReadStamp(const std::string& path, uint64_t& stamp);
+
+    // Appends the cached listing of path to out if it was stored with this
+    // stamp and its entries are all still there; otherwise drops it
+    bool Lookup(const std::string& path, uint64_t stamp, std::vector<FileEntry>& out);
+
+    void Store(const std::string& path, uint64_t stamp, std::vector<FileEntry> entries);
+    void Invalidate(const std::string& path);
+
+    size_t GetBytes() const { return bytes; }
+    const Stats& GetStats() const { return stats; }
+
+private:
+    struct Listing {
+        std::string path;
+        uint64_t stamp;
+        std::vector<FileEntry> entries;
+        size_t bytes;
+    };
+    typedef std::list<Listing>::iterator Position;
+
+    static size_t Cost(const std::string& path, const std::vector<FileEntry>& entries);
+    bool Revalidate(Listing& listing);
+    void Remove(Position position);
+
+    size_t budget;
+    size_t bytes;
+    std::list<Listing> order;                       // Most recently used first
+    std::unordered_map<std::string, Position> byPath;
+    Stats stats;
+};
@@ -0,0 +1,197 @@
+// dir_scanner.cpp - Background directory listing, streamed to the UI in batches
+#include "dir_scanner.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#ifdef __vita__
+#include <psp2/io/dirent.h>
+#include <psp2/io/stat.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+const char* const PARENT_ENTRY_NAME = ".. (Parent Directory)";
+
+bool EntryBefore(const FileEntry& a, const FileEntry& b) {
+    bool aParent = a.name == PARENT_ENTRY_NAME;
+    bool bParent = b.name == PARENT_ENTRY_NAME;
+    if (aParent != bParent) return aParent;
+    if (a.isDirectory != b.isDirectory) return a.isDirectory;
+    return a.name < b.name;
+}
+
+#ifdef __vita__
+static uint64_t PackTime(const SceDateTime& t) {
+    return ((uint64_t)t.year << 48) | ((uint64_t)t.month << 44) | ((uint64_t)t.day << 39) |
+           ((uint64_t)t.hour << 34) | ((uint64_t)t.minute << 28) | ((uint64_t)t.second << 22) |
+           ((uint64_t)t.microsecond & 0xFFFFF);
+}
+
+static void FromStat(const SceIoStat& info, FileEntry& entry) {
+    entry.isDirectory = SCE_S_ISDIR(info.st_mode);
+    entry.size = (size_t)info.st_size;
+    entry.stamp = PackTime(info.st_mtime);
+}
+#else
+static void FromStat(const struct stat& info, FileEntry& entry) {
+    entry.isDirectory = S_ISDIR(info.st_mode);
+    entry.size = (size_t)info.st_size;
+    entry.stamp = (uint64_t)info.st_mtim.tv_sec * 1000000000ull + (uint64_t)info.st_mtim.tv_nsec;
+}
+#endif
+
+bool StatEntry(const std::string& path, FileEntry& entry) {
+#ifdef __vita__
+    SceIoStat info;
+    if (sceIoGetstat(path.c_str(), &info) < 0) return false;
+#else
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return false;
+#endif
+    FromStat(info, entry);
+    return true;
+}
+
+DirScanner::DirScanner()
+    : generation(0), stopping(false), requested(false), status(ScanStatus::IDLE) {
+    thread = std::thread(&DirScanner::ThreadMain, this);
+}
+
+DirScanner::~DirScanner() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        generation++;
+    }
+    wake.notify_all();
+    thread.join();
+}
+
+void DirScanner::Start(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        generation++;
+        requested = true;
+        requestPath = path;
+        ready.clear();
+        status = ScanStatus::SCANNING;
+    }
+    wake.notify_one();
+}
+
+void DirScanner::Cancel() {
+    std::lock_guard<std::mutex> lock(mutex);
+    generation++;
+    requested = false;
+    ready.clear();
+    status = ScanStatus::IDLE;
+}
+
+ScanStatus DirScanner::Poll(std::vector<FileEntry>& arrived) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (arrived.empty()) {
+        arrived.swap(ready);
+    } else {
+        arrived.insert(arrived.end(), std::make_move_iterator(ready.begin()), std::make_move_iterator(ready.end()));
+    }
+    ready.clear();
+    return status;
+}
+
+void DirScanner::ThreadMain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return stopping || requested; });
+        if (stopping) return;
+
+        uint32_t scan = generation.load();
+        std::string path = requestPath;
+        requested = false;
+
+        lock.unlock();
+        bool opened = Scan(scan, path);
+        lock.lock();
+
+        // A scan that was superseded has nothing left to report
+        if (generation.load() == scan) {
+            status = opened ? ScanStatus::DONE : ScanStatus::FAILED;
+        }
+    }
+}
+
+bool DirScanner::Deliver(uint32_t scan, std::vector<FileEntry>& batch) {
+    // Sorting happens here, off the lock and off the UI thread
+    std::sort(batch.begin(), batch.end(), EntryBefore);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    bool current = generation.load() == scan;
+    if (current) {
+        size_t middle = ready.size();
+        ready.insert(ready.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+        std::inplace_merge(ready.begin(), ready.begin() + middle, ready.end(), EntryBefore);
+    }
+    batch.clear();
+    return current;
+}
+
+bool DirScanner::Scan(uint32_t scan, const std::string& path) {
+    typedef std::chrono::steady_clock Clock;
+    std::vector<FileEntry> batch;
+    size_t batchSize = FIRST_BATCH;
+    Clock::time_point lastDelivery = Clock::now();
+    Clock::duration flushAfter = std::chrono::milliseconds((int)FLUSH_MS);
+
+    // False once the scan is cancelled
+    auto add = [&](FileEntry& entry) {
+        batch.push_back(std::move(entry));
+
+        Clock::time_point now = Clock::now();
+        if (batch.size() < batchSize && now - lastDelivery < flushAfter) {
+            return true;
+        }
+        lastDelivery = now;
+        batchSize = batchSize * 2 < MAX_BATCH ? batchSize * 2 : MAX_BATCH;
+        return Deliver(scan, batch);
+    };
+
+#ifdef __vita__
+    // sceIoDread returns each entry's stat with it, no separate call needed
+    SceUID dir = sceIoDopen(path.c_str());
+    if (dir < 0) return false;
+
+    SceIoDirent dirent;
+    while (generation.load(std::memory_order_relaxed) == scan && sceIoDread(dir, &dirent) > 0) {
+        if (dirent.d_name[0] == '.') continue;
+        FileEntry entry;
+        entry.name = dirent.d_name;
+        entry.fullPath = path + "/" + dirent.d_name;
+        FromStat(dirent.d_stat, entry);
+        if (!add(entry)) break;
+    }
+    sceIoDclose(dir);
+#else
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return false;
+
+    while (generation.load(std::memory_order_relaxed) == scan) {
+        dirent* entry = readdir(dir);
+        if (!entry) break;
+        if (entry->d_name[0] == '.') continue;
+
+        FileEntry file;
+        file.name = entry->d_name;
+        file.fullPath = path + "/" + entry->d_name;
+        if (!StatEntry(file.fullPath, file)) {
+            file.isDirectory = false;
+            file.size = 0;
+            file.stamp = 0;
+        }
+        if (!add(file)) break;
+    }
+    closedir(dir);
+#endif
+
+    Deliver(scan, batch);
+    return true;
+}
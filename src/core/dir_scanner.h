@@ -0,0 +1,82 @@
+// dir_scanner.h - Background directory listing, streamed to the UI in batches
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct FileEntry {
+    std::string name;
+    std::string fullPath;
+    bool isDirectory;
+    size_t size;
+    uint64_t stamp;         // Modification time, packed so that later is larger
+};
+
+enum class ScanStatus {
+    IDLE,           // Nothing started
+    SCANNING,
+    DONE,
+    FAILED          // The directory could not be opened
+};
+
+// Name of the synthetic ".." entry the browser puts at the top
+extern const char* const PARENT_ENTRY_NAME;
+
+// Listing order: the parent entry, then directories, then files, each by name
+bool EntryBefore(const FileEntry& a, const FileEntry& b);
+
+// Fills in isDirectory, size and stamp for path; false if it can't be read
+bool StatEntry(const std::string& path, FileEntry& entry);
+
+// Reads one directory at a time on its own thread. Entries are handed over
+// in batches that start at FIRST_BATCH and double up to MAX_BATCH, and any
+// partial batch older than FLUSH_MS goes over anyway, so the first rows can
+// be shown within a frame even on a slow card. Only the UI thread calls the
+// public methods. The worker sorts each batch (EntryBefore) and merges it
+// into what is waiting, so the UI only has to merge one sorted run per
+// frame into its list.
+//
+// Starting a new scan cancels the one in progress: the worker notices
+// between reads, closes the directory and drops what it had not handed
+// over, and nothing from the old scan is returned by Poll after Start.
+class DirScanner {
+public:
+    DirScanner();
+    ~DirScanner();
+
+    DirScanner(const DirScanner&) = delete;
+    DirScanner& operator=(const DirScanner&) = delete;
+
+    void Start(const std::string& path);
+    void Cancel();
+
+    // Appends entries read since the last call, sorted by EntryBefore, and
+    // returns the state of the current scan
+    ScanStatus Poll(std::vector<FileEntry>& arrived);
+
+    static const size_t FIRST_BATCH = 8;
+    static const size_t MAX_BATCH = 256;
+    static const int FLUSH_MS = 8;
+
+private:
+    void ThreadMain();
+    bool Scan(uint32_t scan, const std::string& path);
+    bool Deliver(uint32_t scan, std::vector<FileEntry>& batch);
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::atomic<uint32_t> generation;       // Bumped by Start and Cancel
+
+    // Guarded by mutex
+    bool stopping;
+    bool requested;                         // A scan of requestPath is waiting
+    std::string requestPath;
+    std::vector<FileEntry> ready;           // Sorted
+    ScanStatus status;
+};
@@ -0,0 +1,174 @@
+// edit_journal.cpp - Bounded undo/redo history of byte edits
+#include "edit_journal.h"
+#include <cstring>
+
+EditJournal::EditJournal(size_t arenaBytes, size_t maxEntries)
+    : arena(arenaBytes), entries(maxEntries), head(0), count(0), cursor(0), arenaTail(0),
+      nextTxn(1), openTxn(0), openKey(0), depth(0), discarding(false), lastTxn(0), lastKey(0) {
+}
+
+void EditJournal::Clear() {
+    head = 0;
+    count = 0;
+    cursor = 0;
+    arenaTail = 0;
+    lastTxn = 0;
+    lastKey = 0;
+}
+
+void EditJournal::BeginTransaction(uint32_t mergeKey) {
+    if (depth++ > 0) return;
+
+    discarding = false;
+    openKey = mergeKey;
+
+    // Keep adding to the previous transaction if it is the same kind of edit
+    // and is still the newest thing in the history
+    bool merge = mergeKey != 0 && mergeKey == lastKey && lastTxn != 0 &&
+                 cursor == count && cursor > 0 && At(cursor - 1).txn == lastTxn;
+    if (merge) {
+        openTxn = lastTxn;
+    } else {
+        openTxn = nextTxn++;
+        if (nextTxn == 0) nextTxn = 1;
+    }
+}
+
+void EditJournal::EndTransaction() {
+    if (depth > 0) depth--;
+}
+
+void EditJournal::Record(uint32_t offset, const uint8_t* oldBytes, const uint8_t* newBytes, uint32_t length) {
+    if (depth == 0) {
+        BeginTransaction();
+        Record(offset, oldBytes, newBytes, length);
+        EndTransaction();
+        return;
+    }
+    if (discarding || length == 0) return;
+
+    DropRedo();
+
+    // Merged edits to a range already in this transaction only move its "new" side
+    for (size_t i = count; i > 0 && At(i - 1).txn == openTxn; i--) {
+        Entry& entry = At(i - 1);
+        if (entry.offset == offset && entry.length == length) {
+            std::memcpy(&arena[entry.arenaPos + length], newBytes, length);
+            return;
+        }
+    }
+
+    uint32_t pos;
+    if (!Allocate(length * 2, &pos)) return;
+
+    std::memcpy(&arena[pos], oldBytes, length);
+    std::memcpy(&arena[pos + length], newBytes, length);
+    arenaTail = pos + length * 2;
+
+    Entry& entry = At(count);
+    entry.offset = offset;
+    entry.length = length;
+    entry.arenaPos = pos;
+    entry.txn = openTxn;
+    count++;
+    cursor = count;
+
+    lastTxn = openTxn;
+    lastKey = openKey;
+}
+
+bool EditJournal::Undo(const ApplyFn& apply) {
+    if (cursor == 0) return false;
+
+    uint32_t txn = At(cursor - 1).txn;
+    while (cursor > 0 && At(cursor - 1).txn == txn) {
+        const Entry& entry = At(cursor - 1);
+        apply(entry.offset, &arena[entry.arenaPos], entry.length);
+        cursor--;
+    }
+
+    lastTxn = 0;
+    return true;
+}
+
+bool EditJournal::Redo(const ApplyFn& apply) {
+    if (cursor == count) return false;
+
+    uint32_t txn = At(cursor).txn;
+    while (cursor < count && At(cursor).txn == txn) {
+        const Entry& entry = At(cursor);
+        apply(entry.offset, &arena[entry.arenaPos + entry.length], entry.length);
+        cursor++;
+    }
+
+    lastTxn = 0;
+    return true;
+}
+
+bool EditJournal::Allocate(uint32_t bytes, uint32_t* pos) {
+    if (bytes >= arena.size()) {
+        // Could never fit; an edit this large is simply not undoable
+        Clear();
+        discarding = true;
+        return false;
+    }
+
+    for (;;) {
+        if (count == 0) {
+            *pos = 0;
+            return true;
+        }
+
+        if (count < entries.size()) {
+            // Free space runs from the tail up to the oldest entry's bytes,
+            // wrapping once at the end of the arena. Allocations stop short of
+            // the oldest entry, so the tail only meets it when nothing is held.
+            uint32_t oldest = At(0).arenaPos;
+            uint32_t size = (uint32_t)arena.size();
+            if (arenaTail >= oldest) {
+                if (bytes <= size - arenaTail) {
+                    *pos = arenaTail;
+                    return true;
+                }
+                if (bytes < oldest) {
+                    *pos = 0;
+                    return true;
+                }
+            } else if (bytes < oldest - arenaTail) {
+                *pos = arenaTail;
+                return true;
+            }
+        }
+
+        if (At(0).txn == openTxn) {
+            // Dropping the start of the open transaction would leave half of
+            // it undoable; forget the whole history instead
+            Clear();
+            discarding = true;
+            return false;
+        }
+        DropOldestTransaction();
+    }
+}
+
+void EditJournal::DropOldestTransaction() {
+    uint32_t txn = At(0).txn;
+    while (count > 0 && At(0).txn == txn) {
+        head = (head + 1) % entries.size();
+        count--;
+        if (cursor > 0) cursor--;
+    }
+    if (count == 0) Clear();
+}
+
+void EditJournal::DropRedo() {
+    if (cursor == count) return;
+
+    count = cursor;
+    if (count == 0) {
+        arenaTail = 0;
+    } else {
+        const Entry& last = At(count - 1);
+        arenaTail = last.arenaPos + last.length * 2;
+    }
+}
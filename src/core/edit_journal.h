@@ -0,0 +1,69 @@
+// edit_journal.h - Bounded undo/redo history of byte edits
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Every edit is stored as (offset, old bytes, new bytes) in a fixed-size
+// byte ring; the entry descriptors live in a second fixed-size ring. When
+// either fills up, the oldest whole transaction is dropped, so memory stays
+// the same however long the session runs. Undo and redo only touch the
+// bytes of the transaction they replay.
+class EditJournal {
+public:
+    typedef std::function<void(uint32_t offset, const uint8_t* bytes, uint32_t length)> ApplyFn;
+
+    explicit EditJournal(size_t arenaBytes = 64 * 1024, size_t maxEntries = 4096);
+
+    void Clear();
+
+    // Edits recorded between Begin and End undo as one step. Nesting is
+    // allowed; only the outermost pair counts. A transaction whose non-zero
+    // mergeKey matches the one right before it (with nothing undone since)
+    // is folded into it, keeping the oldest "old" bytes of each range.
+    void BeginTransaction(uint32_t mergeKey = 0);
+    void EndTransaction();
+
+    // Edits outside a transaction become a transaction of their own
+    void Record(uint32_t offset, const uint8_t* oldBytes, const uint8_t* newBytes, uint32_t length);
+
+    bool CanUndo() const { return cursor > 0; }
+    bool CanRedo() const { return cursor < count; }
+
+    // Replays one transaction through apply, newest entry first for undo
+    bool Undo(const ApplyFn& apply);
+    bool Redo(const ApplyFn& apply);
+
+private:
+    struct Entry {
+        uint32_t offset;
+        uint32_t length;
+        uint32_t arenaPos;      // old bytes, then new bytes
+        uint32_t txn;
+    };
+
+    Entry& At(size_t index) { return entries[(head + index) % entries.size()]; }
+    const Entry& At(size_t index) const { return entries[(head + index) % entries.size()]; }
+
+    bool Allocate(uint32_t bytes, uint32_t* pos);
+    void DropOldestTransaction();
+    void DropRedo();
+
+    std::vector<uint8_t> arena;
+    std::vector<Entry> entries;
+
+    size_t head;        // Oldest entry
+    size_t count;       // Entries held, applied or not
+    size_t cursor;      // Entries [0, cursor) are applied; the rest are redo
+    uint32_t arenaTail; // Next free arena byte
+
+    uint32_t nextTxn;
+    uint32_t openTxn;
+    uint32_t openKey;
+    int depth;
+    bool discarding;    // The open transaction outgrew the journal
+
+    // The most recent transaction, if it is still on top and may be merged into
+    uint32_t lastTxn;
+    uint32_t lastKey;
+};
@@ -0,0 +1,149 @@
+// field_presets.cpp - Named bulk edits over a game's field tables
+#include "field_presets.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+    int SetInt(SaveFile& save, uint32_t offset, int32_t value) {
+        if (offset == 0 || save.ReadInt32(offset) == value) return 0;
+        save.WriteInt32(offset, value);
+        return 1;
+    }
+
+    int SetFlag(SaveFile& save, uint32_t offset, uint8_t bit, bool value) {
+        if (offset == 0 || save.ReadBool(offset, bit) == value) return 0;
+        save.WriteBool(offset, value, bit);
+        return 1;
+    }
+
+    int MaxAmmo(SaveFile& save, const GameData& game) {
+        int changed = 0;
+        for (const GameWeapon& weapon : game.weapons) {
+            changed += SetInt(save, weapon.ammo_offset, weapon.max_ammo);
+        }
+        return changed;
+    }
+
+    int MaxBolts(SaveFile& save, const GameData& game) {
+        int changed = 0;
+        for (const GameValue& value : game.values) {
+            if (std::strcmp(value.name, "Bolts") == 0) {
+                changed += SetInt(save, value.offset, value.max_value);
+            }
+        }
+        return changed;
+    }
+
+    int MaxValues(SaveFile& save, const GameData& game) {
+        int changed = 0;
+        for (const GameValue& value : game.values) changed += SetInt(save, value.offset, value.max_value);
+        return changed;
+    }
+
+    int MaxExp(SaveFile& save, const GameData& game) {
+        int changed = 0;
+        for (const GameValue& value : game.extra_values) changed += SetInt(save, value.offset, value.max_value);
+        return changed;
+    }
+
+    int UnlockGadgets(SaveFile& save, const GameData& game) {
+        int changed = 0;
+        for (const GameGadget& gadget : game.gadgets) {
+            changed += SetFlag(save, gadget.offset, gadget.bit_index, true);
+        }
+        return changed;
+    }
+
+    int UnlockAll(SaveFile& save, const GameData& game) {
+        int changed = UnlockGadgets(save, game);
+        for (const GameUnlockable& unlockable : game.unlockables) {
+            changed += SetFlag(save, unlockable.offset, unlockable.bit_index, true);
+        }
+        return changed;
+    }
+
+    const FieldPreset PRESETS[] = {
+        {"max-ammo", "Fill every weapon to its max ammo", MaxAmmo},
+        {"max-bolts", "Set bolts to the maximum", MaxBolts},
+        {"max-values", "Set every value (bolts, raritanium...) to its maximum", MaxValues},
+        {"max-exp", "Max every weapon's experience (RC3)", MaxExp},
+        {"unlock-gadgets", "Own every gadget", UnlockGadgets},
+        {"unlock-all", "Own every gadget and unlockable", UnlockAll},
+    };
+
+    bool SameName(const char* a, const std::string& b) {
+        size_t length = std::strlen(a);
+        if (length != b.size()) return false;
+        for (size_t i = 0; i < length; i++) {
+            if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i])) return false;
+        }
+        return true;
+    }
+
+    std::string Trim(const std::string& text) {
+        size_t begin = text.find_first_not_of(" \t");
+        size_t end = text.find_last_not_of(" \t");
+        return begin == std::string::npos ? std::string() : text.substr(begin, end - begin + 1);
+    }
+}
+
+namespace FieldPresets {
+
+    const FieldPreset* Find(const std::string& name) {
+        for (const FieldPreset& preset : PRESETS) {
+            if (SameName(preset.name, name)) return &preset;
+        }
+        return nullptr;
+    }
+
+    TableView<FieldPreset> All() {
+        return TableView<FieldPreset>(PRESETS);
+    }
+
+    int Apply(const std::string& name, SaveFile& save, const GameData& game) {
+        const FieldPreset* preset = Find(name);
+        if (!preset) return -1;
+
+        save.BeginTransaction();
+        int changed = preset->apply(save, game);
+        save.EndTransaction();
+        return changed;
+    }
+
+    int SetField(const std::string& assignment, SaveFile& save, const GameData& game) {
+        size_t equals = assignment.find('=');
+        if (equals == std::string::npos) return -1;
+
+        std::string name = Trim(assignment.substr(0, equals));
+        std::string text = Trim(assignment.substr(equals + 1));
+        char* end = nullptr;
+        long parsed = std::strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0') return -1;
+
+        auto clamp = [parsed](int32_t minValue, int32_t maxValue) {
+            return (int32_t)std::max<long>(minValue, std::min<long>(maxValue, parsed));
+        };
+
+        for (const GameValue& value : game.values) {
+            if (SameName(value.name, name)) return SetInt(save, value.offset, clamp(value.min_value, value.max_value));
+        }
+        for (const GameValue& value : game.extra_values) {
+            if (SameName(value.name, name)) return SetInt(save, value.offset, clamp(value.min_value, value.max_value));
+        }
+        for (const GameWeapon& weapon : game.weapons) {
+            if (SameName(weapon.name, name)) return SetInt(save, weapon.ammo_offset, clamp(weapon.min_ammo, weapon.max_ammo));
+        }
+        for (const GameGadget& gadget : game.gadgets) {
+            if (SameName(gadget.name, name)) return SetFlag(save, gadget.offset, gadget.bit_index, parsed != 0);
+        }
+        for (const GameUnlockable& unlockable : game.unlockables) {
+            if (SameName(unlockable.name, name)) {
+                return SetFlag(save, unlockable.offset, unlockable.bit_index, parsed != 0);
+            }
+        }
+        return -1;
+    }
+}
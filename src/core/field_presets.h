@@ -0,0 +1,26 @@
+// field_presets.h - Named bulk edits over a game's field tables
+#pragma once
+#include <string>
+#include "save_file.h"
+#include "../data/rac_vita_games_data.h"
+
+struct FieldPreset {
+    const char* name;
+    const char* description;
+    int (*apply)(SaveFile& save, const GameData& game);    // Returns fields changed
+};
+
+namespace FieldPresets {
+    const FieldPreset* Find(const std::string& name);
+    TableView<FieldPreset> All();
+
+    // Applies one preset as a single undo step; returns fields changed,
+    // or -1 if no preset has that name
+    int Apply(const std::string& name, SaveFile& save, const GameData& game);
+
+    // "Field Name=value", matched case-insensitively against every table of
+    // the game; values are clamped to the field's range, flags take 0/1.
+    // Returns 1 if the field changed, 0 if it already held the value, -1 if
+    // no field has that name or the assignment doesn't parse.
+    int SetField(const std::string& assignment, SaveFile& save, const GameData& game);
+}
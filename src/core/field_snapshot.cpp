@@ -0,0 +1,91 @@
+// field_snapshot.cpp - Cached, preformatted values of every table field
+#include "field_snapshot.h"
+#include <cstdio>
+#include <cstring>
+
+FieldSnapshot::FieldSnapshot() : gatheredFrom(nullptr), gatheredVersion(0) {
+    for (size_t& start : groupStart) start = 0;
+}
+
+void FieldSnapshot::Build(const GameData& game) {
+    offsets.clear();
+    bits.clear();
+    formats.clear();
+    maxima.clear();
+
+    groupStart[(int)FieldGroup::VALUES] = offsets.size();
+    for (const GameValue& value : game.values) AddRow(value.offset, 0, FORMAT_NUMBER, value.max_value);
+    for (const GameValue& value : game.extra_values) AddRow(value.offset, 0, FORMAT_NUMBER, value.max_value);
+
+    groupStart[(int)FieldGroup::WEAPONS] = offsets.size();
+    for (const GameWeapon& weapon : game.weapons) AddRow(weapon.ammo_offset, 0, FORMAT_AMMO, weapon.max_ammo);
+
+    groupStart[(int)FieldGroup::GADGETS] = offsets.size();
+    for (const GameGadget& gadget : game.gadgets) AddRow(gadget.offset, gadget.bit_index, FORMAT_FLAG, 1);
+
+    groupStart[(int)FieldGroup::UNLOCKABLES] = offsets.size();
+    for (const GameUnlockable& unlockable : game.unlockables) {
+        AddRow(unlockable.offset, unlockable.bit_index, FORMAT_FLAG, 1);
+    }
+
+    groupStart[(int)FieldGroup::COUNT] = offsets.size();
+    values.assign(offsets.size(), 0);
+    text.assign(offsets.size(), Text());
+    for (size_t row = 0; row < offsets.size(); row++) {
+        FormatRow(row);
+    }
+
+    // Forces the next Refresh to gather
+    gatheredFrom = nullptr;
+}
+
+bool FieldSnapshot::Refresh(const SaveFile& save) {
+    if (gatheredFrom == &save && gatheredVersion == save.GetVersion()) return false;
+
+    ByteView bytes = save.GetView();
+    size_t count = offsets.size();
+    for (size_t row = 0; row < count; row++) {
+        int32_t value;
+        if (formats[row] == FORMAT_FLAG) {
+            value = (offsets[row] < bytes.size()) ? (bytes[offsets[row]] >> bits[row]) & 1 : 0;
+        } else {
+            value = (int32_t)bytes.ReadU32(offsets[row]);
+        }
+
+        // Formatting is the expensive half; skip it for unchanged rows
+        if (value != values[row]) {
+            values[row] = value;
+            FormatRow(row);
+        }
+    }
+
+    gatheredFrom = &save;
+    gatheredVersion = save.GetVersion();
+    return true;
+}
+
+size_t FieldSnapshot::GetCount(FieldGroup group) const {
+    return groupStart[(int)group + 1] - groupStart[(int)group];
+}
+
+void FieldSnapshot::AddRow(uint32_t offset, uint8_t bit, Format format, int32_t max) {
+    offsets.push_back(offset);
+    bits.push_back(bit);
+    formats.push_back(format);
+    maxima.push_back(max);
+}
+
+void FieldSnapshot::FormatRow(size_t row) {
+    char* out = text[row].chars;
+    switch (formats[row]) {
+        case FORMAT_NUMBER:
+            snprintf(out, sizeof(Text::chars), "%d", values[row]);
+            break;
+        case FORMAT_AMMO:
+            snprintf(out, sizeof(Text::chars), "%d / %d", values[row], maxima[row]);
+            break;
+        default:
+            out[0] = '\0';
+            break;
+    }
+}
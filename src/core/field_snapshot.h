@@ -0,0 +1,61 @@
+// field_snapshot.h - Cached, preformatted values of every table field
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "save_file.h"
+#include "../data/rac_vita_games_data.h"
+
+// Field groups, in editor tab order
+enum class FieldGroup {
+    VALUES,         // values, then extra_values
+    WEAPONS,
+    GADGETS,
+    UNLOCKABLES,
+    COUNT
+};
+
+// Render code reads rows from here instead of the SaveFile. Field layout is
+// kept as parallel arrays so a refresh is one linear pass over offsets,
+// and it only happens when the save's version has moved since the last one.
+class FieldSnapshot {
+public:
+    FieldSnapshot();
+
+    // Lays out the rows for a game; values are gathered on the next Refresh
+    void Build(const GameData& game);
+
+    // Re-gathers everything if the save changed; returns true if it did
+    bool Refresh(const SaveFile& save);
+
+    size_t GetCount(FieldGroup group) const;
+    int32_t GetValue(FieldGroup group, size_t row) const { return values[Index(group, row)]; }
+    bool GetFlag(FieldGroup group, size_t row) const { return values[Index(group, row)] != 0; }
+    const char* GetText(FieldGroup group, size_t row) const { return text[Index(group, row)].chars; }
+
+private:
+    enum Format : uint8_t {
+        FORMAT_NUMBER,      // "123"
+        FORMAT_AMMO,        // "12 / 40"
+        FORMAT_FLAG         // No text; a single bit
+    };
+
+    struct Text {
+        char chars[28];
+    };
+
+    size_t Index(FieldGroup group, size_t row) const { return groupStart[(int)group] + row; }
+    void AddRow(uint32_t offset, uint8_t bit, Format format, int32_t max);
+    void FormatRow(size_t row);
+
+    // One entry per row across all groups
+    std::vector<uint32_t> offsets;
+    std::vector<uint8_t> bits;
+    std::vector<uint8_t> formats;
+    std::vector<int32_t> maxima;
+    std::vector<int32_t> values;
+    std::vector<Text> text;
+
+    size_t groupStart[(int)FieldGroup::COUNT + 1];
+    const SaveFile* gatheredFrom;
+    uint64_t gatheredVersion;
+};
@@ -2,11 +2,11 @@
 // src/core/game_data.cpp
 // ============================================================
 // This file is intentionally minimal - game data is defined
-// in the header file rac_vita_games_data.h as inline functions
-// and static data structures.
+// in the header file rac_vita_games_data.h as constexpr tables
+// and inline functions.
 
 #include "../data/rac_vita_games_data.h"
 
 // All game data structures are defined in the header file.
 // This source file exists to satisfy the build system but
-// contains no actual code since everything is inline/static.
+// contains no actual code since everything is inline/constexpr.
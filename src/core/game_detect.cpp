@@ -0,0 +1,173 @@
+// game_detect.cpp - Content-signature game detection
+#include "game_detect.h"
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace {
+
+    const size_t CACHE_LINE = 64;
+
+    // Evidence per anchor: a plausible non-zero value counts for, a value
+    // no save of that game could hold counts harder against. Zero is what
+    // a fresh save holds everywhere, so it says nothing.
+    const float EVIDENCE_PLAUSIBLE = 1.0f;
+    const float EVIDENCE_IMPOSSIBLE = -2.0f;
+
+    // Added when the file size falls in the game's usual range; enough to
+    // settle a blank save, but never applied to contents that argue against
+    const float SIZE_PRIOR = 0.5f;
+
+    // Scores for games the file is too small to hold
+    const float SCORE_IMPOSSIBLE = -10.0f;
+
+    struct Anchor {
+        uint32_t offset;
+        int32_t minValue;
+        int32_t maxValue;
+        bool flag;          // One byte, 0 or 1; otherwise an int32 in range
+    };
+
+    struct Signature {
+        GameType type;
+        size_t minSize;
+        size_t maxSize;
+        std::vector<Anchor> anchors;
+        size_t lines;
+        size_t end;         // One past the last byte read
+    };
+
+    void AddRange(std::map<uint32_t, Anchor>& anchors, uint32_t offset, int32_t minValue, int32_t maxValue) {
+        // Offset 0 marks fields whose location is not known yet
+        if (offset == 0) return;
+        anchors[offset] = Anchor{offset, minValue, maxValue, false};
+    }
+
+    void AddFlag(std::map<uint32_t, Anchor>& anchors, uint32_t offset) {
+        if (offset == 0) return;
+        anchors.emplace(offset, Anchor{offset, 0, 1, true});
+    }
+
+    size_t AnchorEnd(const Anchor& anchor) {
+        return anchor.offset + (anchor.flag ? 1 : 4);
+    }
+
+    Signature Build(GameType type, size_t minSize, size_t maxSize) {
+        GameData game(type);
+        std::map<uint32_t, Anchor> all;
+        for (const GameValue& value : game.values) {
+            AddRange(all, value.offset, value.min_value, value.max_value);
+        }
+        for (const GameWeapon& weapon : game.weapons) {
+            AddRange(all, weapon.ammo_offset, weapon.min_ammo, weapon.max_ammo);
+        }
+        for (const GameGadget& gadget : game.gadgets) {
+            AddFlag(all, gadget.offset);
+        }
+        for (const GameUnlockable& unlockable : game.unlockables) {
+            AddFlag(all, unlockable.offset);
+        }
+
+        // Keep the lines holding the most anchors
+        std::map<size_t, size_t> perLine;
+        for (const auto& entry : all) {
+            perLine[entry.first / CACHE_LINE]++;
+        }
+        std::vector<std::pair<size_t, size_t>> ranked(perLine.begin(), perLine.end());
+        std::stable_sort(ranked.begin(), ranked.end(),
+            [](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+                return a.second > b.second;
+            });
+        if (ranked.size() > GameDetect::MAX_LINES_PER_GAME) {
+            ranked.resize(GameDetect::MAX_LINES_PER_GAME);
+        }
+
+        Signature sig;
+        sig.type = type;
+        sig.minSize = minSize;
+        sig.maxSize = maxSize;
+        sig.end = 0;
+        for (const auto& entry : all) {
+            const Anchor& anchor = entry.second;
+            size_t first = anchor.offset / CACHE_LINE;
+            size_t last = (AnchorEnd(anchor) - 1) / CACHE_LINE;
+            bool firstKept = false, lastKept = false;
+            for (const auto& line : ranked) {
+                firstKept = firstKept || line.first == first;
+                lastKept = lastKept || line.first == last;
+            }
+            // Fields crossing into an unselected line would cost another one
+            if (firstKept && lastKept) {
+                sig.anchors.push_back(anchor);
+                sig.end = std::max(sig.end, AnchorEnd(anchor));
+            }
+        }
+        sig.lines = ranked.size();
+        return sig;
+    }
+
+    const std::vector<Signature>& Signatures() {
+        // Size ranges are half-open so no size belongs to two games
+        static const std::vector<Signature> signatures = {
+            Build(GameType::RAC1_VITA, 650000, 850000),
+            Build(GameType::RAC2_VITA, 850000, 1150000),
+            Build(GameType::RAC3_VITA, 1150000, (size_t)-1),
+        };
+        return signatures;
+    }
+
+    float Score(const Signature& sig, ByteView save) {
+        if (save.size() < sig.end || sig.anchors.empty()) return SCORE_IMPOSSIBLE;
+
+        float evidence = 0.0f;
+        for (const Anchor& anchor : sig.anchors) {
+            int32_t value = anchor.flag ? save[anchor.offset] : (int32_t)save.ReadU32(anchor.offset);
+            if (value == 0) continue;
+            bool plausible = value >= anchor.minValue && value <= anchor.maxValue;
+            evidence += plausible ? EVIDENCE_PLAUSIBLE : EVIDENCE_IMPOSSIBLE;
+        }
+
+        float score = evidence / sig.anchors.size();
+        if (score >= 0.0f && save.size() >= sig.minSize && save.size() < sig.maxSize) {
+            score += SIZE_PRIOR;
+        }
+        return score;
+    }
+}
+
+namespace GameDetect {
+
+    DetectionResult Detect(ByteView save) {
+        DetectionResult result;
+        result.type = GameType::UNKNOWN;
+        result.confidence = 0.0f;
+
+        // UNKNOWN is the baseline: a game must score above zero to win
+        for (float& score : result.scores) score = SCORE_IMPOSSIBLE;
+        result.scores[(int)GameType::UNKNOWN] = 0.0f;
+
+        float best = 0.0f;
+        for (const Signature& sig : Signatures()) {
+            float score = Score(sig, save);
+            result.scores[(int)sig.type] = score;
+            if (score > best) {
+                best = score;
+                result.type = sig.type;
+            }
+        }
+
+        float runnerUp = SCORE_IMPOSSIBLE;
+        for (int type = 0; type < GAME_TYPE_COUNT; type++) {
+            if (type != (int)result.type) runnerUp = std::max(runnerUp, result.scores[type]);
+        }
+        result.confidence = std::min(1.0f, result.scores[(int)result.type] - runnerUp);
+        return result;
+    }
+
+    size_t CacheLinesTouched(GameType type) {
+        for (const Signature& sig : Signatures()) {
+            if (sig.type == type) return sig.lines;
+        }
+        return 0;
+    }
+}
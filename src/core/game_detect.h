@@ -0,0 +1,30 @@
+// game_detect.h - Content-signature game detection
+#pragma once
+#include <cstddef>
+#include "byte_view.h"
+#include "../data/rac_vita_games_data.h"
+
+const int GAME_TYPE_COUNT = 4;     // Including UNKNOWN
+
+struct DetectionResult {
+    GameType type;
+    float confidence;                   // 0 = guess, 1 = unambiguous
+    float scores[GAME_TYPE_COUNT];      // Per GameType, higher is likelier
+};
+
+// Each game is scored on a few anchor fields taken from its own table:
+// ammo counts that must lie within [min, max] and item flags that must be
+// 0 or 1, plus a weak prior from the file size. Anchors are limited to a
+// few 64-byte lines per game, so a detection reads well under 1 KB.
+namespace GameDetect {
+    const size_t MAX_LINES_PER_GAME = 4;
+
+    DetectionResult Detect(ByteView save);
+
+    // Number of distinct cache lines Detect reads for one candidate game
+    size_t CacheLinesTouched(GameType type);
+}
+
+inline GameType DetectGameType(ByteView saveData) {
+    return GameDetect::Detect(saveData).type;
+}
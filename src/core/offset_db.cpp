@@ -0,0 +1,192 @@
+// offset_db.cpp - Offset tables loaded at runtime from a compiled binary file
+#include "offset_db.h"
+#include "crc32.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+    const char DB_MAGIC[4] = {'S', 'L', 'D', 'B'};
+    const size_t HEADER_SIZE = 28;
+    const size_t GAME_SIZE = 8 + 8 * (int)OffsetCategory::COUNT;
+    const size_t RANGE_SIZE = 24;
+    const size_t FLAG_SIZE = 16;
+
+    uint32_t Get32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, 4);
+        return value;
+    }
+
+    bool IsFlagCategory(int category) {
+        return category == (int)OffsetCategory::GADGETS || category == (int)OffsetCategory::UNLOCKABLES;
+    }
+
+    OffsetDatabase active;
+}
+
+OffsetDatabase::OffsetDatabase() : fieldCount(0) {
+}
+
+bool OffsetDatabase::Fail(const std::string& message) {
+    file.clear();
+    games.clear();
+    ranges.clear();
+    weapons.clear();
+    gadgets.clear();
+    unlockables.clear();
+    fieldCount = 0;
+    error = message;
+    return false;
+}
+
+bool OffsetDatabase::Load(const std::string& path) {
+    FILE* handle = fopen(path.c_str(), "rb");
+    if (!handle) return Fail("cannot open " + path);
+
+    std::vector<uint8_t> bytes;
+    bool ok = fseek(handle, 0, SEEK_END) == 0;
+    long size = ok ? ftell(handle) : -1;
+    ok = size > 0 && fseek(handle, 0, SEEK_SET) == 0;
+    if (ok) {
+        bytes.resize((size_t)size);
+        ok = fread(bytes.data(), 1, bytes.size(), handle) == bytes.size();
+    }
+    fclose(handle);
+    if (!ok) return Fail("cannot read " + path);
+    return LoadFromMemory(std::move(bytes));
+}
+
+bool OffsetDatabase::LoadFromMemory(std::vector<uint8_t> bytes) {
+    Fail("");
+    file = std::move(bytes);
+
+    if (file.size() < HEADER_SIZE || std::memcmp(file.data(), DB_MAGIC, 4) != 0) return Fail("not an offset database");
+    if (Get32(&file[4]) != FORMAT) return Fail("unsupported database format");
+    if (Get32(&file[24]) != Crc32::Update(0, &file[HEADER_SIZE], file.size() - HEADER_SIZE)) {
+        return Fail("database is corrupt (CRC mismatch)");
+    }
+
+    uint32_t gameCount = Get32(&file[8]);
+    uint32_t recordCount = Get32(&file[12]);
+    uint32_t poolOffset = Get32(&file[16]);
+    uint32_t poolSize = Get32(&file[20]);
+    if (poolOffset > file.size() || poolSize > file.size() - poolOffset || poolSize == 0 ||
+        file[poolOffset + poolSize - 1] != 0) {
+        return Fail("bad string pool");
+    }
+    // The CRC doesn't cover the header, so its counts are checked against the
+    // file in 64 bits before anything is indexed; size_t wraps on the Vita
+    uint64_t gamesEnd = HEADER_SIZE + (uint64_t)gameCount * GAME_SIZE;
+    if (gamesEnd > poolOffset) return Fail("bad game table");
+
+    // Range records, then flag records, between the game table and the pool
+    auto text = [&](uint32_t ref) -> const char* {
+        return ref < poolSize ? reinterpret_cast<const char*>(&file[poolOffset + ref]) : nullptr;
+    };
+
+    fieldCount = 0;
+    for (uint32_t g = 0; g < gameCount; g++) {
+        const uint8_t* entry = &file[HEADER_SIZE + (size_t)g * GAME_SIZE];
+        Game game;
+        game.type = (GameType)Get32(entry);
+        game.name = text(Get32(entry + 4));
+        if (!game.name || game.type == GameType::UNKNOWN || (int)game.type > (int)GameType::RAC3_VITA) return Fail("bad game entry");
+
+        for (int c = 0; c < (int)OffsetCategory::COUNT; c++) {
+            uint32_t first = Get32(entry + 8 + c * 8);
+            uint32_t count = Get32(entry + 12 + c * 8);
+            size_t recordSize = IsFlagCategory(c) ? FLAG_SIZE : RANGE_SIZE;
+            if (first < gamesEnd || first > poolOffset || (uint64_t)count * recordSize > poolOffset - first) {
+                return Fail("bad record table");
+            }
+
+            for (uint32_t i = 0; i < count; i++) {
+                const uint8_t* record = &file[first + i * recordSize];
+                const char* name = text(Get32(record));
+                const char* description = text(Get32(record + 4));
+                if (!name || !description) return Fail("bad string reference");
+                uint32_t offset = Get32(record + 8);
+
+                if (IsFlagCategory(c)) {
+                    uint32_t bit = Get32(record + 12);
+                    if (bit > 7) return Fail("bad flag bit");
+                    if (c == (int)OffsetCategory::GADGETS) gadgets.push_back(GameGadget{name, description, offset, (uint8_t)bit});
+                    else unlockables.push_back(GameUnlockable{name, description, offset, (uint8_t)bit});
+                } else {
+                    int32_t minValue = (int32_t)Get32(record + 12);
+                    int32_t maxValue = (int32_t)Get32(record + 16);
+                    uint32_t size = Get32(record + 20);
+                    if (size != 4) return Fail("unsupported field size");
+                    if (c == (int)OffsetCategory::WEAPONS) {
+                        weapons.push_back(GameWeapon{name, description, offset, minValue, maxValue, size});
+                    } else {
+                        ranges.push_back(GameValue{name, description, offset, minValue, maxValue, size});
+                    }
+                }
+            }
+
+            size_t stored = c == (int)OffsetCategory::GADGETS ? gadgets.size()
+                          : c == (int)OffsetCategory::UNLOCKABLES ? unlockables.size()
+                          : c == (int)OffsetCategory::WEAPONS ? weapons.size()
+                          : ranges.size();
+            game.first[c] = stored - count;
+            game.count[c] = count;
+            fieldCount += count;
+        }
+        games.push_back(game);
+    }
+    if (fieldCount != recordCount) return Fail("bad record count");
+    return true;
+}
+
+bool OffsetDatabase::HasGame(GameType type) const {
+    for (const Game& game : games) {
+        if (game.type == type) return true;
+    }
+    return false;
+}
+
+bool OffsetDatabase::GetGame(GameType type, GameData& out) const {
+    for (const Game& game : games) {
+        if (game.type != type) continue;
+
+        out = GameData();
+        out.type = type;
+        out.name = game.name;
+        auto range = [&](OffsetCategory c) {
+            return TableView<GameValue>(ranges.data() + game.first[(int)c], game.count[(int)c]);
+        };
+        out.values = range(OffsetCategory::VALUES);
+        out.extra_values = range(OffsetCategory::EXTRA_VALUES);
+        int w = (int)OffsetCategory::WEAPONS, g = (int)OffsetCategory::GADGETS, u = (int)OffsetCategory::UNLOCKABLES;
+        out.weapons = TableView<GameWeapon>(weapons.data() + game.first[w], game.count[w]);
+        out.gadgets = TableView<GameGadget>(gadgets.data() + game.first[g], game.count[g]);
+        out.unlockables = TableView<GameUnlockable>(unlockables.data() + game.first[u], game.count[u]);
+        return true;
+    }
+    return false;
+}
+
+namespace GameTables {
+
+    bool LoadDatabase(const std::string& path, std::string* error) {
+        bool ok = active.Load(path);
+        if (!ok && error) *error = active.GetError();
+        return ok;
+    }
+
+    void UseBuiltIn() {
+        active = OffsetDatabase();
+    }
+
+    bool IsDatabaseLoaded() {
+        return active.IsLoaded();
+    }
+
+    GameData Get(GameType type) {
+        GameData game;
+        if (active.GetGame(type, game)) return game;
+        return GameData(type);
+    }
+}
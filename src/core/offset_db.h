@@ -0,0 +1,92 @@
+// offset_db.h - Offset tables loaded at runtime from a compiled binary file
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../data/rac_vita_games_data.h"
+
+// Compiled once on a PC from JSON (slims_cli --compile-offsets), then read
+// by the app in one go. Little-endian layout:
+//
+//   header    "SLDB" | format | gameCount | fieldCount | poolOffset |
+//             poolSize | crc32 of everything after the header
+//   games     gameCount x { type | nameRef | CATEGORY_COUNT x { first | count } }
+//   ranges    fixed 24-byte records: nameRef | descRef | offset | min | max | size
+//   flags     fixed 16-byte records: nameRef | descRef | offset | bit | pad
+//   pool      NUL-terminated strings; a *Ref is a byte offset into it
+//
+// Records of a category are contiguous, so loading is a bounds check and
+// one pass turning string refs into pointers; nothing is tokenised. After
+// that, GameData for any game is a handful of pointer copies however many
+// fields the file holds.
+enum class OffsetCategory {
+    VALUES,         // Range records
+    WEAPONS,        // Range records (ammo)
+    EXTRA_VALUES,   // Range records
+    GADGETS,        // Flag records
+    UNLOCKABLES,    // Flag records
+    COUNT
+};
+
+class OffsetDatabase {
+public:
+    OffsetDatabase();
+
+    // Replaces the contents; on failure the database is left empty and
+    // GetError says why
+    bool Load(const std::string& path);
+    bool LoadFromMemory(std::vector<uint8_t> bytes);
+
+    bool IsLoaded() const { return !games.empty(); }
+    bool HasGame(GameType type) const;
+
+    // Views into this database; valid while it is alive and not reloaded
+    bool GetGame(GameType type, GameData& out) const;
+
+    size_t GetGameCount() const { return games.size(); }
+    size_t GetFieldCount() const { return fieldCount; }
+    const std::string& GetError() const { return error; }
+
+    // JSON -> binary. The JSON holds {"games": [{"game": "rac1", "name": ...,
+    // "values": [{"name", "description", "offset", "min", "max", "size"}],
+    // "weapons": [...], "extra_values": [...], "gadgets": [{"name",
+    // "description", "offset", "bit"}], "unlockables": [...]}]}. Offsets
+    // may be numbers or "0x..." strings. "size" must be 4: every field is
+    // read and written as a 32-bit integer.
+    static bool Compile(const std::string& json, std::vector<uint8_t>& out, std::string& error);
+
+    // The built-in tables as JSON in the format Compile reads
+    static std::string ExportBuiltIn();
+
+    static const uint32_t FORMAT = 1;
+
+private:
+    struct Game {
+        GameType type;
+        const char* name;
+        size_t first[(int)OffsetCategory::COUNT];
+        size_t count[(int)OffsetCategory::COUNT];
+    };
+
+    std::vector<uint8_t> file;          // Owns the string pool
+    std::vector<Game> games;
+    std::vector<GameValue> ranges;      // Values and extra values
+    std::vector<GameWeapon> weapons;
+    std::vector<GameGadget> gadgets;
+    std::vector<GameUnlockable> unlockables;
+    size_t fieldCount;
+    std::string error;
+
+    bool Fail(const std::string& message);
+};
+
+// The tables the app and tools use: a loaded database where it covers a
+// game, the built-in constexpr tables otherwise. Load before any thread
+// asks for tables.
+namespace GameTables {
+    bool LoadDatabase(const std::string& path, std::string* error = nullptr);
+    void UseBuiltIn();
+    bool IsDatabaseLoaded();
+    GameData Get(GameType type);
+}
@@ -0,0 +1,439 @@
+// offset_db_json.cpp - JSON side of the offset database (compile and export)
+//
+// Kept apart from offset_db.cpp so the app, which only loads compiled
+// databases, does not link a JSON reader.
+#include "offset_db.h"
+#include "crc32.h"
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+namespace {
+
+    const char* CATEGORY_KEYS[(int)OffsetCategory::COUNT] = {
+        "values", "weapons", "extra_values", "gadgets", "unlockables"
+    };
+
+    const char* GAME_KEYS[] = {nullptr, "rac1", "rac2", "rac3"};
+
+    // Just enough JSON for the database: objects, arrays, strings, numbers,
+    // true/false/null
+    struct JsonValue {
+        enum class Kind { NONE, OBJECT, ARRAY, STRING, NUMBER, BOOLEAN };
+        Kind kind = Kind::NONE;
+        std::string text;
+        double number = 0;
+        std::vector<std::pair<std::string, JsonValue>> members;
+        std::vector<JsonValue> items;
+
+        const JsonValue* Find(const char* key) const {
+            for (const auto& member : members) {
+                if (member.first == key) return &member.second;
+            }
+            return nullptr;
+        }
+    };
+
+    class JsonReader {
+    public:
+        explicit JsonReader(const std::string& json) : text(json), pos(0), line(1) {}
+
+        bool Parse(JsonValue& out, std::string& error) {
+            if (!Value(out, 0)) {
+                error = message + " at line " + std::to_string(line);
+                return false;
+            }
+            Skip();
+            if (pos != text.size()) {
+                error = "trailing characters at line " + std::to_string(line);
+                return false;
+            }
+            return true;
+        }
+
+    private:
+        const std::string& text;
+        size_t pos;
+        int line;
+        std::string message;
+
+        bool Fail(const char* what) {
+            message = what;
+            return false;
+        }
+
+        void Skip() {
+            while (pos < text.size() && strchr(" \t\r\n", text[pos])) {
+                if (text[pos] == '\n') line++;
+                pos++;
+            }
+        }
+
+        bool Literal(const char* word) {
+            size_t length = strlen(word);
+            if (text.compare(pos, length, word) != 0) return false;
+            pos += length;
+            return true;
+        }
+
+        bool String(std::string& out) {
+            pos++;
+            while (pos < text.size() && text[pos] != '"') {
+                char c = text[pos++];
+                if (c == '\n') return Fail("newline in string");
+                if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+                if (pos >= text.size()) break;
+                char escape = text[pos++];
+                switch (escape) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u': {
+                        if (pos + 4 > text.size()) return Fail("bad \\u escape");
+                        unsigned code = (unsigned)strtoul(text.substr(pos, 4).c_str(), nullptr, 16);
+                        pos += 4;
+                        // Basic plane only, as UTF-8
+                        if (code < 0x80) {
+                            out += (char)code;
+                        } else if (code < 0x800) {
+                            out += (char)(0xC0 | (code >> 6));
+                            out += (char)(0x80 | (code & 0x3F));
+                        } else {
+                            out += (char)(0xE0 | (code >> 12));
+                            out += (char)(0x80 | ((code >> 6) & 0x3F));
+                            out += (char)(0x80 | (code & 0x3F));
+                        }
+                        break;
+                    }
+                    default: out += escape; break;
+                }
+            }
+            if (pos >= text.size()) return Fail("unterminated string");
+            pos++;
+            return true;
+        }
+
+        bool Value(JsonValue& out, int depth) {
+            if (depth > 32) return Fail("nesting too deep");
+            Skip();
+            if (pos >= text.size()) return Fail("unexpected end of input");
+
+            char c = text[pos];
+            if (c == '{') {
+                out.kind = JsonValue::Kind::OBJECT;
+                pos++;
+                Skip();
+                if (pos < text.size() && text[pos] == '}') {
+                    pos++;
+                    return true;
+                }
+                while (true) {
+                    Skip();
+                    if (pos >= text.size() || text[pos] != '"') return Fail("expected a key");
+                    std::pair<std::string, JsonValue> member;
+                    if (!String(member.first)) return false;
+                    Skip();
+                    if (pos >= text.size() || text[pos] != ':') return Fail("expected ':'");
+                    pos++;
+                    if (!Value(member.second, depth + 1)) return false;
+                    out.members.push_back(std::move(member));
+                    Skip();
+                    if (pos < text.size() && text[pos] == ',') {
+                        pos++;
+                    } else if (pos < text.size() && text[pos] == '}') {
+                        pos++;
+                        return true;
+                    } else {
+                        return Fail("expected ',' or '}'");
+                    }
+                }
+            }
+            if (c == '[') {
+                out.kind = JsonValue::Kind::ARRAY;
+                pos++;
+                Skip();
+                if (pos < text.size() && text[pos] == ']') {
+                    pos++;
+                    return true;
+                }
+                while (true) {
+                    out.items.emplace_back();
+                    if (!Value(out.items.back(), depth + 1)) return false;
+                    Skip();
+                    if (pos < text.size() && text[pos] == ',') {
+                        pos++;
+                    } else if (pos < text.size() && text[pos] == ']') {
+                        pos++;
+                        return true;
+                    } else {
+                        return Fail("expected ',' or ']'");
+                    }
+                }
+            }
+            if (c == '"') {
+                out.kind = JsonValue::Kind::STRING;
+                return String(out.text);
+            }
+            if (Literal("true") || Literal("false")) {
+                out.kind = JsonValue::Kind::BOOLEAN;
+                out.number = text[pos - 2] == 'u' ? 1 : 0;
+                return true;
+            }
+            if (Literal("null")) return true;
+
+            const char* start = text.c_str() + pos;
+            char* end = nullptr;
+            out.number = strtod(start, &end);
+            if (end == start) return Fail("unexpected character");
+            out.kind = JsonValue::Kind::NUMBER;
+            pos += end - start;
+            return true;
+        }
+    };
+
+    // Strings are pooled once however many records use them
+    class StringPool {
+    public:
+        uint32_t Add(const std::string& value) {
+            auto found = offsets.find(value);
+            if (found != offsets.end()) return found->second;
+            uint32_t offset = (uint32_t)bytes.size();
+            bytes.insert(bytes.end(), value.begin(), value.end());
+            bytes.push_back(0);
+            offsets[value] = offset;
+            return offset;
+        }
+
+        const std::vector<uint8_t>& Bytes() const { return bytes; }
+
+    private:
+        std::vector<uint8_t> bytes;
+        std::map<std::string, uint32_t> offsets;
+    };
+
+    void Put32(std::vector<uint8_t>& out, uint32_t value) {
+        for (int i = 0; i < 4; i++) out.push_back((uint8_t)(value >> (i * 8)));
+    }
+
+    void Set32(std::vector<uint8_t>& out, size_t at, uint32_t value) {
+        for (int i = 0; i < 4; i++) out[at + i] = (uint8_t)(value >> (i * 8));
+    }
+
+    bool Integer(const JsonValue* value, int64_t& out) {
+        if (!value) return false;
+        if (value->kind == JsonValue::Kind::NUMBER) {
+            // Casting a double that int64_t can't hold is undefined; 2^63 is exact
+            double number = value->number;
+            if (!std::isfinite(number) || number != std::floor(number) ||
+                number < -9223372036854775808.0 || number >= 9223372036854775808.0) {
+                return false;
+            }
+            out = (int64_t)number;
+            return true;
+        }
+        if (value->kind == JsonValue::Kind::STRING && !value->text.empty()) {
+            char* end = nullptr;
+            errno = 0;
+            out = strtoll(value->text.c_str(), &end, 0);
+            return *end == '\0' && errno != ERANGE;
+        }
+        return false;
+    }
+
+    std::string Quote(const char* text) {
+        std::string out = "\"";
+        for (const char* p = text; *p; p++) {
+            if (*p == '"' || *p == '\\') {
+                out += '\\';
+                out += *p;
+            } else if (*p == '\n') {
+                out += "\\n";
+            } else if ((uint8_t)*p < 0x20) {
+                char escape[8];
+                snprintf(escape, sizeof(escape), "\\u%04x", (unsigned)*p);
+                out += escape;
+            } else {
+                out += *p;
+            }
+        }
+        return out + "\"";
+    }
+
+    std::string Hex(uint32_t value) {
+        char text[16];
+        snprintf(text, sizeof(text), "\"0x%X\"", value);
+        return text;
+    }
+}
+
+bool OffsetDatabase::Compile(const std::string& json, std::vector<uint8_t>& out, std::string& error) {
+    JsonValue root;
+    if (!JsonReader(json).Parse(root, error)) return false;
+
+    const JsonValue* gameList = root.Find("games");
+    if (!gameList || gameList->kind != JsonValue::Kind::ARRAY || gameList->items.empty()) {
+        error = "expected a non-empty \"games\" array";
+        return false;
+    }
+
+    StringPool pool;
+    std::vector<uint8_t> gameTable;
+    std::vector<uint8_t> records;
+    std::vector<size_t> firstFixups;    // Record-relative offsets, rebased below
+    uint32_t fieldCount = 0;
+
+    for (const JsonValue& game : gameList->items) {
+        const JsonValue* key = game.Find("game");
+        int type = 0;
+        for (int t = 1; t < 4 && key; t++) {
+            if (key->text == GAME_KEYS[t]) type = t;
+        }
+        if (!type) {
+            error = "each game needs \"game\": \"rac1\", \"rac2\" or \"rac3\"";
+            return false;
+        }
+        const JsonValue* name = game.Find("name");
+        std::string gameName = name && name->kind == JsonValue::Kind::STRING ? name->text
+                             : GetGameName((GameType)type);
+
+        Put32(gameTable, (uint32_t)type);
+        Put32(gameTable, pool.Add(gameName));
+
+        for (int c = 0; c < (int)OffsetCategory::COUNT; c++) {
+            const JsonValue* list = game.Find(CATEGORY_KEYS[c]);
+            if (list && list->kind != JsonValue::Kind::ARRAY) {
+                error = std::string(GAME_KEYS[type]) + "." + CATEGORY_KEYS[c] + " must be an array";
+                return false;
+            }
+            bool flags = c == (int)OffsetCategory::GADGETS || c == (int)OffsetCategory::UNLOCKABLES;
+            size_t count = list ? list->items.size() : 0;
+
+            firstFixups.push_back(gameTable.size());
+            Put32(gameTable, (uint32_t)records.size());
+            Put32(gameTable, (uint32_t)count);
+
+            for (size_t i = 0; i < count; i++) {
+                const JsonValue& field = list->items[i];
+                const JsonValue* fieldName = field.Find("name");
+                const JsonValue* description = field.Find("description");
+                int64_t offset = 0;
+                std::string where = std::string(GAME_KEYS[type]) + "." + CATEGORY_KEYS[c] + "[" + std::to_string(i) + "]";
+                if (!fieldName || fieldName->kind != JsonValue::Kind::STRING) {
+                    error = where + " needs a \"name\"";
+                    return false;
+                }
+                if (!Integer(field.Find("offset"), offset) || offset < 0 || offset > 0xFFFFFFFFll) {
+                    error = where + " needs a valid \"offset\"";
+                    return false;
+                }
+
+                Put32(records, pool.Add(fieldName->text));
+                Put32(records, pool.Add(description && description->kind == JsonValue::Kind::STRING ? description->text : ""));
+                Put32(records, (uint32_t)offset);
+
+                if (flags) {
+                    int64_t bit = 0;
+                    if (!Integer(field.Find("bit"), bit) || bit < 0 || bit > 7) {
+                        error = where + " needs a \"bit\" from 0 to 7";
+                        return false;
+                    }
+                    Put32(records, (uint32_t)bit);
+                } else {
+                    int64_t minValue = 0, maxValue = 0, size = 0;
+                    if (!Integer(field.Find("min"), minValue) || !Integer(field.Find("max"), maxValue) ||
+                        minValue > maxValue) {
+                        error = where + " needs \"min\" <= \"max\"";
+                        return false;
+                    }
+                    // Stored as int32; anything wider would wrap into another limit
+                    if (minValue < INT32_MIN || maxValue > INT32_MAX) {
+                        error = where + " needs \"min\" and \"max\" within a 32-bit signed integer";
+                        return false;
+                    }
+                    // The editor, snapshot, presets and CLI all read and write
+                    // 32 bits; a narrower field would clobber its neighbours
+                    if (!Integer(field.Find("size"), size) || size != 4) {
+                        error = where + " needs a \"size\" of 4";
+                        return false;
+                    }
+                    Put32(records, (uint32_t)(int32_t)minValue);
+                    Put32(records, (uint32_t)(int32_t)maxValue);
+                    Put32(records, (uint32_t)size);
+                }
+                fieldCount++;
+            }
+        }
+    }
+
+    const size_t HEADER_SIZE = 28;
+    uint32_t recordBase = (uint32_t)(HEADER_SIZE + gameTable.size());
+    for (size_t at : firstFixups) {
+        uint32_t first = gameTable[at] | gameTable[at + 1] << 8 | gameTable[at + 2] << 16 | (uint32_t)gameTable[at + 3] << 24;
+        Set32(gameTable, at, recordBase + first);
+    }
+
+    out.assign({'S', 'L', 'D', 'B'});
+    out.reserve(HEADER_SIZE + gameTable.size() + records.size() + pool.Bytes().size());
+    Put32(out, FORMAT);
+    Put32(out, (uint32_t)gameList->items.size());
+    Put32(out, fieldCount);
+    Put32(out, recordBase + (uint32_t)records.size());
+    Put32(out, (uint32_t)pool.Bytes().size());
+    Put32(out, 0);
+    out.insert(out.end(), gameTable.begin(), gameTable.end());
+    out.insert(out.end(), records.begin(), records.end());
+    out.insert(out.end(), pool.Bytes().begin(), pool.Bytes().end());
+    Set32(out, 24, Crc32::Update(0, out.data() + HEADER_SIZE, out.size() - HEADER_SIZE));
+    return true;
+}
+
+std::string OffsetDatabase::ExportBuiltIn() {
+    std::string json = "{\n  \"games\": [";
+    for (int t = 1; t < 4; t++) {
+        GameData game((GameType)t);
+        json += t > 1 ? ",\n    {\n" : "\n    {\n";
+        json += std::string("      \"game\": \"") + GAME_KEYS[t] + "\",\n";
+        json += "      \"name\": " + Quote(game.name);
+
+        auto ranges = [&](const char* key, const auto& table, auto offsetOf, auto minOf, auto maxOf) {
+            json += std::string(",\n      \"") + key + "\": [";
+            for (size_t i = 0; i < table.size(); i++) {
+                const auto& field = table[i];
+                json += i ? ",\n        " : "\n        ";
+                json += "{\"name\": " + Quote(field.name) + ", \"description\": " + Quote(field.description) +
+                        ", \"offset\": " + Hex(offsetOf(field)) + ", \"min\": " + std::to_string(minOf(field)) +
+                        ", \"max\": " + std::to_string(maxOf(field)) + ", \"size\": " + std::to_string(field.byte_size) + "}";
+            }
+            json += table.size() ? "\n      ]" : "]";
+        };
+        auto flags = [&](const char* key, const auto& table) {
+            json += std::string(",\n      \"") + key + "\": [";
+            for (size_t i = 0; i < table.size(); i++) {
+                const auto& field = table[i];
+                json += i ? ",\n        " : "\n        ";
+                json += "{\"name\": " + Quote(field.name) + ", \"description\": " + Quote(field.description) +
+                        ", \"offset\": " + Hex(field.offset) + ", \"bit\": " + std::to_string(field.bit_index) + "}";
+            }
+            json += table.size() ? "\n      ]" : "]";
+        };
+
+        ranges("values", game.values, [](const GameValue& v) { return v.offset; },
+               [](const GameValue& v) { return v.min_value; }, [](const GameValue& v) { return v.max_value; });
+        ranges("weapons", game.weapons, [](const GameWeapon& w) { return w.ammo_offset; },
+               [](const GameWeapon& w) { return w.min_ammo; }, [](const GameWeapon& w) { return w.max_ammo; });
+        ranges("extra_values", game.extra_values, [](const GameValue& v) { return v.offset; },
+               [](const GameValue& v) { return v.min_value; }, [](const GameValue& v) { return v.max_value; });
+        flags("gadgets", game.gadgets);
+        flags("unlockables", game.unlockables);
+        json += "\n    }";
+    }
+    return json + "\n  ]\n}\n";
+}
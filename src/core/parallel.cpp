@@ -0,0 +1,28 @@
+// parallel.cpp - Thread-count defaults for the fork/join helpers
+#include "parallel.h"
+#include <atomic>
+
+namespace {
+    std::atomic<int> g_threadCount(0);
+}
+
+namespace Parallel {
+
+    int DefaultThreadCount() {
+#ifdef __vita__
+        return 3;
+#else
+        unsigned int cores = std::thread::hardware_concurrency();
+        return cores > 0 ? (int)cores : 1;
+#endif
+    }
+
+    int ThreadCount() {
+        int threads = g_threadCount.load(std::memory_order_relaxed);
+        return threads > 0 ? threads : DefaultThreadCount();
+    }
+
+    void SetThreadCount(int threads) {
+        g_threadCount.store(threads > 0 ? threads : 0, std::memory_order_relaxed);
+    }
+}
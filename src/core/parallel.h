@@ -0,0 +1,51 @@
+// parallel.h - Fork/join helper for splitting work across CPU cores
+#pragma once
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace Parallel {
+
+    // Vita: the three cores available to applications. Host: every core.
+    int DefaultThreadCount();
+
+    // Global knob used by the parallel checksum paths (0 = default)
+    int ThreadCount();
+    void SetThreadCount(int threads);
+
+    // Splits [0, count) into at most `threads` contiguous chunks of at least
+    // `minChunk` items and calls fn(chunkIndex, begin, end) for each. Chunk 0
+    // runs on the calling thread. Returns the number of chunks used.
+    template <typename Fn>
+    int ForChunks(size_t count, size_t minChunk, int threads, Fn fn) {
+        if (count == 0) return 0;
+        if (minChunk == 0) minChunk = 1;
+
+        size_t maxChunks = (count + minChunk - 1) / minChunk;
+        int chunks = threads < 1 ? 1 : threads;
+        if ((size_t)chunks > maxChunks) chunks = (int)maxChunks;
+
+        size_t per = count / chunks;
+        size_t extra = count % chunks;
+        std::vector<std::thread> workers;
+        workers.reserve(chunks - 1);
+
+        size_t begin = 0;
+        size_t firstEnd = 0;
+        for (int i = 0; i < chunks; i++) {
+            size_t end = begin + per + ((size_t)i < extra ? 1 : 0);
+            if (i == 0) {
+                firstEnd = end;
+            } else {
+                workers.emplace_back(fn, i, begin, end);
+            }
+            begin = end;
+        }
+
+        fn(0, (size_t)0, firstEnd);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        return chunks;
+    }
+}
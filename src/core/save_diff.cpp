@@ -0,0 +1,227 @@
+// save_diff.cpp - Byte-level diff of two saves, annotated with table fields
+#include "save_diff.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SAVE_DIFF_HAVE_SSE2 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SAVE_DIFF_HAVE_NEON 1
+#endif
+
+namespace {
+
+    using SaveDiff::BLOCK_SIZE;
+
+    bool BlockEqualScalar(const uint8_t* a, const uint8_t* b) {
+        uint64_t diff = 0;
+        for (size_t i = 0; i < BLOCK_SIZE; i += 8) {
+            uint64_t x, y;
+            std::memcpy(&x, a + i, 8);
+            std::memcpy(&y, b + i, 8);
+            diff |= x ^ y;
+        }
+        return diff == 0;
+    }
+
+#ifdef SAVE_DIFF_HAVE_SSE2
+    bool BlockEqualSse2(const uint8_t* a, const uint8_t* b) {
+        const __m128i* pa = reinterpret_cast<const __m128i*>(a);
+        const __m128i* pb = reinterpret_cast<const __m128i*>(b);
+        __m128i eq = _mm_and_si128(
+            _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(pa), _mm_loadu_si128(pb)),
+                          _mm_cmpeq_epi8(_mm_loadu_si128(pa + 1), _mm_loadu_si128(pb + 1))),
+            _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(pa + 2), _mm_loadu_si128(pb + 2)),
+                          _mm_cmpeq_epi8(_mm_loadu_si128(pa + 3), _mm_loadu_si128(pb + 3))));
+        return _mm_movemask_epi8(eq) == 0xFFFF;
+    }
+#endif
+
+#ifdef SAVE_DIFF_HAVE_NEON
+    bool BlockEqualNeon(const uint8_t* a, const uint8_t* b) {
+        uint8x16_t diff = vorrq_u8(
+            vorrq_u8(veorq_u8(vld1q_u8(a), vld1q_u8(b)), veorq_u8(vld1q_u8(a + 16), vld1q_u8(b + 16))),
+            vorrq_u8(veorq_u8(vld1q_u8(a + 32), vld1q_u8(b + 32)), veorq_u8(vld1q_u8(a + 48), vld1q_u8(b + 48))));
+        uint64x2_t wide = vreinterpretq_u64_u8(diff);
+        return (vgetq_lane_u64(wide, 0) | vgetq_lane_u64(wide, 1)) == 0;
+    }
+#endif
+
+    typedef bool (*BlockEqualFn)(const uint8_t*, const uint8_t*);
+
+    BlockEqualFn Select(SaveDiff::Kernel kernel) {
+        switch (kernel) {
+#ifdef SAVE_DIFF_HAVE_SSE2
+            case SaveDiff::Kernel::SSE2: return BlockEqualSse2;
+#endif
+#ifdef SAVE_DIFF_HAVE_NEON
+            case SaveDiff::Kernel::NEON: return BlockEqualNeon;
+#endif
+            case SaveDiff::Kernel::SCALAR: return BlockEqualScalar;
+            default: break;
+        }
+#if defined(SAVE_DIFF_HAVE_SSE2)
+        return BlockEqualSse2;
+#elif defined(SAVE_DIFF_HAVE_NEON)
+        return BlockEqualNeon;
+#else
+        return BlockEqualScalar;
+#endif
+    }
+
+    // Collects changed bytes into ranges, joining across short equal gaps
+    class RangeBuilder {
+    public:
+        RangeBuilder(std::vector<DiffRange>& out, uint32_t mergeGap)
+            : out(out), mergeGap(mergeGap), open(false), start(0), end(0) {}
+
+        void Add(size_t from, size_t to) {
+            if (open && from <= (size_t)end + mergeGap) {
+                end = (uint32_t)to;
+                return;
+            }
+            Flush();
+            open = true;
+            start = (uint32_t)from;
+            end = (uint32_t)to;
+        }
+
+        void Flush() {
+            if (open) out.push_back(DiffRange{start, end - start});
+            open = false;
+        }
+
+    private:
+        std::vector<DiffRange>& out;
+        uint32_t mergeGap;
+        bool open;
+        uint32_t start;
+        uint32_t end;
+    };
+
+    void ScanBytes(const uint8_t* a, const uint8_t* b, size_t from, size_t to, RangeBuilder& ranges) {
+        size_t i = from;
+        while (i < to) {
+            if (a[i] == b[i]) {
+                i++;
+                continue;
+            }
+            size_t runStart = i;
+            while (i < to && a[i] != b[i]) i++;
+            ranges.Add(runStart, i);
+        }
+    }
+}
+
+FieldIndex::FieldIndex() : maxLength(1) {
+}
+
+void FieldIndex::Add(uint32_t offset, uint32_t length, FieldKind kind, uint8_t bit, size_t index, const char* name) {
+    // Offset 0 marks fields whose location is not known yet
+    if (offset == 0 || length == 0) return;
+    fields.push_back(FieldRef{offset, length, kind, bit, (uint16_t)index, name});
+    maxLength = std::max(maxLength, length);
+}
+
+void FieldIndex::Build(const GameData& game) {
+    fields.clear();
+    maxLength = 1;
+    for (size_t i = 0; i < game.values.size(); i++) {
+        Add(game.values[i].offset, game.values[i].byte_size, FieldKind::VALUE, 0, i, game.values[i].name);
+    }
+    for (size_t i = 0; i < game.extra_values.size(); i++) {
+        const GameValue& value = game.extra_values[i];
+        Add(value.offset, value.byte_size, FieldKind::EXTRA_VALUE, 0, i, value.name);
+    }
+    for (size_t i = 0; i < game.weapons.size(); i++) {
+        const GameWeapon& weapon = game.weapons[i];
+        Add(weapon.ammo_offset, weapon.byte_size, FieldKind::WEAPON, 0, i, weapon.name);
+    }
+    for (size_t i = 0; i < game.gadgets.size(); i++) {
+        const GameGadget& gadget = game.gadgets[i];
+        Add(gadget.offset, 1, FieldKind::GADGET, gadget.bit_index, i, gadget.name);
+    }
+    for (size_t i = 0; i < game.unlockables.size(); i++) {
+        const GameUnlockable& unlockable = game.unlockables[i];
+        Add(unlockable.offset, 1, FieldKind::UNLOCKABLE, unlockable.bit_index, i, unlockable.name);
+    }
+
+    std::stable_sort(fields.begin(), fields.end(), [](const FieldRef& x, const FieldRef& y) {
+        return x.offset < y.offset;
+    });
+}
+
+void FieldIndex::Find(uint32_t offset, uint32_t length, std::vector<const FieldRef*>& out) const {
+    // A field starting up to maxLength - 1 bytes before the range can still reach into it
+    uint32_t first = offset > maxLength - 1 ? offset - (maxLength - 1) : 0;
+    uint64_t end = (uint64_t)offset + length;
+    auto it = std::lower_bound(fields.begin(), fields.end(), first, [](const FieldRef& field, uint32_t value) {
+        return field.offset < value;
+    });
+    for (; it != fields.end() && it->offset < end; ++it) {
+        if ((uint64_t)it->offset + it->length > offset) out.push_back(&*it);
+    }
+}
+
+const char* FieldIndex::KindName(FieldKind kind) {
+    switch (kind) {
+        case FieldKind::VALUE: return "value";
+        case FieldKind::EXTRA_VALUE: return "extra value";
+        case FieldKind::WEAPON: return "weapon ammo";
+        case FieldKind::GADGET: return "gadget";
+        case FieldKind::UNLOCKABLE: return "unlockable";
+    }
+    return "?";
+}
+
+namespace SaveDiff {
+
+    void Compare(ByteView a, ByteView b, std::vector<DiffRange>& out, uint32_t mergeGap, Kernel kernel) {
+        BlockEqualFn blockEqual = Select(kernel);
+        RangeBuilder ranges(out, mergeGap);
+
+        size_t common = std::min(a.size(), b.size());
+        size_t blocks = common / BLOCK_SIZE * BLOCK_SIZE;
+        const uint8_t* pa = a.data();
+        const uint8_t* pb = b.data();
+        for (size_t pos = 0; pos < blocks; pos += BLOCK_SIZE) {
+            if (!blockEqual(pa + pos, pb + pos)) {
+                ScanBytes(pa, pb, pos, pos + BLOCK_SIZE, ranges);
+            }
+        }
+        ScanBytes(pa, pb, blocks, common, ranges);
+
+        size_t longer = std::max(a.size(), b.size());
+        if (longer > common) ranges.Add(common, longer);
+        ranges.Flush();
+    }
+
+    bool IsSupported(Kernel kernel) {
+        switch (kernel) {
+            case Kernel::AUTO:
+            case Kernel::SCALAR:
+                return true;
+#ifdef SAVE_DIFF_HAVE_SSE2
+            case Kernel::SSE2: return true;
+#endif
+#ifdef SAVE_DIFF_HAVE_NEON
+            case Kernel::NEON: return true;
+#endif
+            default: return false;
+        }
+    }
+
+    const char* KernelName(Kernel kernel) {
+        switch (kernel) {
+            case Kernel::AUTO: return "auto";
+            case Kernel::SCALAR: return "scalar";
+            case Kernel::SSE2: return "sse2";
+            case Kernel::NEON: return "neon";
+            default: return "?";
+        }
+    }
+}
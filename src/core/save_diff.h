@@ -0,0 +1,74 @@
+// save_diff.h - Byte-level diff of two saves, annotated with table fields
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "byte_view.h"
+#include "../data/rac_vita_games_data.h"
+
+struct DiffRange {
+    uint32_t offset;
+    uint32_t length;
+};
+
+enum class FieldKind : uint8_t {
+    VALUE,
+    EXTRA_VALUE,
+    WEAPON,         // The ammo count
+    GADGET,
+    UNLOCKABLE
+};
+
+struct FieldRef {
+    uint32_t offset;
+    uint32_t length;        // 4 for ints, 1 for flags
+    FieldKind kind;
+    uint8_t bitIndex;       // Flags only
+    uint16_t index;         // Row in the game's table of that kind
+    const char* name;
+};
+
+// Table fields sorted by offset. Fields are at most a few bytes long, so a
+// lookup is a binary search back by the longest length, then a short scan.
+class FieldIndex {
+public:
+    FieldIndex();
+
+    void Build(const GameData& game);
+
+    // Appends every field overlapping [offset, offset + length)
+    void Find(uint32_t offset, uint32_t length, std::vector<const FieldRef*>& out) const;
+
+    size_t GetCount() const { return fields.size(); }
+    static const char* KindName(FieldKind kind);
+
+private:
+    std::vector<FieldRef> fields;
+    uint32_t maxLength;
+
+    void Add(uint32_t offset, uint32_t length, FieldKind kind, uint8_t bit, size_t index, const char* name);
+};
+
+// Identical 64-byte blocks are skipped with wide compares (SSE2 on x86,
+// NEON on the Vita); only blocks that differ are walked byte by byte.
+namespace SaveDiff {
+
+    enum class Kernel {
+        AUTO = 0,       // Widest kernel this build supports
+        SCALAR,         // 64-bit words, kept as a baseline
+        SSE2,
+        NEON,
+        COUNT
+    };
+
+    static const size_t BLOCK_SIZE = 64;
+
+    // Appends the changed ranges of b relative to a, in offset order. Ranges
+    // separated by at most mergeGap equal bytes are joined into one. Bytes
+    // past the end of the shorter buffer count as changed.
+    void Compare(ByteView a, ByteView b, std::vector<DiffRange>& out, uint32_t mergeGap = 0,
+                 Kernel kernel = Kernel::AUTO);
+
+    bool IsSupported(Kernel kernel);
+    const char* KernelName(Kernel kernel);
+}
@@ -1,17 +1,23 @@
 // save_file.cpp - With checksum validation
 #include "save_file.h"
+#include "crc32.h"
+#include "parallel.h"
+#include <algorithm>
 #include <fstream>
 #include <cstring>
 
 SaveFile::SaveFile() 
-    : loaded(false), modified(false), checksumValid(true), 
-      storedChecksum(0), checksumOffset(0) {
+    : loaded(false), modified(false), checksumValid(true), version(0), reads(0),
+      storedChecksum(0), checksumOffset(0), fileCrc(0), needsFullRewrite(false) {
 }
 
 SaveFile::~SaveFile() {
 }
 
 bool SaveFile::Load(const std::string& path) {
+    // Finish (or drop) a save that was interrupted last time
+    SaveJournal::Recover(path);
+    
     std::ifstream file(path, std::ios::binary | std::ios::ate);
     if (!file.is_open()) return false;
     
@@ -19,6 +25,7 @@ bool SaveFile::Load(const std::string& path) {
     file.seekg(0, std::ios::beg);
     
     data.resize(size);
+    version++;
     if (!file.read(reinterpret_cast<char*>(data.data()), size)) {
         return false;
     }
@@ -26,9 +33,25 @@ bool SaveFile::Load(const std::string& path) {
     filePath = path;
     loaded = true;
     modified = false;
+    storedChecksum = 0;
+    checksumOffset = 0;
     
     // Try to detect and validate checksum
-    if (DetectChecksumLocation()) {
+    bool hasChecksum = DetectChecksumLocation();
+    BuildBlockCrcs();
+    
+    // What was just read is what is on disk
+    size_t blockCount = blockCrcs.size();
+    unsavedBlocks.assign(dirtyBlocks.size(), 0);
+    diskPageCrcs.resize(blockCount);
+    for (size_t block = 0; block < blockCount; block++) {
+        diskPageCrcs[block] = PageCrc(block);
+    }
+    needsFullRewrite = false;
+    lastSaveStats = SaveStats();
+    history.Clear();
+    
+    if (hasChecksum) {
         checksumValid = ValidateChecksum();
     } else {
         // No checksum found, assume valid
@@ -41,28 +64,97 @@ bool SaveFile::Load(const std::string& path) {
 bool SaveFile::Save() {
     if (!loaded) return false;
     
+    SaveDelta delta = CaptureChanges();
+    size_t journalBytes = 0;
+    JournalResult result = delta.pages.empty() ? JournalResult::OK
+                                               : SaveJournal::Apply(delta, &journalBytes);
+    CommitChanges(delta, result, journalBytes);
+    
+    // The file changed size (or vanished) behind our back: rewrite it whole
+    if (result == JournalResult::SIZE_MISMATCH) {
+        delta = CaptureChanges();
+        result = SaveJournal::Apply(delta, &journalBytes);
+        CommitChanges(delta, result, journalBytes);
+    }
+    
+    return result == JournalResult::OK;
+}
+
+SaveDelta SaveFile::CaptureChanges() {
+    SaveDelta delta;
+    delta.path = filePath;
+    delta.fileSize = (uint32_t)data.size();
+    delta.fullRewrite = needsFullRewrite;
+    
     // Recalculate checksum before saving if one exists
     if (checksumOffset > 0 && checksumOffset < data.size() - 4) {
         RecalculateChecksum();
     }
     
-    std::ofstream file(filePath, std::ios::binary);
-    if (!file.is_open()) return false;
+    // Brings blockCrcs up to date for every page we are about to compare
+    CalculateChecksumIncremental();
     
-    if (!file.write(reinterpret_cast<const char*>(data.data()), data.size())) {
-        return false;
+    for (size_t block = 0; block < diskPageCrcs.size(); block++) {
+        bool unsaved = (unsavedBlocks[block / 64] >> (block % 64)) & 1;
+        if (!unsaved && !needsFullRewrite) continue;
+        
+        // Edits that were undone by hand leave the page equal to the disk
+        uint32_t crc = PageCrc(block);
+        if (crc == diskPageCrcs[block] && !needsFullRewrite) continue;
+        
+        size_t start = block * CHECKSUM_BLOCK_SIZE;
+        size_t end = std::min(start + CHECKSUM_BLOCK_SIZE, data.size());
+        SavePage page;
+        page.offset = (uint32_t)start;
+        page.pageCrc = crc;
+        page.bytes.assign(data.begin() + start, data.begin() + end);
+        delta.pages.push_back(std::move(page));
+        
+        // Later captures compare against what this write will leave on disk,
+        // so reverting a page while the write is in flight is not lost
+        diskPageCrcs[block] = crc;
     }
     
-    modified = false;
-    return true;
+    std::fill(unsavedBlocks.begin(), unsavedBlocks.end(), 0);
+    return delta;
+}
+
+void SaveFile::CommitChanges(const SaveDelta& delta, JournalResult result, size_t journalBytes) {
+    lastSaveStats = SaveStats();
+    
+    if (result != JournalResult::OK) {
+        // What reached the disk is unknown, so the page CRCs recorded at
+        // capture can't be trusted; the next save writes everything
+        needsFullRewrite = true;
+        modified = true;
+        return;
+    }
+    
+    if (delta.fullRewrite) {
+        needsFullRewrite = false;
+    }
+    
+    lastSaveStats.pagesWritten = delta.pages.size();
+    lastSaveStats.bytesWritten = delta.PayloadBytes();
+    lastSaveStats.journalBytes = journalBytes;
+    lastSaveStats.skipped = delta.pages.empty();
+    
+    // Anything edited after the capture is still waiting for the next save
+    bool pending = needsFullRewrite;
+    for (uint64_t word : unsavedBlocks) {
+        pending = pending || word != 0;
+    }
+    modified = pending;
 }
 
 uint8_t SaveFile::ReadByte(uint32_t offset) const {
+    reads++;
     if (offset >= data.size()) return 0;
     return data[offset];
 }
 
 int32_t SaveFile::ReadInt32(uint32_t offset) const {
+    reads++;
     if (offset + 3 >= data.size()) return 0;
     
     int32_t value;
@@ -71,6 +163,7 @@ int32_t SaveFile::ReadInt32(uint32_t offset) const {
 }
 
 bool SaveFile::ReadBool(uint32_t offset, uint8_t bitIndex) const {
+    reads++;
     if (offset >= data.size() || bitIndex > 7) return false;
     
     uint8_t byte = data[offset];
@@ -80,15 +173,15 @@ bool SaveFile::ReadBool(uint32_t offset, uint8_t bitIndex) const {
 void SaveFile::WriteByte(uint32_t offset, uint8_t value) {
     if (offset >= data.size()) return;
     
-    data[offset] = value;
-    modified = true;
+    WriteBytes(offset, &value, 1, true);
 }
 
 void SaveFile::WriteInt32(uint32_t offset, int32_t value) {
     if (offset + 3 >= data.size()) return;
     
-    std::memcpy(&data[offset], &value, sizeof(int32_t));
-    modified = true;
+    uint8_t bytes[sizeof(int32_t)];
+    std::memcpy(bytes, &value, sizeof(int32_t));
+    WriteBytes(offset, bytes, sizeof(int32_t), true);
 }
 
 void SaveFile::WriteBool(uint32_t offset, bool value, uint8_t bitIndex) {
@@ -100,8 +193,29 @@ void SaveFile::WriteBool(uint32_t offset, bool value, uint8_t bitIndex) {
     } else {
         byte &= ~(1 << bitIndex);
     }
-    data[offset] = byte;
+    WriteBytes(offset, &byte, 1, true);
+}
+
+bool SaveFile::Undo() {
+    return history.Undo([this](uint32_t offset, const uint8_t* bytes, uint32_t length) {
+        WriteBytes(offset, bytes, length, false);
+    });
+}
+
+bool SaveFile::Redo() {
+    return history.Redo([this](uint32_t offset, const uint8_t* bytes, uint32_t length) {
+        WriteBytes(offset, bytes, length, false);
+    });
+}
+
+void SaveFile::WriteBytes(uint32_t offset, const uint8_t* bytes, uint32_t length, bool record) {
+    if (record) {
+        history.Record(offset, &data[offset], bytes, length);
+    }
+    std::memcpy(&data[offset], bytes, length);
+    MarkDirty(offset, length);
     modified = true;
+    version++;
 }
 
 bool SaveFile::DetectChecksumLocation() {
@@ -117,41 +231,138 @@ bool SaveFile::DetectChecksumLocation() {
 }
 
 uint32_t SaveFile::CalculateChecksum() const {
-    // Simple CRC32-like checksum
-    // Calculate over all data except the checksum itself
-    uint32_t checksum = 0xFFFFFFFF;
-    
-    for (size_t i = 0; i < data.size(); i++) {
-        // Skip checksum location
-        if (i >= checksumOffset && i < checksumOffset + 4) {
-            continue;
-        }
-        
-        checksum ^= data[i];
-        for (int j = 0; j < 8; j++) {
-            if (checksum & 1) {
-                checksum = (checksum >> 1) ^ 0xEDB88320;
-            } else {
-                checksum >>= 1;
+    // CRC32 over all data except the checksum itself, hashed as the two
+    // contiguous spans on either side of it
+    size_t holeStart = std::min<size_t>(checksumOffset, data.size());
+    size_t holeEnd = std::min<size_t>((size_t)checksumOffset + 4, data.size());
+    
+    uint32_t checksum = Crc32::Update(0, data.data(), holeStart);
+    return Crc32::Update(checksum, data.data() + holeEnd, data.size() - holeEnd);
+}
+
+uint32_t SaveFile::CalculateChecksumIncremental() {
+    for (size_t word = 0; word < dirtyBlocks.size(); word++) {
+        uint64_t bits = dirtyBlocks[word];
+        while (bits) {
+            size_t block = word * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            
+            uint32_t newCrc = HashBlock(block);
+            uint32_t delta = blockCrcs[block] ^ newCrc;
+            if (delta != 0) {
+                // CRCs of equal-length data differ by the CRC of their XOR,
+                // so shift the block's delta past everything hashed after it
+                size_t end = std::min((block + 1) * (size_t)CHECKSUM_BLOCK_SIZE, data.size());
+                fileCrc ^= Crc32::Combine(delta, 0, HashedBytes(end, data.size()));
+                blockCrcs[block] = newCrc;
             }
         }
+        dirtyBlocks[word] = 0;
     }
     
-    return ~checksum;
+    return fileCrc;
 }
 
 bool SaveFile::ValidateChecksum() {
     if (checksumOffset == 0) return true;  // No checksum
     
-    uint32_t calculated = CalculateChecksum();
+    uint32_t calculated = CalculateChecksumIncremental();
     return (calculated == storedChecksum);
 }
 
 void SaveFile::RecalculateChecksum() {
     if (checksumOffset == 0) return;  // No checksum
+    if ((size_t)checksumOffset + 4 > data.size()) return;
     
-    uint32_t newChecksum = CalculateChecksum();
-    WriteInt32(checksumOffset, newChecksum);
+    // Written directly: the hole is excluded from the block CRCs, so going
+    // through WriteInt32 would only dirty a block for nothing
+    uint32_t newChecksum = CalculateChecksumIncremental();
+    std::memcpy(&data[checksumOffset], &newChecksum, sizeof(uint32_t));
+    MarkUnsaved(checksumOffset, sizeof(uint32_t));
     storedChecksum = newChecksum;
     checksumValid = true;
-}
\ No newline at end of file
+    modified = true;
+}
+
+void SaveFile::BuildBlockCrcs() {
+    size_t blockCount = (data.size() + CHECKSUM_BLOCK_SIZE - 1) / CHECKSUM_BLOCK_SIZE;
+    blockCrcs.resize(blockCount);
+    dirtyBlocks.assign((blockCount + 63) / 64, 0);
+    
+    // Each worker hashes a contiguous run of blocks and folds them into a
+    // partial CRC; the partials are merged in order afterwards
+    int threads = Parallel::ThreadCount();
+    std::vector<uint32_t> partCrcs(threads);
+    std::vector<size_t> partLengths(threads);
+    uint32_t fullBlockOp = Crc32::MakeCombineOp(CHECKSUM_BLOCK_SIZE);
+    
+    int parts = Parallel::ForChunks(blockCount, Crc32::PARALLEL_MIN_CHUNK / CHECKSUM_BLOCK_SIZE, threads,
+        [&](int part, size_t first, size_t last) {
+            uint32_t crc = 0;
+            size_t length = 0;
+            for (size_t block = first; block < last; block++) {
+                size_t start = block * CHECKSUM_BLOCK_SIZE;
+                size_t end = std::min(start + CHECKSUM_BLOCK_SIZE, data.size());
+                size_t hashed = HashedBytes(start, end);
+                
+                blockCrcs[block] = HashBlock(block);
+                if (hashed == CHECKSUM_BLOCK_SIZE) {
+                    crc = Crc32::CombineWithOp(crc, blockCrcs[block], fullBlockOp);
+                } else {
+                    crc = Crc32::Combine(crc, blockCrcs[block], hashed);
+                }
+                length += hashed;
+            }
+            partCrcs[part] = crc;
+            partLengths[part] = length;
+        });
+    
+    fileCrc = 0;
+    for (int part = 0; part < parts; part++) {
+        fileCrc = Crc32::Combine(fileCrc, partCrcs[part], partLengths[part]);
+    }
+}
+
+void SaveFile::MarkDirty(uint32_t offset, uint32_t length) {
+    size_t first = offset / CHECKSUM_BLOCK_SIZE;
+    size_t last = (offset + length - 1) / CHECKSUM_BLOCK_SIZE;
+    for (size_t block = first; block <= last && block < blockCrcs.size(); block++) {
+        dirtyBlocks[block / 64] |= (uint64_t)1 << (block % 64);
+    }
+    MarkUnsaved(offset, length);
+}
+
+void SaveFile::MarkUnsaved(uint32_t offset, uint32_t length) {
+    size_t first = offset / CHECKSUM_BLOCK_SIZE;
+    size_t last = (offset + length - 1) / CHECKSUM_BLOCK_SIZE;
+    for (size_t block = first; block <= last && block < diskPageCrcs.size(); block++) {
+        unsavedBlocks[block / 64] |= (uint64_t)1 << (block % 64);
+    }
+}
+
+uint32_t SaveFile::HashBlock(size_t block) const {
+    size_t start = block * CHECKSUM_BLOCK_SIZE;
+    size_t end = std::min(start + CHECKSUM_BLOCK_SIZE, data.size());
+    size_t holeStart = std::clamp<size_t>(checksumOffset, start, end);
+    size_t holeEnd = std::clamp<size_t>((size_t)checksumOffset + 4, start, end);
+    
+    uint32_t crc = Crc32::Update(0, data.data() + start, holeStart - start);
+    return Crc32::Update(crc, data.data() + holeEnd, end - holeEnd);
+}
+
+uint32_t SaveFile::PageCrc(size_t block) const {
+    // Block CRCs skip the checksum hole, but the disk copy must match it too
+    size_t start = block * CHECKSUM_BLOCK_SIZE;
+    size_t end = std::min(start + CHECKSUM_BLOCK_SIZE, data.size());
+    if (HashedBytes(start, end) == end - start) {
+        return blockCrcs[block];
+    }
+    return Crc32::Update(0, data.data() + start, end - start);
+}
+
+size_t SaveFile::HashedBytes(size_t start, size_t end) const {
+    // [start, end) minus whatever part of the checksum hole falls inside it
+    size_t holeStart = std::clamp<size_t>(checksumOffset, start, end);
+    size_t holeEnd = std::clamp<size_t>((size_t)checksumOffset + 4, start, end);
+    return (end - start) - (holeEnd - holeStart);
+}
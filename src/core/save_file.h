@@ -3,6 +3,16 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include "byte_buffer.h"
+#include "edit_journal.h"
+#include "save_journal.h"
+
+struct SaveStats {
+    size_t pagesWritten = 0;
+    size_t bytesWritten = 0;    // Save payload, journal excluded
+    size_t journalBytes = 0;
+    bool skipped = false;       // Buffer already matched the file on disk
+};
 
 class SaveFile {
 public:
@@ -14,10 +24,21 @@ public:
     bool IsLoaded() const { return loaded; }
     bool IsModified() const { return modified; }
     bool IsChecksumValid() const { return checksumValid; }
+    const SaveStats& GetLastSaveStats() const { return lastSaveStats; }
+    
+    // Bumped by every change to the bytes (Load, writes, undo/redo), so
+    // caches of field values can tell when they are stale
+    uint64_t GetVersion() const { return version; }
     
     std::string GetPath() const { return filePath; }
     size_t GetSize() const { return data.size(); }
     
+    // Zero-copy access for detection and analysis; invalidated by Load
+    ByteView GetView() const { reads++; return data.View(); }
+    
+    // Read* and GetView calls so far, for profiling
+    uint64_t GetReadCount() const { return reads; }
+    
     // Read operations
     uint8_t ReadByte(uint32_t offset) const;
     int32_t ReadInt32(uint32_t offset) const;
@@ -28,20 +49,63 @@ public:
     void WriteInt32(uint32_t offset, int32_t value);
     void WriteBool(uint32_t offset, bool value, uint8_t bitIndex);
     
+    // Edit history. Writes between Begin/End undo as one step; see
+    // EditJournal for how mergeKey folds repeated edits together.
+    void BeginTransaction(uint32_t mergeKey = 0) { history.BeginTransaction(mergeKey); }
+    void EndTransaction() { history.EndTransaction(); }
+    bool Undo();
+    bool Redo();
+    bool CanUndo() const { return history.CanUndo(); }
+    bool CanRedo() const { return history.CanRedo(); }
+    
     // Checksum operations
     void RecalculateChecksum();
     bool ValidateChecksum();
-    uint32_t CalculateChecksum() const;
+    uint32_t CalculateChecksum() const;             // Full rehash of the buffer
+    uint32_t CalculateChecksumIncremental();        // Rehashes dirty blocks only
+    
+    // Save() in two halves: capture the pages that differ from disk (and
+    // refresh the checksum), then record how writing them went.
+    // SaveJournal::Apply does the I/O in between and may run on another thread.
+    SaveDelta CaptureChanges();
+    void CommitChanges(const SaveDelta& delta, JournalResult result, size_t journalBytes);
+    
+    static const uint32_t CHECKSUM_BLOCK_SIZE = 4096;   // Also the save page size
     
 private:
-    std::vector<uint8_t> data;
+    ByteBuffer data;
     std::string filePath;
     bool loaded;
     bool modified;
     bool checksumValid;
+    uint64_t version;
+    mutable uint64_t reads;
     
     uint32_t storedChecksum;
     uint32_t checksumOffset;  // Where checksum is stored in file
     
+    // Per-block CRCs (checksum hole excluded) and the whole-file CRC they
+    // add up to; Write* marks blocks dirty instead of invalidating it all
+    std::vector<uint32_t> blockCrcs;
+    std::vector<uint64_t> dirtyBlocks;
+    uint32_t fileCrc;
+    
+    // Pages written since the last save, and the CRC of each page as it is
+    // on disk once queued writes land; a page is only rewritten if its CRC
+    // no longer matches
+    std::vector<uint64_t> unsavedBlocks;
+    std::vector<uint32_t> diskPageCrcs;
+    bool needsFullRewrite;
+    SaveStats lastSaveStats;
+    
+    EditJournal history;
+    
     bool DetectChecksumLocation();
+    void BuildBlockCrcs();
+    void WriteBytes(uint32_t offset, const uint8_t* bytes, uint32_t length, bool record);
+    void MarkDirty(uint32_t offset, uint32_t length);
+    void MarkUnsaved(uint32_t offset, uint32_t length);
+    uint32_t HashBlock(size_t block) const;
+    uint32_t PageCrc(size_t block) const;
+    size_t HashedBytes(size_t start, size_t end) const;
 };
\ No newline at end of file
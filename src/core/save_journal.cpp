@@ -0,0 +1,207 @@
+// save_journal.cpp - Write-ahead journal for crash-safe, page-granular saves
+//
+// Journal layout (little-endian):
+//   "SLMJ" | version | fileSize | pageCount | flags
+//   pageCount x { offset | length | bytes }
+//   crc32 of everything above | "DONE"
+// A journal without a valid trailer was torn mid-write and is discarded.
+#include "save_journal.h"
+#include "crc32.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace {
+
+    const char JOURNAL_MAGIC[4] = {'S', 'L', 'M', 'J'};
+    const char COMMIT_MAGIC[4] = {'D', 'O', 'N', 'E'};
+    const uint32_t JOURNAL_VERSION = 1;
+    const uint32_t FLAG_FULL_REWRITE = 1;
+    const size_t HEADER_SIZE = 20;
+    const size_t TRAILER_SIZE = 8;
+
+    void Put32(std::vector<uint8_t>& out, uint32_t value) {
+        uint8_t bytes[4];
+        std::memcpy(bytes, &value, 4);
+        out.insert(out.end(), bytes, bytes + 4);
+    }
+
+    uint32_t Get32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, 4);
+        return value;
+    }
+
+    // stdio has no portable durability barrier; on the Vita the sceIo layer
+    // commits on close, on hosts fsync the descriptor as well
+    bool SyncFile(FILE* file) {
+        if (fflush(file) != 0) return false;
+#if defined(__unix__) || defined(__APPLE__)
+        if (fsync(fileno(file)) != 0) return false;
+#endif
+        return true;
+    }
+
+    long FileSize(FILE* file) {
+        if (fseek(file, 0, SEEK_END) != 0) return -1;
+        return ftell(file);
+    }
+
+    std::vector<uint8_t> Serialize(const SaveDelta& delta) {
+        std::vector<uint8_t> out;
+        out.reserve(HEADER_SIZE + delta.PayloadBytes() + delta.pages.size() * 8 + TRAILER_SIZE);
+
+        out.insert(out.end(), JOURNAL_MAGIC, JOURNAL_MAGIC + 4);
+        Put32(out, JOURNAL_VERSION);
+        Put32(out, delta.fileSize);
+        Put32(out, (uint32_t)delta.pages.size());
+        Put32(out, delta.fullRewrite ? FLAG_FULL_REWRITE : 0);
+
+        for (const SavePage& page : delta.pages) {
+            Put32(out, page.offset);
+            Put32(out, (uint32_t)page.bytes.size());
+            out.insert(out.end(), page.bytes.begin(), page.bytes.end());
+        }
+
+        Put32(out, Crc32::Update(0, out.data(), out.size()));
+        out.insert(out.end(), COMMIT_MAGIC, COMMIT_MAGIC + 4);
+        return out;
+    }
+
+    bool Deserialize(const std::vector<uint8_t>& in, SaveDelta& delta) {
+        if (in.size() < HEADER_SIZE + TRAILER_SIZE) return false;
+        if (std::memcmp(in.data(), JOURNAL_MAGIC, 4) != 0) return false;
+        if (std::memcmp(&in[in.size() - 4], COMMIT_MAGIC, 4) != 0) return false;
+
+        size_t bodySize = in.size() - TRAILER_SIZE;
+        if (Get32(&in[bodySize]) != Crc32::Update(0, in.data(), bodySize)) return false;
+        if (Get32(&in[4]) != JOURNAL_VERSION) return false;
+
+        delta.fileSize = Get32(&in[8]);
+        uint32_t pageCount = Get32(&in[12]);
+        delta.fullRewrite = (Get32(&in[16]) & FLAG_FULL_REWRITE) != 0;
+        delta.pages.clear();
+
+        size_t pos = HEADER_SIZE;
+        for (uint32_t i = 0; i < pageCount; i++) {
+            if (pos + 8 > bodySize) return false;
+            SavePage page;
+            page.offset = Get32(&in[pos]);
+            page.pageCrc = 0;
+            uint32_t length = Get32(&in[pos + 4]);
+            pos += 8;
+            if (length > bodySize - pos) return false;
+            if ((uint64_t)page.offset + length > delta.fileSize) return false;
+            page.bytes.assign(in.begin() + pos, in.begin() + pos + length);
+            pos += length;
+            delta.pages.push_back(std::move(page));
+        }
+
+        return pos == bodySize;
+    }
+
+    JournalResult WritePages(const SaveDelta& delta) {
+        if (delta.fullRewrite) {
+            FILE* file = fopen(delta.path.c_str(), "wb");
+            if (!file) return JournalResult::IO_ERROR;
+
+            bool ok = true;
+            for (const SavePage& page : delta.pages) {
+                ok = ok && fwrite(page.bytes.data(), 1, page.bytes.size(), file) == page.bytes.size();
+            }
+            ok = ok && SyncFile(file);
+            ok = (fclose(file) == 0) && ok;
+            return ok ? JournalResult::OK : JournalResult::IO_ERROR;
+        }
+
+        FILE* file = fopen(delta.path.c_str(), "r+b");
+        if (!file) return JournalResult::SIZE_MISMATCH;
+
+        if (FileSize(file) != (long)delta.fileSize) {
+            fclose(file);
+            return JournalResult::SIZE_MISMATCH;
+        }
+
+        bool ok = true;
+        for (const SavePage& page : delta.pages) {
+            ok = ok && fseek(file, page.offset, SEEK_SET) == 0;
+            ok = ok && fwrite(page.bytes.data(), 1, page.bytes.size(), file) == page.bytes.size();
+        }
+        ok = ok && SyncFile(file);
+        ok = (fclose(file) == 0) && ok;
+        return ok ? JournalResult::OK : JournalResult::IO_ERROR;
+    }
+}
+
+size_t SaveDelta::PayloadBytes() const {
+    size_t total = 0;
+    for (const SavePage& page : pages) {
+        total += page.bytes.size();
+    }
+    return total;
+}
+
+namespace SaveJournal {
+
+    std::string JournalPath(const std::string& savePath) {
+        return savePath + ".journal";
+    }
+
+    JournalResult Apply(const SaveDelta& delta, size_t* journalBytes) {
+        std::string journalPath = JournalPath(delta.path);
+        std::vector<uint8_t> journal = Serialize(delta);
+        if (journalBytes) *journalBytes = journal.size();
+
+        FILE* file = fopen(journalPath.c_str(), "wb");
+        if (!file) return JournalResult::IO_ERROR;
+
+        bool ok = fwrite(journal.data(), 1, journal.size(), file) == journal.size();
+        ok = ok && SyncFile(file);
+        ok = (fclose(file) == 0) && ok;
+        if (!ok) {
+            // Nothing has touched the save yet; a torn journal is just noise
+            remove(journalPath.c_str());
+            return JournalResult::IO_ERROR;
+        }
+
+        // On IO_ERROR the journal stays so the next Load can finish the job
+        JournalResult result = WritePages(delta);
+        if (result != JournalResult::IO_ERROR) {
+            remove(journalPath.c_str());
+        }
+        return result;
+    }
+
+    bool Recover(const std::string& savePath) {
+        std::string journalPath = JournalPath(savePath);
+        FILE* file = fopen(journalPath.c_str(), "rb");
+        if (!file) return false;
+
+        std::vector<uint8_t> journal;
+        long size = FileSize(file);
+        if (size > 0 && fseek(file, 0, SEEK_SET) == 0) {
+            journal.resize(size);
+            if (fread(journal.data(), 1, journal.size(), file) != journal.size()) {
+                journal.clear();
+            }
+        }
+        fclose(file);
+
+        SaveDelta delta;
+        delta.path = savePath;
+        if (!Deserialize(journal, delta)) {
+            // Torn journal: the save itself was never touched
+            remove(journalPath.c_str());
+            return false;
+        }
+
+        JournalResult result = WritePages(delta);
+        if (result != JournalResult::IO_ERROR) {
+            remove(journalPath.c_str());
+        }
+        return result == JournalResult::OK;
+    }
+}
@@ -0,0 +1,41 @@
+// save_journal.h - Write-ahead journal for crash-safe, page-granular saves
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct SavePage {
+    uint32_t offset;
+    uint32_t pageCrc;               // CRC of the page bytes at capture time
+    std::vector<uint8_t> bytes;
+};
+
+// Everything one save needs to put on disk. Pages are sorted by offset;
+// a full rewrite covers the whole file and truncates it.
+struct SaveDelta {
+    std::string path;
+    uint32_t fileSize = 0;
+    bool fullRewrite = false;
+    std::vector<SavePage> pages;
+
+    size_t PayloadBytes() const;
+};
+
+enum class JournalResult {
+    OK,
+    IO_ERROR,           // Journal may remain on disk; Recover() finishes it
+    SIZE_MISMATCH       // File on disk no longer matches what was loaded
+};
+
+namespace SaveJournal {
+    std::string JournalPath(const std::string& savePath);
+
+    // Writes and syncs the journal, applies the pages to the save with
+    // positioned writes, syncs, then drops the journal
+    JournalResult Apply(const SaveDelta& delta, size_t* journalBytes);
+
+    // Called before a save is read: replays a committed journal, discards a
+    // torn one (the save itself was never touched). Returns true if the save
+    // file was modified.
+    bool Recover(const std::string& savePath);
+}
@@ -0,0 +1,144 @@
+// save_worker.cpp - Background save thread with write coalescing
+#include "save_worker.h"
+
+SaveWorker::SaveWorker()
+    : hasPending(false), writing(false), stopping(false), backups(nullptr), backupFailures(0),
+      lastStatus(SaveStatus::IDLE) {
+    thread = std::thread(&SaveWorker::ThreadMain, this);
+}
+
+SaveWorker::~SaveWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    thread.join();
+}
+
+void SaveWorker::RequestSave(SaveFile* save) {
+    if (!save || !save->IsLoaded()) return;
+
+    SaveDelta delta = save->CaptureChanges();
+
+    if (delta.pages.empty()) {
+        // Nothing differs from disk, nothing to hand over
+        save->CommitChanges(delta, JournalResult::OK, 0);
+        if (!IsBusy()) lastStatus = SaveStatus::SAVED;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (hasPending) {
+            MergeInto(pending, delta);
+        } else {
+            pending = std::move(delta);
+            hasPending = true;
+        }
+    }
+    wake.notify_one();
+}
+
+void SaveWorker::Poll(SaveFile* save) {
+    std::vector<Job> jobs;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.swap(completed);
+    }
+
+    for (Job& job : jobs) {
+        if (save) {
+            save->CommitChanges(job.delta, job.result, job.journalBytes);
+        }
+        lastStatus = (job.result == JournalResult::OK) ? SaveStatus::SAVED : SaveStatus::FAILED;
+
+        // The file changed size on disk; the SaveFile now wants a full rewrite
+        if (job.result == JournalResult::SIZE_MISMATCH) {
+            RequestSave(save);
+        }
+    }
+}
+
+void SaveWorker::Flush(SaveFile* save) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [this] { return !hasPending && !writing; });
+        }
+        Poll(save);
+        if (!IsBusy()) return;
+    }
+}
+
+SaveStatus SaveWorker::GetStatus() const {
+    return IsBusy() ? SaveStatus::SAVING : lastStatus;
+}
+
+void SaveWorker::SetBackupStore(BackupStore* store) {
+    std::lock_guard<std::mutex> lock(mutex);
+    backups = store;
+}
+
+size_t SaveWorker::GetBackupFailures() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return backupFailures;
+}
+
+bool SaveWorker::IsBusy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hasPending || writing || !completed.empty();
+}
+
+void SaveWorker::ThreadMain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return stopping || hasPending; });
+
+        // Anything still queued is written before the thread exits
+        if (!hasPending) return;
+
+        Job job;
+        job.delta = std::move(pending);
+        job.journalBytes = 0;
+        hasPending = false;
+        writing = true;
+
+        BackupStore* store = backups;
+        lock.unlock();
+        // The file still holds the previous version until Apply runs
+        bool backedUp = !store || store->BackupFile(job.delta.path);
+        job.result = SaveJournal::Apply(job.delta, &job.journalBytes);
+        lock.lock();
+
+        if (!backedUp) backupFailures++;
+
+        writing = false;
+        completed.push_back(std::move(job));
+        finished.notify_all();
+    }
+}
+
+void SaveWorker::MergeInto(SaveDelta& target, SaveDelta& newer) {
+    // Both page lists are sorted by offset; the newer copy of a page wins
+    std::vector<SavePage> merged;
+    merged.reserve(target.pages.size() + newer.pages.size());
+
+    size_t i = 0, j = 0;
+    while (i < target.pages.size() || j < newer.pages.size()) {
+        if (j == newer.pages.size() ||
+            (i < target.pages.size() && target.pages[i].offset < newer.pages[j].offset)) {
+            merged.push_back(std::move(target.pages[i++]));
+        } else {
+            if (i < target.pages.size() && target.pages[i].offset == newer.pages[j].offset) {
+                i++;
+            }
+            merged.push_back(std::move(newer.pages[j++]));
+        }
+    }
+
+    target.pages = std::move(merged);
+    target.path = newer.path;
+    target.fileSize = newer.fileSize;
+    target.fullRewrite = target.fullRewrite || newer.fullRewrite;
+}
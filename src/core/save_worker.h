@@ -0,0 +1,70 @@
+// save_worker.h - Background save thread with write coalescing
+#pragma once
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "backup_store.h"
+#include "save_file.h"
+
+enum class SaveStatus {
+    IDLE,       // Nothing saved yet in this session
+    SAVING,
+    SAVED,
+    FAILED
+};
+
+// The UI thread captures the changed pages (cheap, no I/O) and hands the
+// copy to the worker, which journals and writes it. Only the worker touches
+// the disk; only the UI thread touches the SaveFile. With a backup store
+// set, the file as it is on disk is backed up before each write lands.
+class SaveWorker {
+public:
+    SaveWorker();
+    ~SaveWorker();
+
+    // A request made while a write is in flight is merged into the single
+    // queued follow-up write instead of queueing another one
+    void RequestSave(SaveFile* save);
+
+    // Once per frame: commits finished writes back into the SaveFile
+    void Poll(SaveFile* save);
+
+    // Blocks until everything queued is written and committed
+    void Flush(SaveFile* save);
+
+    SaveStatus GetStatus() const;
+    bool IsBusy() const;
+
+    // Backups are best effort: a failed backup is counted, the save still
+    // goes ahead. The store must outlive the worker.
+    void SetBackupStore(BackupStore* store);
+    size_t GetBackupFailures() const;
+
+private:
+    struct Job {
+        SaveDelta delta;
+        JournalResult result;
+        size_t journalBytes;
+    };
+
+    void ThreadMain();
+    static void MergeInto(SaveDelta& target, SaveDelta& newer);
+
+    std::thread thread;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    // Guarded by mutex
+    bool hasPending;
+    bool writing;
+    bool stopping;
+    SaveDelta pending;
+    std::vector<Job> completed;
+    BackupStore* backups;
+    size_t backupFailures;
+
+    // UI thread only
+    SaveStatus lastStatus;
+};
@@ -0,0 +1,324 @@
+// value_scanner.cpp - Narrowing scans for the offset of an unknown value
+#include "value_scanner.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VALUE_SCANNER_HAVE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define VALUE_SCANNER_HAVE_NEON 1
+#endif
+
+namespace {
+
+    // Offsets handled per bitmap word
+    const size_t WORD_BITS = 64;
+
+    int32_t ReadSigned(const uint8_t* p, uint32_t width) {
+        switch (width) {
+            case 1: return (int8_t)p[0];
+            case 2: {
+                int16_t value;
+                std::memcpy(&value, p, 2);
+                return value;
+            }
+            default: {
+                int32_t value;
+                std::memcpy(&value, p, 4);
+                return value;
+            }
+        }
+    }
+
+    bool Holds(ScanPredicate predicate, int32_t before, int32_t after, int32_t value) {
+        switch (predicate) {
+            case ScanPredicate::EQUALS: return after == value;
+            case ScanPredicate::CHANGED: return after != before;
+            case ScanPredicate::UNCHANGED: return after == before;
+            case ScanPredicate::INCREASED: return after > before;
+            case ScanPredicate::DECREASED: return after < before;
+        }
+        return false;
+    }
+
+    // Both kernels produce one bit per offset pos..pos+63 and read bytes up
+    // to pos + 63 + width - 1, which callers guarantee are in range.
+    // Equality of a `width`-byte run is the AND of `width` shifted bytewise
+    // compares, so all offsets of a 16-byte chunk are settled at once.
+#if defined(VALUE_SCANNER_HAVE_SSE2)
+    uint64_t MaskEquals(const uint8_t* p, uint32_t width, const uint8_t pattern[4]) {
+        uint64_t mask = 0;
+        for (int chunk = 0; chunk < 4; chunk++) {
+            const uint8_t* q = p + chunk * 16;
+            __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(q)), _mm_set1_epi8((char)pattern[0]));
+            for (uint32_t k = 1; k < width; k++) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(q + k));
+                eq = _mm_and_si128(eq, _mm_cmpeq_epi8(bytes, _mm_set1_epi8((char)pattern[k])));
+            }
+            mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(eq) << (chunk * 16);
+        }
+        return mask;
+    }
+
+    uint64_t MaskUnchanged(const uint8_t* a, const uint8_t* b, uint32_t width) {
+        uint64_t mask = 0;
+        for (int chunk = 0; chunk < 4; chunk++) {
+            __m128i eq = _mm_set1_epi8((char)0xFF);
+            for (uint32_t k = 0; k < width; k++) {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + chunk * 16 + k));
+                __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + chunk * 16 + k));
+                eq = _mm_and_si128(eq, _mm_cmpeq_epi8(x, y));
+            }
+            mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(eq) << (chunk * 16);
+        }
+        return mask;
+    }
+#elif defined(VALUE_SCANNER_HAVE_NEON)
+    // NEON has no movemask: weight each lane by its bit and add pairwise
+    uint64_t MoveMask(uint8x16_t eq) {
+        static const uint8_t WEIGHTS[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+        uint8x16_t bits = vandq_u8(eq, vld1q_u8(WEIGHTS));
+        uint8x8_t sum = vpadd_u8(vget_low_u8(bits), vget_high_u8(bits));
+        sum = vpadd_u8(sum, sum);
+        sum = vpadd_u8(sum, sum);
+        return (uint64_t)vget_lane_u8(sum, 0) | ((uint64_t)vget_lane_u8(sum, 1) << 8);
+    }
+
+    uint64_t MaskEquals(const uint8_t* p, uint32_t width, const uint8_t pattern[4]) {
+        uint64_t mask = 0;
+        for (int chunk = 0; chunk < 4; chunk++) {
+            const uint8_t* q = p + chunk * 16;
+            uint8x16_t eq = vceqq_u8(vld1q_u8(q), vdupq_n_u8(pattern[0]));
+            for (uint32_t k = 1; k < width; k++) {
+                eq = vandq_u8(eq, vceqq_u8(vld1q_u8(q + k), vdupq_n_u8(pattern[k])));
+            }
+            mask |= MoveMask(eq) << (chunk * 16);
+        }
+        return mask;
+    }
+
+    uint64_t MaskUnchanged(const uint8_t* a, const uint8_t* b, uint32_t width) {
+        uint64_t mask = 0;
+        for (int chunk = 0; chunk < 4; chunk++) {
+            uint8x16_t eq = vdupq_n_u8(0xFF);
+            for (uint32_t k = 0; k < width; k++) {
+                eq = vandq_u8(eq, vceqq_u8(vld1q_u8(a + chunk * 16 + k), vld1q_u8(b + chunk * 16 + k)));
+            }
+            mask |= MoveMask(eq) << (chunk * 16);
+        }
+        return mask;
+    }
+#else
+    uint64_t MaskEquals(const uint8_t* p, uint32_t width, const uint8_t pattern[4]) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < WORD_BITS; i++) {
+            if (std::memcmp(p + i, pattern, width) == 0) mask |= 1ull << i;
+        }
+        return mask;
+    }
+
+    uint64_t MaskUnchanged(const uint8_t* a, const uint8_t* b, uint32_t width) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < WORD_BITS; i++) {
+            if (std::memcmp(a + i, b + i, width) == 0) mask |= 1ull << i;
+        }
+        return mask;
+    }
+#endif
+
+    size_t PopCount(uint64_t bits) {
+        return (size_t)__builtin_popcountll(bits);
+    }
+
+    int LowestBit(uint64_t bits) {
+        return __builtin_ctzll(bits);
+    }
+}
+
+ValueScanner::ValueScanner() : width(0), count(0), limit(0), dense(true) {
+}
+
+void ValueScanner::Reset() {
+    width = 0;
+    count = 0;
+    limit = 0;
+    dense = true;
+    std::vector<uint64_t>().swap(bitmap);
+    std::vector<uint32_t>().swap(offsets);
+    std::vector<uint8_t>().swap(previous);
+}
+
+void ValueScanner::Start(ByteView save, uint32_t scanWidth) {
+    Reset();
+    width = (scanWidth == 1 || scanWidth == 2) ? scanWidth : 4;
+    limit = save.size() >= width ? save.size() - width + 1 : 0;
+
+    // Every offset starts as a candidate; bits past the limit stay clear
+    bitmap.assign((limit + WORD_BITS - 1) / WORD_BITS, ~0ull);
+    if (limit % WORD_BITS != 0) bitmap.back() = (1ull << (limit % WORD_BITS)) - 1;
+    count = limit;
+}
+
+size_t ValueScanner::First(ByteView save, uint32_t scanWidth, int32_t value) {
+    Start(save, scanWidth);
+    NarrowDense(save, ScanPredicate::EQUALS, value);
+    Compact();
+    Remember(save);
+    return count;
+}
+
+size_t ValueScanner::First(ByteView save, uint32_t scanWidth) {
+    Start(save, scanWidth);
+    Remember(save);
+    return count;
+}
+
+size_t ValueScanner::Next(ByteView save, ScanPredicate predicate, int32_t value) {
+    if (!IsActive()) return 0;
+
+    // Offsets must hold a whole value in both saves
+    size_t saveLimit = save.size() >= width ? save.size() - width + 1 : 0;
+    limit = std::min(limit, saveLimit);
+
+    if (dense) {
+        NarrowDense(save, predicate, value);
+    } else {
+        NarrowSparse(save, predicate, value);
+    }
+    Compact();
+    Remember(save);
+    return count;
+}
+
+void ValueScanner::NarrowDense(ByteView save, ScanPredicate predicate, int32_t value) {
+    uint8_t pattern[4];
+    std::memcpy(pattern, &value, 4);
+    if (width == 1) value = (int8_t)value;
+    if (width == 2) value = (int16_t)value;
+
+    const uint8_t* now = save.data();
+    const uint8_t* before = previous.data();
+    bool compares = predicate != ScanPredicate::EQUALS;
+
+    // The vector kernels read up to width - 1 bytes past a word's last offset
+    size_t words = (limit + WORD_BITS - 1) / WORD_BITS;
+    size_t readable = std::min(save.size(), compares ? previous.size() : save.size());
+    for (size_t word = words; word < bitmap.size(); word++) bitmap[word] = 0;
+
+    for (size_t word = 0; word < words; word++) {
+        uint64_t bits = bitmap[word];
+        if (bits == 0) continue;
+
+        size_t pos = word * WORD_BITS;
+        if (pos + WORD_BITS + width - 1 <= readable) {
+            switch (predicate) {
+                case ScanPredicate::EQUALS:
+                    bits &= MaskEquals(now + pos, width, pattern);
+                    break;
+                case ScanPredicate::UNCHANGED:
+                    bits &= MaskUnchanged(before + pos, now + pos, width);
+                    break;
+                case ScanPredicate::CHANGED:
+                    bits &= ~MaskUnchanged(before + pos, now + pos, width);
+                    break;
+                case ScanPredicate::INCREASED:
+                case ScanPredicate::DECREASED: {
+                    // Only values whose bytes moved need the signed compare
+                    uint64_t changed = bits & ~MaskUnchanged(before + pos, now + pos, width);
+                    bits = 0;
+                    while (changed) {
+                        int bit = LowestBit(changed);
+                        changed &= changed - 1;
+                        size_t offset = pos + bit;
+                        if (Holds(predicate, ReadSigned(before + offset, width), ReadSigned(now + offset, width), 0)) {
+                            bits |= 1ull << bit;
+                        }
+                    }
+                    break;
+                }
+            }
+        } else {
+            // Last word: offsets near the end, one at a time
+            uint64_t kept = 0;
+            while (bits) {
+                int bit = LowestBit(bits);
+                bits &= bits - 1;
+                size_t offset = pos + bit;
+                if (offset >= limit) continue;
+                int32_t after = ReadSigned(now + offset, width);
+                int32_t prior = compares ? ReadSigned(before + offset, width) : 0;
+                if (Holds(predicate, prior, after, value)) kept |= 1ull << bit;
+            }
+            bits = kept;
+        }
+        bitmap[word] = bits;
+    }
+}
+
+void ValueScanner::NarrowSparse(ByteView save, ScanPredicate predicate, int32_t value) {
+    if (width == 1) value = (int8_t)value;
+    if (width == 2) value = (int16_t)value;
+
+    const uint8_t* now = save.data();
+    const uint8_t* before = previous.data();
+    bool compares = predicate != ScanPredicate::EQUALS;
+
+    size_t kept = 0;
+    for (uint32_t offset : offsets) {
+        if (offset >= limit) break;
+        int32_t after = ReadSigned(now + offset, width);
+        int32_t prior = compares ? ReadSigned(before + offset, width) : 0;
+        if (Holds(predicate, prior, after, value)) offsets[kept++] = offset;
+    }
+    offsets.resize(kept);
+}
+
+void ValueScanner::Compact() {
+    if (!dense) {
+        count = offsets.size();
+        return;
+    }
+
+    count = 0;
+    for (uint64_t bits : bitmap) count += PopCount(bits);
+
+    // A sorted array costs 32 bits per candidate against 1 bit per offset
+    if (count * SPARSE_RATIO >= limit) return;
+
+    offsets.reserve(count);
+    for (size_t word = 0; word < bitmap.size(); word++) {
+        uint64_t bits = bitmap[word];
+        while (bits) {
+            offsets.push_back((uint32_t)(word * WORD_BITS + LowestBit(bits)));
+            bits &= bits - 1;
+        }
+    }
+    std::vector<uint64_t>().swap(bitmap);
+    dense = false;
+}
+
+void ValueScanner::Remember(ByteView save) {
+    previous.assign(save.begin(), save.end());
+}
+
+void ValueScanner::GetCandidates(std::vector<uint32_t>& out, size_t maxCount) const {
+    out.clear();
+    if (!dense) {
+        out.assign(offsets.begin(), offsets.begin() + std::min(maxCount, offsets.size()));
+        return;
+    }
+    for (size_t word = 0; word < bitmap.size() && out.size() < maxCount; word++) {
+        uint64_t bits = bitmap[word];
+        while (bits && out.size() < maxCount) {
+            out.push_back((uint32_t)(word * WORD_BITS + LowestBit(bits)));
+            bits &= bits - 1;
+        }
+    }
+}
+
+int32_t ValueScanner::GetValue(uint32_t offset) const {
+    if (!IsActive() || offset + width > previous.size()) return 0;
+    return ReadSigned(previous.data() + offset, width);
+}
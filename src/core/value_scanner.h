@@ -0,0 +1,66 @@
+// value_scanner.h - Narrowing scans for the offset of an unknown value
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "byte_view.h"
+
+enum class ScanPredicate {
+    EQUALS,         // Holds the given value
+    CHANGED,
+    UNCHANGED,
+    INCREASED,      // Signed compare against the previous save
+    DECREASED
+};
+
+// Finds where a value lives by scanning one save for it, then narrowing the
+// candidates against later saves of the same slot, Cheat Engine style.
+// Every offset is a candidate, aligned or not; values are little-endian
+// signed ints of 1, 2 or 4 bytes, and EQUALS matches on the low `width`
+// bytes of the value, so 200 finds an int8 holding 0xC8.
+//
+// Candidates are a bitmap (one bit per offset) while they are many and a
+// sorted offset array once that is smaller. Bitmap passes compare 64
+// offsets at a time with SSE2 or NEON; INCREASED/DECREASED only do the
+// signed compare for offsets whose bytes changed.
+class ValueScanner {
+public:
+    ValueScanner();
+
+    // Starts a scan; First(save, width) keeps every offset, for values
+    // whose current number is not known. Both return the candidate count.
+    size_t First(ByteView save, uint32_t width, int32_t value);
+    size_t First(ByteView save, uint32_t width);
+
+    // Keeps the candidates for which the predicate holds between the
+    // previous save and this one; value is only used by EQUALS
+    size_t Next(ByteView save, ScanPredicate predicate, int32_t value = 0);
+
+    void Reset();
+    bool IsActive() const { return width != 0; }
+    size_t GetCount() const { return count; }
+    uint32_t GetWidth() const { return width; }
+    bool IsDense() const { return dense; }
+
+    // Up to limit candidates in offset order, with their current values
+    void GetCandidates(std::vector<uint32_t>& offsets, size_t limit) const;
+    int32_t GetValue(uint32_t offset) const;
+
+    // Candidates above this fraction of the offsets are kept as a bitmap
+    static const size_t SPARSE_RATIO = 32;
+
+private:
+    uint32_t width;
+    size_t count;
+    size_t limit;               // Offsets a candidate can start at
+    bool dense;
+    std::vector<uint64_t> bitmap;
+    std::vector<uint32_t> offsets;
+    std::vector<uint8_t> previous;     // The save the next step compares against
+
+    void Start(ByteView save, uint32_t scanWidth);
+    void NarrowDense(ByteView save, ScanPredicate predicate, int32_t value);
+    void NarrowSparse(ByteView save, ScanPredicate predicate, int32_t value);
+    void Compact();
+    void Remember(ByteView save);
+};
@@ -0,0 +1,110 @@
+// work_pool.cpp - Work-stealing thread pool for independent tasks
+#include "work_pool.h"
+
+namespace {
+    // Which pool and worker the calling thread is, if any
+    thread_local const WorkPool* currentPool = nullptr;
+    thread_local int currentWorker = -1;
+}
+
+WorkPool::WorkPool(int threadCount)
+    : queued(0), unfinished(0), nextQueue(0), sleepers(0), steals(0), stopping(false) {
+    if (threadCount < 1) threadCount = 1;
+
+    for (int i = 0; i < threadCount; i++) {
+        queues.emplace_back(new Queue());
+    }
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back(&WorkPool::WorkerMain, this, i);
+    }
+}
+
+WorkPool::~WorkPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkPool::Submit(Task task) {
+    size_t target = currentPool == this ? (size_t)currentWorker
+                                        : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    unfinished.fetch_add(1);
+    {
+        // Counted under the deque's lock, so a thief can't take it first
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+        queued.fetch_add(1);
+    }
+
+    // A worker going to sleep counts itself before it last checks queued,
+    // so either it sees this task or we see it
+    if (sleepers.load() > 0) {
+        { std::lock_guard<std::mutex> lock(stateMutex); }
+        wake.notify_one();
+    }
+}
+
+void WorkPool::Wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    done.wait(lock, [this] { return unfinished.load() == 0; });
+}
+
+void WorkPool::Finished() {
+    if (unfinished.fetch_sub(1) == 1) {
+        { std::lock_guard<std::mutex> lock(stateMutex); }
+        done.notify_all();
+    }
+}
+
+void WorkPool::WorkerMain(int worker) {
+    currentPool = this;
+    currentWorker = worker;
+
+    Task task;
+    for (;;) {
+        if (TryPop(worker, task)) {
+            task(worker);
+            task = nullptr;
+            Finished();
+            continue;
+        }
+
+        // Every deque looked empty; sleep until a task is queued
+        std::unique_lock<std::mutex> lock(stateMutex);
+        sleepers.fetch_add(1);
+        wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+        sleepers.fetch_sub(1);
+        if (stopping && queued.load() == 0) return;
+    }
+}
+
+bool WorkPool::TryPop(int worker, Task& task) {
+    {
+        Queue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < queues.size(); i++) {
+        Queue& victim = *queues[(worker + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1);
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
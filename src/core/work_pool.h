@@ -0,0 +1,64 @@
+// work_pool.h - Work-stealing thread pool for independent tasks
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Each worker owns a deque: it takes its own work from the back and, when
+// that runs dry, steals from the front of the others'. A deque's lock is
+// only ever shared with the submitter and thieves, so a busy worker never
+// touches the pool-wide lock; that is taken only to go to sleep when every
+// deque is empty, to be woken and when the last task finishes.
+//
+// Tasks submitted from outside are dealt round-robin; a task submitted by
+// a worker goes on that worker's own deque. Tasks are handed the index of
+// the worker running them, so callers can keep per-worker state (a
+// reusable SaveFile, say) without locking.
+class WorkPool {
+public:
+    typedef std::function<void(int worker)> Task;
+
+    explicit WorkPool(int threads);
+    ~WorkPool();
+
+    WorkPool(const WorkPool&) = delete;
+    WorkPool& operator=(const WorkPool&) = delete;
+
+    void Submit(Task task);
+
+    // Blocks until every submitted task has finished
+    void Wait();
+
+    int GetThreadCount() const { return (int)threads.size(); }
+    size_t GetStealCount() const { return steals.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void WorkerMain(int worker);
+    bool TryPop(int worker, Task& task);
+    void Finished();
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+
+    std::atomic<size_t> queued;         // In a deque, not yet taken
+    std::atomic<size_t> unfinished;     // Submitted, not yet run to the end
+    std::atomic<size_t> nextQueue;      // Round-robin for outside submitters
+    std::atomic<int> sleepers;          // Workers waiting on wake
+    std::atomic<size_t> steals;
+
+    // Only for sleeping and waking
+    std::mutex stateMutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stopping;                      // Guarded by stateMutex
+};
@@ -6,8 +6,7 @@
 #ifndef RAC_VITA_GAMES_DATA_H
 #define RAC_VITA_GAMES_DATA_H
 
-#include <vector>
-#include <string>
+#include <cstddef>
 #include <cstdint>
 
 enum class GameType {
@@ -17,9 +16,12 @@ enum class GameType {
     RAC3_VITA
 };
 
+// Tables are constexpr arrays of plain records: no static constructors, one
+// copy for the whole program (inline variables), names and descriptions in
+// the linker-merged string literal pool.
 struct GameValue {
-    std::string name;
-    std::string description;
+    const char* name;
+    const char* description;
     uint32_t offset;
     int32_t min_value;
     int32_t max_value;
@@ -27,8 +29,8 @@ struct GameValue {
 };
 
 struct GameWeapon {
-    std::string name;
-    std::string description;
+    const char* name;
+    const char* description;
     uint32_t ammo_offset;
     int32_t min_ammo;
     int32_t max_ammo;
@@ -36,15 +38,15 @@ struct GameWeapon {
 };
 
 struct GameGadget {
-    std::string name;
-    std::string description;
+    const char* name;
+    const char* description;
     uint32_t offset;
     uint8_t bit_index;
 };
 
 struct GameUnlockable {
-    std::string name;
-    std::string description;
+    const char* name;
+    const char* description;
     uint32_t offset;
     uint8_t bit_index;
 };
@@ -54,11 +56,11 @@ struct GameUnlockable {
 // ============================================================================
 
 namespace RAC1_VITA_DATA {
-    static const std::vector<GameValue> VALUES = {
+    inline constexpr GameValue VALUES[] = {
         {"Bolts", "Current bolt count", 36, 0, 999999, 4},
     };
 
-    static const std::vector<GameWeapon> WEAPONS = {
+    inline constexpr GameWeapon WEAPONS[] = {
         {"Bomb Glove", "Starting weapon", 324, 0, 40, 4},
         {"Pyrocitor", "Flamethrower", 348, 0, 240, 4},
         {"Blaster", "Rapid fire pistol", 344, 0, 200, 4},
@@ -72,7 +74,7 @@ namespace RAC1_VITA_DATA {
         {"Decoy Glove", "Spawns decoy", 384, 0, 20, 4},
     };
 
-    static const std::vector<GameGadget> GADGETS = {
+    inline constexpr GameGadget GADGETS[] = {
         {"Heli-Pack", "Helicopter backpack", 442, 0},
         {"Thruster-Pack", "Jetpack", 443, 0},
         {"Hydro-Pack", "Underwater propulsion", 444, 0},
@@ -93,7 +95,7 @@ namespace RAC1_VITA_DATA {
         {"Persuader", "Unlock doors", 475, 0},
     };
 
-    static const std::vector<GameUnlockable> UNLOCKABLES = {
+    inline constexpr GameUnlockable UNLOCKABLES[] = {
         {"Suck Cannon Owned", "Unlock Suck Cannon", 449, 0},
         {"Bomb Glove Owned", "Unlock Bomb Glove", 450, 0},
         {"Devastator Owned", "Unlock Devastator", 451, 0},
@@ -118,12 +120,12 @@ namespace RAC1_VITA_DATA {
 // ============================================================================
 
 namespace RAC2_VITA_DATA {
-    static const std::vector<GameValue> VALUES = {
+    inline constexpr GameValue VALUES[] = {
         {"Bolts", "Current bolt count", 36, 0, 9999999, 4},
         {"Raritanium", "Upgrade currency", 40, 0, 99999, 4},
     };
 
-    static const std::vector<GameWeapon> WEAPONS = {
+    inline constexpr GameWeapon WEAPONS[] = {
         // MEGACORP WEAPONS - Max set to Ultra level
         {"Lancer", "Basic pistol", 544, 0, 300, 4},
         {"Gravity Bomb", "Gravity weapon", 0, 0, 12, 4},
@@ -150,7 +152,7 @@ namespace RAC2_VITA_DATA {
         {"Zodiac", "Ultimate weapon", 596, 0, 4, 4},
     };
 
-    static const std::vector<GameGadget> GADGETS = {
+    inline constexpr GameGadget GADGETS[] = {
         {"Heli-Pack", "Helicopter pack", 658, 0},
         {"Thruster-Pack", "Jetpack", 659, 0},
         {"Hydro-Pack", "Water propulsion", 660, 0},
@@ -172,7 +174,7 @@ namespace RAC2_VITA_DATA {
         {"Hypnomatic", "Mind control", 711, 0},
     };
 
-    static const std::vector<GameUnlockable> UNLOCKABLES = {
+    inline constexpr GameUnlockable UNLOCKABLES[] = {
         {"Clank Zapper Owned", "Unlock Clank Zapper", 665, 0},
         {"Bomb Glove Owned", "Unlock Bomb Glove", 668, 0},
         {"Visibomb Gun Owned", "Unlock Visibomb Gun", 670, 0},
@@ -206,12 +208,12 @@ namespace RAC2_VITA_DATA {
 // ============================================================================
 
 namespace RAC3_VITA_DATA {
-    static const std::vector<GameValue> VALUES = {
+    inline constexpr GameValue VALUES[] = {
         {"Bolts", "Current bolt count", 36, 0, 9999999, 4},
     };
 
     // MAIN RC3 WEAPONS (~20 total) - Max ammo at V8
-    static const std::vector<GameWeapon> WEAPONS = {
+    inline constexpr GameWeapon WEAPONS[] = {
         {"Shock Blaster", "Electric pistol", 716, 0, 100, 4},
         {"Nitro Launcher", "Rocket launcher", 1036, 0, 40, 4},
         {"N60 Storm", "Machine gun", 748, 0, 300, 4},
@@ -229,7 +231,7 @@ namespace RAC3_VITA_DATA {
     };
 
     // WEAPON EXP VALUES
-    static const std::vector<GameValue> WEAPON_EXP = {
+    inline constexpr GameValue WEAPON_EXP[] = {
         {"Shock Blaster EXP", "Weapon experience", 1676, 0, 999999, 4},
         {"N60 Storm EXP", "Weapon experience", 1708, 0, 999999, 4},
         {"Infector EXP", "Weapon experience", 1740, 0, 999999, 4},
@@ -247,7 +249,7 @@ namespace RAC3_VITA_DATA {
     };
 
     // GADGETS (non-weapon items)
-    static const std::vector<GameGadget> GADGETS = {
+    inline constexpr GameGadget GADGETS[] = {
         {"Heli Pack", "Helicopter pack", 1194, 0},
         {"Thruster Pack", "Jetpack", 1195, 0},
         {"Hydro Pack", "Water propulsion", 1196, 0},
@@ -270,7 +272,7 @@ namespace RAC3_VITA_DATA {
     };
 
     // UNLOCKABLES: Main weapon unlocks + RC2 returning weapons WITH AMMO
-    static const std::vector<GameUnlockable> UNLOCKABLES = {
+    inline constexpr GameUnlockable UNLOCKABLES[] = {
         // Main RC3 weapon unlocks
         {"Shock Blaster V1 Owned", "Unlock Shock Blaster", 1231, 0},
         {"N60 Storm V1 Owned", "Unlock N60 Storm", 1239, 0},
@@ -300,18 +302,37 @@ namespace RAC3_VITA_DATA {
 // GAME DATA WRAPPER
 // ============================================================================
 
+// Non-owning view of one of the tables above
+template <typename T>
+struct TableView {
+    const T* items;
+    size_t count;
+    
+    constexpr TableView() : items(nullptr), count(0) {}
+    constexpr TableView(const T* first, size_t n) : items(first), count(n) {}
+    template <size_t N>
+    constexpr TableView(const T (&table)[N]) : items(table), count(N) {}
+    
+    constexpr size_t size() const { return count; }
+    constexpr bool empty() const { return count == 0; }
+    constexpr const T& operator[](size_t i) const { return items[i]; }
+    constexpr const T* begin() const { return items; }
+    constexpr const T* end() const { return items + count; }
+};
+
+// Views only; copying a GameData or opening a save allocates nothing
 struct GameData {
     GameType type;
-    std::string name;
-    std::vector<GameValue> values;
-    std::vector<GameWeapon> weapons;
-    std::vector<GameGadget> gadgets;
-    std::vector<GameUnlockable> unlockables;
-    std::vector<GameValue> extra_values;
+    const char* name;
+    TableView<GameValue> values;
+    TableView<GameWeapon> weapons;
+    TableView<GameGadget> gadgets;
+    TableView<GameUnlockable> unlockables;
+    TableView<GameValue> extra_values;
     
-    GameData() : type(GameType::UNKNOWN), name("Unknown Game") {}
+    constexpr GameData() : type(GameType::UNKNOWN), name("Unknown Game") {}
     
-    GameData(GameType t) : type(t) {
+    constexpr GameData(GameType t) : type(t), name("Unknown Game") {
         switch(t) {
             case GameType::RAC1_VITA:
                 name = "Ratchet & Clank HD";
@@ -341,35 +362,8 @@ struct GameData {
     }
 };
 
-// ============================================================================
-// AUTO-DETECTION FUNCTION
-// ============================================================================
-
-inline GameType DetectGameType(const std::vector<uint8_t>& saveData) {
-    size_t fileSize = saveData.size();
-    
-    if (fileSize > 0) {
-        if (fileSize >= 650000 && fileSize <= 850000) {
-            return GameType::RAC1_VITA;
-        }
-        else if (fileSize >= 850000 && fileSize <= 1150000) {
-            return GameType::RAC2_VITA;
-        }
-        else if (fileSize >= 1150000) {
-            return GameType::RAC3_VITA;
-        }
-    }
-    
-    return GameType::UNKNOWN;
-}
-
-inline std::string GetGameName(GameType type) {
-    switch(type) {
-        case GameType::RAC1_VITA: return "Ratchet & Clank HD";
-        case GameType::RAC2_VITA: return "Ratchet & Clank 2 HD";
-        case GameType::RAC3_VITA: return "Ratchet & Clank 3 HD";
-        default: return "Unknown Game";
-    }
+constexpr const char* GetGameName(GameType type) {
+    return GameData(type).name;
 }
 
-#endif // RAC_VITA_GAMES_DATA_H
\ No newline at end of file
+#endif // RAC_VITA_GAMES_DATA_H
@@ -0,0 +1,225 @@
+// draw_list.cpp - Recorded frame drawing, submitted in batches to a backend
+#include "draw_list.h"
+#include <cstring>
+
+namespace {
+    const char MAGIC[4] = {'S', 'L', 'D', 'L'};
+    const uint32_t FORMAT = 1;
+    const size_t HEADER_SIZE = 20;
+    const size_t COMMAND_SIZE = 28;
+
+    void Put32(std::vector<uint8_t>& out, uint32_t value) {
+        uint8_t bytes[4];
+        std::memcpy(bytes, &value, 4);
+        out.insert(out.end(), bytes, bytes + 4);
+    }
+
+    uint32_t Get32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, 4);
+        return value;
+    }
+
+    bool SameRect(const DrawRect& a, const DrawRect& b) {
+        return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+    }
+}
+
+void DrawList::Clear() {
+    commands.clear();
+    textPool.clear();
+}
+
+void DrawList::NoClip() {
+    AddShape(Op::NO_CLIP, DrawRect{0, 0, 0, 0}, DrawColor{0, 0, 0, 0}, false);
+}
+
+void DrawList::AddShape(Op op, const DrawRect& rect, DrawColor color, bool blend) {
+    Command command;
+    command.op = op;
+    command.align = TextAlign::LEFT;
+    command.blend = blend;
+    command.rect = rect;
+    command.color = color;
+    command.text = 0;
+    commands.push_back(command);
+}
+
+void DrawList::AddText(const char* text, int x, int y, TextAlign align, DrawColor color) {
+    if (!text || !*text) return;
+
+    Command command;
+    command.op = Op::TEXT;
+    command.align = align;
+    command.blend = false;
+    command.rect = DrawRect{x, y, 0, 0};
+    command.color = color;
+    command.text = (uint32_t)textPool.size();
+    commands.push_back(command);
+
+    textPool.append(text);
+    textPool.push_back('\0');
+}
+
+DrawStats DrawList::Submit(DrawBackend& backend, SubmitMode mode) const {
+    bool immediate = mode == SubmitMode::IMMEDIATE;
+    DrawStats stats;
+
+    // Backend state as far as this submit knows; nothing is assumed at
+    // the start, since other code draws between lists
+    bool haveColor = false, haveBlend = false, clipped = false, inText = false;
+    DrawColor color = {0, 0, 0, 0};
+    bool blend = false;
+    DrawRect clip = {0, 0, 0, 0};
+    batch.clear();
+
+    auto flushFills = [&]() {
+        if (batch.empty()) return;
+        backend.FillRects(batch.data(), (int)batch.size());
+        stats.drawCalls++;
+        stats.rects += batch.size();
+        batch.clear();
+    };
+    auto endText = [&]() {
+        if (!inText) return;
+        backend.EndText();
+        inText = false;
+    };
+    // Drawing straight to SDL set the colour before every shape but the
+    // blend mode only around blended fills; IMMEDIATE does the same
+    auto setState = [&](DrawColor c, bool b) {
+        if (immediate || !haveColor || c != color) {
+            flushFills();
+            backend.SetColor(c);
+            stats.stateChanges++;
+            color = c;
+            haveColor = true;
+        }
+        if (!haveBlend || b != blend) {
+            flushFills();
+            backend.SetBlend(b);
+            stats.stateChanges++;
+            blend = b;
+            haveBlend = true;
+        }
+    };
+
+    for (const Command& command : commands) {
+        switch (command.op) {
+            case Op::FILL:
+                endText();
+                setState(command.color, command.blend);
+                batch.push_back(command.rect);
+                if (immediate) flushFills();
+                break;
+            case Op::OUTLINE:
+                endText();
+                flushFills();
+                setState(command.color, command.blend);
+                backend.OutlineRect(command.rect);
+                stats.drawCalls++;
+                break;
+            case Op::TEXT:
+                flushFills();
+                if (!inText) {
+                    backend.BeginText();
+                    stats.drawCalls++;
+                    inText = true;
+                }
+                backend.Text(&textPool[command.text], command.rect.x, command.rect.y, command.align, command.color);
+                stats.textRuns++;
+                if (immediate) endText();
+                break;
+            case Op::CLIP:
+                if (immediate || !clipped || !SameRect(clip, command.rect)) {
+                    flushFills();
+                    endText();
+                    backend.SetClip(&command.rect);
+                    stats.stateChanges++;
+                }
+                clip = command.rect;
+                clipped = true;
+                break;
+            case Op::NO_CLIP:
+                if (immediate || clipped) {
+                    flushFills();
+                    endText();
+                    backend.SetClip(nullptr);
+                    stats.stateChanges++;
+                }
+                clipped = false;
+                break;
+        }
+    }
+
+    flushFills();
+    endText();
+    if (clipped) {
+        backend.SetClip(nullptr);
+        stats.stateChanges++;
+    }
+    return stats;
+}
+
+void DrawList::Serialize(const std::string& screen, std::vector<uint8_t>& out) const {
+    out.assign(MAGIC, MAGIC + 4);
+    out.reserve(HEADER_SIZE + screen.size() + commands.size() * COMMAND_SIZE + textPool.size());
+    Put32(out, FORMAT);
+    Put32(out, (uint32_t)commands.size());
+    Put32(out, (uint32_t)textPool.size());
+    Put32(out, (uint32_t)screen.size());
+    out.insert(out.end(), screen.begin(), screen.end());
+
+    for (const Command& command : commands) {
+        out.push_back((uint8_t)command.op);
+        out.push_back((uint8_t)command.align);
+        out.push_back(command.blend ? 1 : 0);
+        out.push_back(0);
+        Put32(out, (uint32_t)command.rect.x);
+        Put32(out, (uint32_t)command.rect.y);
+        Put32(out, (uint32_t)command.rect.w);
+        Put32(out, (uint32_t)command.rect.h);
+        out.push_back(command.color.r);
+        out.push_back(command.color.g);
+        out.push_back(command.color.b);
+        out.push_back(command.color.a);
+        Put32(out, command.text);
+    }
+    out.insert(out.end(), textPool.begin(), textPool.end());
+}
+
+bool DrawList::Deserialize(const uint8_t* data, size_t size, std::string& screen) {
+    Clear();
+    if (size < HEADER_SIZE || std::memcmp(data, MAGIC, 4) != 0 || Get32(data + 4) != FORMAT) return false;
+
+    uint64_t count = Get32(data + 8);
+    uint64_t poolSize = Get32(data + 12);
+    uint64_t screenSize = Get32(data + 16);
+    if (HEADER_SIZE + screenSize + count * COMMAND_SIZE + poolSize != size) return false;
+    if (poolSize > 0 && data[size - 1] != '\0') return false;
+
+    const uint8_t* p = data + HEADER_SIZE;
+    screen.assign((const char*)p, (size_t)screenSize);
+    p += screenSize;
+
+    commands.resize((size_t)count);
+    for (Command& command : commands) {
+        if (p[0] > (uint8_t)Op::NO_CLIP || p[1] > (uint8_t)TextAlign::RIGHT) {
+            Clear();
+            return false;
+        }
+        command.op = (Op)p[0];
+        command.align = (TextAlign)p[1];
+        command.blend = p[2] != 0;
+        command.rect = DrawRect{(int)Get32(p + 4), (int)Get32(p + 8), (int)Get32(p + 12), (int)Get32(p + 16)};
+        command.color = DrawColor{p[20], p[21], p[22], p[23]};
+        command.text = Get32(p + 24);
+        if (command.op == Op::TEXT && command.text >= poolSize) {
+            Clear();
+            return false;
+        }
+        p += COMMAND_SIZE;
+    }
+    textPool.assign((const char*)p, (size_t)poolSize);
+    return true;
+}
@@ -0,0 +1,155 @@
+// draw_list.h - Recorded frame drawing, submitted in batches to a backend
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Same layout as SDL_Rect / SDL_Color, so backends can pass arrays
+// straight through; kept SDL-free so the host tools can replay lists
+struct DrawRect {
+    int x, y, w, h;
+};
+
+struct DrawColor {
+    uint8_t r, g, b, a;
+
+    bool operator==(const DrawColor& other) const {
+        return r == other.r && g == other.g && b == other.b && a == other.a;
+    }
+    bool operator!=(const DrawColor& other) const { return !(*this == other); }
+};
+
+enum class TextAlign : uint8_t {
+    LEFT,           // x is the left edge
+    CENTER,         // x is the centre
+    RIGHT           // x is the right edge
+};
+
+// What a backend received from one Submit
+struct DrawStats {
+    size_t drawCalls = 0;       // Fill batches, outlines, text batches
+    size_t stateChanges = 0;    // Colour, blend and clip changes
+    size_t rects = 0;           // Rectangles filled, however batched
+    size_t textRuns = 0;
+};
+
+// A renderer a DrawList can be played into: SDL on the Vita, a software
+// rasteriser on the host
+class DrawBackend {
+public:
+    virtual ~DrawBackend() {}
+
+    virtual void SetClip(const DrawRect* clip) = 0;     // nullptr: whole target
+    virtual void SetColor(DrawColor color) = 0;
+    virtual void SetBlend(bool blend) = 0;
+    virtual void FillRects(const DrawRect* rects, int count) = 0;
+    virtual void OutlineRect(const DrawRect& rect) = 0;
+
+    // Text runs between BeginText and EndText may be drawn together;
+    // nothing else is submitted in between
+    virtual void BeginText() = 0;
+    virtual void Text(const char* text, int x, int y, TextAlign align, DrawColor color) = 0;
+    virtual void EndText() = 0;
+};
+
+// Screens record what they draw instead of calling the renderer; the list
+// is then played into a backend in order. Submit drops colour, blend and
+// clip changes that set what is already set, hands consecutive fills of
+// one colour over as a single FillRects, and groups consecutive text runs
+// into one text batch. Nothing is reordered, so the result is the same as
+// drawing each command as it was recorded.
+//
+// Lists serialise to a flat binary form so frames captured on the Vita can
+// be replayed and timed on the host (bench/draw_bench.cpp).
+class DrawList {
+public:
+    enum class SubmitMode {
+        BATCHED,        // As above
+        IMMEDIATE       // One call per command with its state set every
+                        // time, like drawing straight to SDL; for comparison
+    };
+
+    void Clear();
+
+    // Shapes take anything with x/y/w/h and r/g/b/a members (SDL_Rect,
+    // SDL_Color, DrawRect, DrawColor)
+    template <typename Rect, typename Color>
+    void Fill(const Rect& rect, const Color& color) {
+        AddShape(Op::FILL, ToRect(rect), ToColor(color), false);
+    }
+
+    // Alpha-blended fill
+    template <typename Rect, typename Color>
+    void Blend(const Rect& rect, const Color& color) {
+        AddShape(Op::FILL, ToRect(rect), ToColor(color), true);
+    }
+
+    template <typename Rect, typename Color>
+    void Outline(const Rect& rect, const Color& color) {
+        AddShape(Op::OUTLINE, ToRect(rect), ToColor(color), false);
+    }
+
+    template <typename Color>
+    void Text(const char* text, int x, int y, const Color& color) {
+        AddText(text, x, y, TextAlign::LEFT, ToColor(color));
+    }
+
+    template <typename Color>
+    void TextCentered(const char* text, int centerX, int y, const Color& color) {
+        AddText(text, centerX, y, TextAlign::CENTER, ToColor(color));
+    }
+
+    template <typename Color>
+    void TextRight(const char* text, int rightX, int y, const Color& color) {
+        AddText(text, rightX, y, TextAlign::RIGHT, ToColor(color));
+    }
+
+    // Everything after is clipped to rect until NoClip
+    template <typename Rect>
+    void Clip(const Rect& rect) {
+        AddShape(Op::CLIP, ToRect(rect), DrawColor{0, 0, 0, 0}, false);
+    }
+    void NoClip();
+
+    DrawStats Submit(DrawBackend& backend, SubmitMode mode = SubmitMode::BATCHED) const;
+
+    size_t GetCommandCount() const { return commands.size(); }
+    bool IsEmpty() const { return commands.empty(); }
+
+    // Flat binary form; Deserialize replaces the list and returns false
+    // (leaving it empty) on anything malformed
+    void Serialize(const std::string& screen, std::vector<uint8_t>& out) const;
+    bool Deserialize(const uint8_t* data, size_t size, std::string& screen);
+
+private:
+    enum class Op : uint8_t {
+        FILL,
+        OUTLINE,
+        TEXT,
+        CLIP,
+        NO_CLIP
+    };
+
+    struct Command {
+        Op op;
+        TextAlign align;
+        bool blend;
+        DrawRect rect;          // TEXT: x, y of the run
+        DrawColor color;
+        uint32_t text;          // TEXT: offset into textPool
+    };
+
+    std::vector<Command> commands;
+    std::string textPool;       // NUL-terminated runs
+    mutable std::vector<DrawRect> batch;
+
+    template <typename Rect>
+    static DrawRect ToRect(const Rect& rect) { return DrawRect{rect.x, rect.y, rect.w, rect.h}; }
+
+    template <typename Color>
+    static DrawColor ToColor(const Color& color) { return DrawColor{color.r, color.g, color.b, color.a}; }
+
+    void AddShape(Op op, const DrawRect& rect, DrawColor color, bool blend);
+    void AddText(const char* text, int x, int y, TextAlign align, DrawColor color);
+};
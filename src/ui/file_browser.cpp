@@ -1,14 +1,29 @@
 // file_browser.cpp - FIXED scrolling and last items visibility
 #include "file_browser.h"
 #include "../utils/colors.h"
-#include <psp2/io/dirent.h>
-#include <psp2/io/stat.h>
 #include <algorithm>
 #include <cstdio>
+#include <iterator>
 
-FileBrowser::FileBrowser(SDL_Renderer* r, TTF_Font* f) 
-    : renderer(r), font(f), selectedIndex(0), scrollOffset(0), needsRescan(true),
-      touchStartY(0), touchStartScroll(0), isDragging(false) {
+// Each band is redrawn only when what it shows changes
+static const SDL_Rect HEADER_AREA = {0, 0, 960, 120};
+static const SDL_Rect LIST_AREA = {0, 120, 960, 380};
+static const SDL_Rect FOOTER_AREA = {0, 500, 960, 44};
+
+// Rows are 60 px apart from y = 135, six to a screen; each is drawn 5 px
+// into its slot
+static const int LIST_TOP = 135;
+static const int LIST_HEIGHT = 360;
+static const int ROW_HEIGHT = 60;
+static const int ROW_INSET = 5;
+
+// Some tens of thousands of entries across all cached folders
+static const size_t LISTING_CACHE_BYTES = 4 * 1024 * 1024;
+
+FileBrowser::FileBrowser(DrawList* d, TextRenderer* t) 
+    : draw(d), text(t), list(LIST_TOP, LIST_HEIGHT, ROW_HEIGHT), needsRescan(true), listVersion(0),
+      scanStatus(ScanStatus::IDLE), cache(LISTING_CACHE_BYTES), scanStamp(0), scanCacheable(false),
+      scanCount(0) {
     currentPath = "ux0:/data/slimseditor/saves";
 }
 
@@ -21,25 +36,30 @@ void FileBrowser::SetPath(const std::string& path) {
 }
 
 std::string FileBrowser::GetSelectedPath() const {
-    if (selectedIndex >= 0 && selectedIndex < (int)entries.size()) {
-        return entries[selectedIndex].fullPath;
+    int selected = list.GetSelected();
+    if (selected >= 0 && selected < (int)entries.size()) {
+        return entries[selected].fullPath;
     }
     return "";
 }
 
 bool FileBrowser::HasSelection() const {
-    return selectedIndex >= 0 && selectedIndex < (int)entries.size() && 
-           !entries[selectedIndex].isDirectory;
+    int selected = list.GetSelected();
+    return selected >= 0 && selected < (int)entries.size() && 
+           !entries[selected].isDirectory;
 }
 
-void FileBrowser::ScanDirectory() {
+void FileBrowser::StartScan() {
     entries.clear();
+    listVersion++;
     
     // Add parent directory entry if not at root
     if (currentPath != "ux0:" && currentPath.find('/') != std::string::npos) {
         FileEntry parent;
-        parent.name = ".. (Parent Directory)";
+        parent.name = PARENT_ENTRY_NAME;
         parent.isDirectory = true;
+        parent.size = 0;
+        parent.stamp = 0;
         
         // Get parent path
         size_t lastSlash = currentPath.find_last_of('/');
@@ -51,77 +71,79 @@ void FileBrowser::ScanDirectory() {
         entries.push_back(parent);
     }
     
-    SceUID dir = sceIoDopen(currentPath.c_str());
-    if (dir < 0) {
-        needsRescan = false;
-        return;
+    // A listing cached under the folder's current mtime needs no scan, on
+    // refresh as on the way back (its entries are re-stat'ed for sizes);
+    // otherwise this replaces (and cancels) any scan still running
+    uint64_t stamp = 0;
+    bool stamped = DirCache::ReadStamp(currentPath, stamp);
+    if (stamped && cache.Lookup(currentPath, stamp, entries)) {
+        scanner.Cancel();
+        scanStatus = ScanStatus::DONE;
+    } else {
+        scanner.Start(currentPath);
+        scanStatus = ScanStatus::SCANNING;
+        scanStamp = stamp;
+        scanCacheable = stamped;
+        scanCount++;
     }
     
-    SceIoDirent dirent;
-    while (sceIoDread(dir, &dirent) > 0) {
-        if (dirent.d_name[0] == '.') continue;
+    list.Reset();
+    list.SetCount((int)entries.size());
+    needsRescan = false;
+}
+
+void FileBrowser::PollScan() {
+    arrived.clear();
+    ScanStatus status = scanner.Poll(arrived);
+    
+    if (!arrived.empty()) {
+        // What arrived is already sorted; merge it in. Once the user has
+        // moved off the first row, the selection stays on the same entry as
+        // rows are inserted around it.
+        int selected = list.GetSelected();
+        bool follow = selected > 0 && selected < (int)entries.size();
+        FileEntry selectedEntry = follow ? entries[selected] : FileEntry();
         
-        FileEntry entry;
-        entry.name = dirent.d_name;
-        entry.fullPath = currentPath + "/" + dirent.d_name;
-        entry.isDirectory = SCE_S_ISDIR(dirent.d_stat.st_mode);
-        entry.size = dirent.d_stat.st_size;
+        size_t middle = entries.size();
+        entries.insert(entries.end(), std::make_move_iterator(arrived.begin()), std::make_move_iterator(arrived.end()));
+        std::inplace_merge(entries.begin(), entries.begin() + middle, entries.end(), EntryBefore);
         
-        entries.push_back(entry);
+        listVersion++;
+        list.SetCount((int)entries.size());
+        if (follow) {
+            int index = (int)(std::lower_bound(entries.begin(), entries.end(), selectedEntry, EntryBefore) - entries.begin());
+            if (index != selected) list.Select(index);
+        }
     }
     
-    sceIoDclose(dir);
-    
-    // Sort: directories first, then files, alphabetically
-    std::sort(entries.begin(), entries.end(), [](const FileEntry& a, const FileEntry& b) {
-        if (a.name == ".. (Parent Directory)") return true;
-        if (b.name == ".. (Parent Directory)") return false;
-        if (a.isDirectory != b.isDirectory) return a.isDirectory;
-        return a.name < b.name;
-    });
-    
-    selectedIndex = 0;
-    scrollOffset = 0;
-    needsRescan = false;
+    if (status == ScanStatus::DONE) {
+        if (scanCacheable) {
+            bool hasParent = !entries.empty() && entries[0].name == PARENT_ENTRY_NAME;
+            cache.Store(currentPath, scanStamp, std::vector<FileEntry>(entries.begin() + (hasParent ? 1 : 0), entries.end()));
+        }
+    }
+    scanStatus = status;
 }
 
 void FileBrowser::Update(const InputState& input) {
     if (needsRescan) {
-        ScanDirectory();
+        StartScan();
     }
     
-    if (entries.empty()) return;
-    
-    const int VISIBLE_ITEMS = 6;
-    int maxScroll = (entries.size() > VISIBLE_ITEMS) ? (entries.size() - VISIBLE_ITEMS) : 0;
-    
-    // D-PAD navigation with FIXED scrolling
-    if (input.IsPressed(SCE_CTRL_DOWN) && selectedIndex < (int)entries.size() - 1) {
-        selectedIndex++;
-        
-        // FIXED: Ensure last items are visible
-        if (selectedIndex >= scrollOffset + VISIBLE_ITEMS) {
-            scrollOffset = selectedIndex - VISIBLE_ITEMS + 1;
-        }
+    if (scanStatus == ScanStatus::SCANNING) {
+        PollScan();
     }
     
-    if (input.IsPressed(SCE_CTRL_UP) && selectedIndex > 0) {
-        selectedIndex--;
-        
-        // FIXED: Proper scroll up
-        if (selectedIndex < scrollOffset) {
-            scrollOffset = selectedIndex;
-        }
-    }
+    if (entries.empty()) return;
     
-    // Clamp scroll
-    if (scrollOffset > maxScroll) scrollOffset = maxScroll;
-    if (scrollOffset < 0) scrollOffset = 0;
+    // D-pad and touch scrolling; only a tap comes back
+    int tapped = list.Update(input);
+    int selected = list.GetSelected();
     
     // Enter directory or select file
-    if (input.IsPressed(SCE_CTRL_CROSS) && selectedIndex >= 0 && selectedIndex < (int)entries.size()) {
-        if (entries[selectedIndex].isDirectory) {
-            SetPath(entries[selectedIndex].fullPath);
+    if (input.IsPressed(SCE_CTRL_CROSS) && selected >= 0 && selected < (int)entries.size()) {
+        if (entries[selected].isDirectory) {
+            SetPath(entries[selected].fullPath);
         }
         // If it's a file, parent will handle it
     }
@@ -132,185 +154,116 @@ void FileBrowser::Update(const InputState& input) {
     }
     
     // Go to parent with Circle
-    if (input.IsPressed(SCE_CTRL_CIRCLE) && !entries.empty() && entries[0].name == ".. (Parent Directory)") {
+    if (input.IsPressed(SCE_CTRL_CIRCLE) && !entries.empty() && entries[0].name == PARENT_ENTRY_NAME) {
         SetPath(entries[0].fullPath);
     }
     
-    // TOUCH SCROLLING - Fixed implementation
-    if (input.touchPressed && input.touchY >= 140 && input.touchY < 500 && !isDragging) {
-        touchStartY = input.touchY;
-        touchStartScroll = scrollOffset;
-        isDragging = true;
-    }
-    
-    // While dragging
-    if (isDragging) {
-        // Check if still touching in the list area
-        if (input.touchY >= 140 && input.touchY < 500) {
-            int dragDistance = touchStartY - input.touchY;
-            int scrollDelta = dragDistance / 60;  // Each item is 60px
-            
-            scrollOffset = touchStartScroll + scrollDelta;
-            
-            // Clamp
-            if (scrollOffset < 0) scrollOffset = 0;
-            if (scrollOffset > maxScroll) scrollOffset = maxScroll;
+    // Tap selects; tapping the selected entry again opens it
+    if (tapped >= 0 && !needsRescan) {
+        if (tapped == selected) {
+            if (entries[tapped].isDirectory) {
+                SetPath(entries[tapped].fullPath);
+            }
+        } else {
+            list.Select(tapped);
         }
     }
+}
+
+void FileBrowser::Render(RetainedFrame& frame) {
+    if (frame.Layer(0, HEADER_AREA, LayerKey().Add(currentPath.c_str()).Get())) {
+        RenderHeader();
+        frame.EndLayer();
+    }
     
-    if (input.touchReleased) {
-        isDragging = false;
+    LayerKey listKey;
+    listKey.Add(listVersion).Add(list.GetScroll()).Add(list.GetSelected()).Add(entries.size())
+           .Add((uint64_t)scanStatus);
+    if (frame.Layer(1, LIST_AREA, listKey.Get())) {
+        RenderFileList();
+        frame.EndLayer();
     }
     
-    // Touch selection (tap, not drag)
-    if (input.touchPressed && !isDragging && input.touchY >= 140 && input.touchY < 500) {
-        int y = 140;
-        for (int i = scrollOffset; i < (int)entries.size() && i < scrollOffset + VISIBLE_ITEMS; i++) {
-            if (input.touchY >= y && input.touchY < y + 60) {
-                if (selectedIndex == i) {
-                    // Double tap - enter directory or select file
-                    if (entries[i].isDirectory) {
-                        SetPath(entries[i].fullPath);
-                    }
-                } else {
-                    selectedIndex = i;
-                }
-                break;
-            }
-            y += 60;
-        }
+    if (frame.Layer(2, FOOTER_AREA, LayerKey().Add(entries.size()).Add(list.GetSelected()).Add((uint64_t)scanStatus).Get())) {
+        RenderFooter();
+        frame.EndLayer();
     }
 }
 
-void FileBrowser::Render() {
-    RenderHeader();
-    RenderFileList();
-    RenderFooter();
-}
-
 void FileBrowser::RenderHeader() {
     // Header background
     SDL_Color panelColor = Colors::Panel();
-    SDL_SetRenderDrawColor(renderer, panelColor.r, panelColor.g, panelColor.b, panelColor.a);
     SDL_Rect headerRect = {0, 0, 960, 80};
-    SDL_RenderFillRect(renderer, &headerRect);
+    draw->Fill(headerRect, panelColor);
     
     // Title
     SDL_Color accentColor = Colors::Accent();
-    SDL_Surface* titleSurface = TTF_RenderUTF8_Blended(font, "FILE BROWSER", accentColor);
-    if (titleSurface) {
-        SDL_Texture* titleTexture = SDL_CreateTextureFromSurface(renderer, titleSurface);
-        SDL_Rect titleRect = {20, 15, titleSurface->w, titleSurface->h};
-        SDL_RenderCopy(renderer, titleTexture, nullptr, &titleRect);
-        SDL_DestroyTexture(titleTexture);
-        SDL_FreeSurface(titleSurface);
-    }
+    draw->Text("FILE BROWSER", 20, 15, accentColor);
     
     // Current path
     SDL_Color textDimColor = Colors::TextDim();
-    SDL_Surface* pathSurface = TTF_RenderUTF8_Blended(font, currentPath.c_str(), textDimColor);
-    if (pathSurface) {
-        SDL_Texture* pathTexture = SDL_CreateTextureFromSurface(renderer, pathSurface);
-        SDL_Rect pathRect = {20, 50, pathSurface->w, pathSurface->h};
-        SDL_RenderCopy(renderer, pathTexture, nullptr, &pathRect);
-        SDL_DestroyTexture(pathTexture);
-        SDL_FreeSurface(pathSurface);
-    }
+    draw->Text(currentPath.c_str(), 20, 50, textDimColor);
     
     // Control bar
     SDL_Color selectedColor = Colors::Selected();
-    SDL_SetRenderDrawColor(renderer, selectedColor.r, selectedColor.g, selectedColor.b, selectedColor.a);
     SDL_Rect controlRect = {0, 80, 960, 40};
-    SDL_RenderFillRect(renderer, &controlRect);
+    draw->Fill(controlRect, selectedColor);
     
     SDL_Color textColor = Colors::Text();
-    SDL_Surface* controlSurface = TTF_RenderUTF8_Blended(font, "D-Pad: Navigate | X: Select | O: Parent | []: Refresh", textColor);
-    if (controlSurface) {
-        SDL_Texture* controlTexture = SDL_CreateTextureFromSurface(renderer, controlSurface);
-        SDL_Rect controlTextRect = {20, 90, controlSurface->w, controlSurface->h};
-        SDL_RenderCopy(renderer, controlTexture, nullptr, &controlTextRect);
-        SDL_DestroyTexture(controlTexture);
-        SDL_FreeSurface(controlSurface);
-    }
+    draw->Text("D-Pad: Navigate | X: Select | O: Parent | []: Refresh", 20, 90, textColor);
 }
 
 void FileBrowser::RenderFileList() {
-    int y = 140;
-    int visibleCount = 0;
-    const int VISIBLE_ITEMS = 6;
+    // Only the rows on screen, clipped where they are partly scrolled out
+    draw->Clip(list.GetClip());
     
-    for (int i = scrollOffset; i < (int)entries.size() && visibleCount < VISIBLE_ITEMS; i++, visibleCount++) {
-        bool selected = (i == selectedIndex);
+    for (int i = list.GetFirstVisible(); i < list.GetLastVisible(); i++) {
+        int y = list.GetRowY(i) + ROW_INSET;
+        bool selected = (i == list.GetSelected());
         
         // Background
         SDL_Color bgColor = selected ? Colors::Selected() : Colors::Panel();
-        SDL_SetRenderDrawColor(renderer, bgColor.r, bgColor.g, bgColor.b, bgColor.a);
         SDL_Rect itemRect = {10, y - 5, 940, 55};
-        SDL_RenderFillRect(renderer, &itemRect);
+        draw->Fill(itemRect, bgColor);
         
         // Icon and name
         std::string displayName = entries[i].isDirectory ? "[DIR] " + entries[i].name : entries[i].name;
         SDL_Color textColor = selected ? Colors::Accent() : Colors::Text();
         
-        SDL_Surface* nameSurface = TTF_RenderUTF8_Blended(font, displayName.c_str(), textColor);
-        if (nameSurface) {
-            SDL_Texture* nameTexture = SDL_CreateTextureFromSurface(renderer, nameSurface);
-            SDL_Rect nameRect = {25, y + 5, nameSurface->w, nameSurface->h};
-            SDL_RenderCopy(renderer, nameTexture, nullptr, &nameRect);
-            SDL_DestroyTexture(nameTexture);
-            SDL_FreeSurface(nameSurface);
-        }
+        draw->Text(displayName.c_str(), 25, y + 5, textColor);
         
         // Size (for files)
         if (!entries[i].isDirectory) {
             std::string sizeStr = FormatSize(entries[i].size);
             SDL_Color dimColor = Colors::TextDim();
-            SDL_Surface* sizeSurface = TTF_RenderUTF8_Blended(font, sizeStr.c_str(), dimColor);
-            if (sizeSurface) {
-                SDL_Texture* sizeTexture = SDL_CreateTextureFromSurface(renderer, sizeSurface);
-                SDL_Rect sizeRect = {920 - sizeSurface->w, y + 5, sizeSurface->w, sizeSurface->h};
-                SDL_RenderCopy(renderer, sizeTexture, nullptr, &sizeRect);
-                SDL_DestroyTexture(sizeTexture);
-                SDL_FreeSurface(sizeSurface);
-            }
+            draw->TextRight(sizeStr.c_str(), 920, y + 5, dimColor);
         }
-        
-        y += 60;
     }
+    draw->Clip(LIST_AREA);
     
-    // Empty state
-    if (entries.empty()) {
+    // Empty state; the parent entry alone counts as empty too
+    bool empty = entries.empty() || (entries.size() == 1 && entries[0].name == PARENT_ENTRY_NAME);
+    if (empty) {
+        const char* message = "Empty directory";
+        if (scanStatus == ScanStatus::SCANNING) message = "Reading directory...";
+        if (scanStatus == ScanStatus::FAILED) message = "Cannot open directory";
         SDL_Color dimColor = Colors::TextDim();
-        SDL_Surface* emptySurface = TTF_RenderUTF8_Blended(font, "Empty directory", dimColor);
-        if (emptySurface) {
-            SDL_Texture* emptyTexture = SDL_CreateTextureFromSurface(renderer, emptySurface);
-            SDL_Rect emptyRect = {960/2 - emptySurface->w/2, 272 - emptySurface->h/2, emptySurface->w, emptySurface->h};
-            SDL_RenderCopy(renderer, emptyTexture, nullptr, &emptyRect);
-            SDL_DestroyTexture(emptyTexture);
-            SDL_FreeSurface(emptySurface);
-        }
+        draw->TextCentered(message, 960/2, 272 - text->GetLineHeight()/2, dimColor);
     }
 }
 
 void FileBrowser::RenderFooter() {
     SDL_Color panelColor = Colors::PanelDark();
-    SDL_SetRenderDrawColor(renderer, panelColor.r, panelColor.g, panelColor.b, panelColor.a);
     SDL_Rect footerRect = {0, 500, 960, 44};
-    SDL_RenderFillRect(renderer, &footerRect);
+    draw->Fill(footerRect, panelColor);
     
     char info[128];
-    snprintf(info, sizeof(info), "%d items | Selected: %d/%d", 
-             (int)entries.size(), selectedIndex + 1, (int)entries.size());
+    snprintf(info, sizeof(info), "%d items | Selected: %d/%d%s", 
+             (int)entries.size(), list.GetSelected() + 1, (int)entries.size(),
+             scanStatus == ScanStatus::SCANNING ? " | Reading..." : "");
     
     SDL_Color dimColor = Colors::TextDim();
-    SDL_Surface* infoSurface = TTF_RenderUTF8_Blended(font, info, dimColor);
-    if (infoSurface) {
-        SDL_Texture* infoTexture = SDL_CreateTextureFromSurface(renderer, infoSurface);
-        SDL_Rect infoRect = {20, 510, infoSurface->w, infoSurface->h};
-        SDL_RenderCopy(renderer, infoTexture, nullptr, &infoRect);
-        SDL_DestroyTexture(infoTexture);
-        SDL_FreeSurface(infoSurface);
-    }
+    draw->Text(info, 20, 510, dimColor);
 }
 
 std::string FileBrowser::FormatSize(size_t bytes) {
@@ -3,46 +3,55 @@
 #include <string>
 #include <vector>
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
+#include "../core/dir_cache.h"
+#include "../core/dir_scanner.h"
 #include "../utils/input.h"
-
-struct FileEntry {
-    std::string name;
-    std::string fullPath;
-    bool isDirectory;
-    size_t size;
-};
+#include "draw_list.h"
+#include "list_view.h"
+#include "text_renderer.h"
+#include "retained_frame.h"
 
 class FileBrowser {
 public:
-    FileBrowser(SDL_Renderer* renderer, TTF_Font* font);
+    FileBrowser(DrawList* draw, TextRenderer* text);
     ~FileBrowser();
     
     void SetPath(const std::string& path);
     std::string GetSelectedPath() const;
     
     void Update(const InputState& input);
-    void Render();
+    void Render(RetainedFrame& frame);
     
     bool HasSelection() const;
     
+    // Running totals for the perf HUD
+    size_t GetScanCount() const { return scanCount; }
+    size_t GetCacheHits() const { return cache.GetStats().hits; }
+    
 private:
-    void ScanDirectory();
+    void StartScan();
+    void PollScan();
     void RenderFileList();
     void RenderHeader();
     void RenderFooter();
     std::string FormatSize(size_t bytes);
     
-    SDL_Renderer* renderer;
-    TTF_Font* font;
+    DrawList* draw;
+    TextRenderer* text;        // Metrics for layout; drawing goes through draw
     std::string currentPath;
-    std::vector<FileEntry> entries;
-    int selectedIndex;
-    int scrollOffset;
+    std::vector<FileEntry> entries;     // Kept sorted as the scan streams in
+    ListView list;
     bool needsRescan;
+    uint32_t listVersion;       // Bumped whenever entries change, part of the list layer key
+    
+    DirScanner scanner;
+    ScanStatus scanStatus;
+    std::vector<FileEntry> arrived;     // Reused between polls
     
-    // Touch scrolling
-    int touchStartY;
-    int touchStartScroll;
-    bool isDragging;
+    // Listings of visited folders; a scan is cached under the stamp read
+    // before it started
+    DirCache cache;
+    uint64_t scanStamp;
+    bool scanCacheable;
+    size_t scanCount;           // Folders read from the card, for the perf HUD
 };
\ No newline at end of file
@@ -0,0 +1,85 @@
+// frame_scheduler.cpp - Paces the main loop and measures input-to-present latency
+#include "frame_scheduler.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <psp2/ctrl.h>
+#include <psp2/touch.h>
+#include <psp2/kernel/threadmgr.h>
+
+FrameScheduler::FrameScheduler()
+    : ticksPerMicro(SDL_GetPerformanceFrequency() / 1000000.0), frameStart(0), inputTime(0),
+      lastInput(Sample()), quietFrames(0), presentedLast(false),
+      lastLatency(0) {
+    frameStart = Now();
+}
+
+uint64_t FrameScheduler::Now() const {
+    return SDL_GetPerformanceCounter();
+}
+
+FrameScheduler::InputSample FrameScheduler::Sample() {
+    SceCtrlData pad;
+    sceCtrlPeekBufferPositive(0, &pad, 1);
+    SceTouchData touch;
+    sceTouchPeek(SCE_TOUCH_PORT_FRONT, &touch, 1);
+
+    InputSample sample = {pad.buttons, (int)touch.reportNum, 0, 0, 0};
+    if (touch.reportNum > 0) {
+        sample.touchX = touch.report[0].x;
+        sample.touchY = touch.report[0].y;
+    }
+    sceTouchPeek(SCE_TOUCH_PORT_BACK, &touch, 1);
+    sample.rearTouches = (int)touch.reportNum;
+    return sample;
+}
+
+bool FrameScheduler::InputChanged(uint64_t now) {
+    InputSample sample = Sample();
+    if (sample.buttons == lastInput.buttons && sample.touches == lastInput.touches &&
+        sample.touchX == lastInput.touchX && sample.touchY == lastInput.touchY &&
+        sample.rearTouches == lastInput.rearTouches) {
+        return false;
+    }
+    lastInput = sample;
+    inputTime = now;
+    quietFrames = 0;
+    return true;
+}
+
+void FrameScheduler::WaitForNextFrame() {
+    uint64_t now = Now();
+
+    // The present already waited for vblank; go straight on
+    if (presentedLast) {
+        InputChanged(now);
+        frameStart = now;
+        return;
+    }
+
+    bool held = lastInput.buttons != 0 || lastInput.touches > 0;
+    int period = (held || quietFrames < ACTIVE_GRACE) ? ACTIVE_PERIOD_US : IDLE_PERIOD_US;
+    uint64_t deadline = frameStart + (uint64_t)(period * ticksPerMicro);
+
+    while (!InputChanged(now) && now < deadline) {
+        double remaining = (deadline - now) / ticksPerMicro;
+        sceKernelDelayThread(remaining < POLL_US ? (SceUInt)remaining + 1 : POLL_US);
+        now = Now();
+    }
+    frameStart = now;
+}
+
+void FrameScheduler::FrameDone(bool presented) {
+    presentedLast = presented;
+    lastLatency = 0;
+    if (presented) {
+        quietFrames = 0;
+        if (inputTime != 0) {
+            lastLatency = std::max((uint32_t)((Now() - inputTime) / ticksPerMicro), 1u);
+        }
+    } else if (quietFrames < ACTIVE_GRACE) {
+        quietFrames++;
+    }
+
+    // Input that changed nothing on screen has no latency to report
+    inputTime = 0;
+}
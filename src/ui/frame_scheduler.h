@@ -0,0 +1,56 @@
+// frame_scheduler.h - Paces the main loop and measures input-to-present latency
+#pragma once
+#include <cstdint>
+
+// Decides when the next frame runs. Presenting already waits for vblank,
+// so a frame that presented is never delayed further; a frame that was
+// skipped (nothing changed on screen) sleeps until the next deadline.
+// While buttons are held, the screen is changing or input arrived in the
+// last ACTIVE_GRACE frames, deadlines are ACTIVE_PERIOD apart; otherwise
+// they drop to IDLE_PERIOD. Buttons and both touch pads are sampled every POLL_US
+// while sleeping and any change wakes the loop at once.
+//
+// The time from the first input change to the present that follows it is
+// that frame's latency; the perf HUD collects it.
+class FrameScheduler {
+public:
+    FrameScheduler();
+
+    // Blocks until the next frame is due or input changes
+    void WaitForNextFrame();
+
+    // Call once per frame after rendering; presented is false for frames
+    // that were skipped
+    void FrameDone(bool presented);
+
+    bool IsIdle() const { return quietFrames >= ACTIVE_GRACE; }
+
+    // Input-to-present time of the last frame; 0 if it presented no input
+    uint32_t GetLastLatencyMicros() const { return lastLatency; }
+
+    static const int ACTIVE_PERIOD_US = 16667;
+    static const int IDLE_PERIOD_US = 100000;
+    static const int POLL_US = 2000;
+    static const int ACTIVE_GRACE = 30;
+
+private:
+    struct InputSample {
+        uint32_t buttons;
+        int touches;
+        int rearTouches;        // Rear pad, for the perf HUD's taps
+        int touchX;
+        int touchY;
+    };
+
+    static InputSample Sample();
+    bool InputChanged(uint64_t now);
+    uint64_t Now() const;
+
+    double ticksPerMicro;
+    uint64_t frameStart;
+    uint64_t inputTime;         // 0 = no input waiting to be presented
+    InputSample lastInput;
+    int quietFrames;
+    bool presentedLast;
+    uint32_t lastLatency;
+};
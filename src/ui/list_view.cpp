@@ -0,0 +1,164 @@
+// list_view.cpp - Virtualized list of fixed-height rows with kinetic touch scrolling
+#include "list_view.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+static const double FRICTION = 3.0;            // Fling speed falls by e every 1/3 s
+static const double STOP_VELOCITY = 20.0;      // Pixels per second
+static const double MAX_VELOCITY = 8000.0;
+static const double MAX_STEP_S = 0.05;         // Longest single fling step, after a stall
+
+ListView::ListView(int t, int h, int r)
+    : top(t), height(h), rowHeight(r), count(0), selected(0), offset(0.0), velocity(0.0),
+      tracking(false), dragging(false), caught(false), touchStartY(0), touchStartOffset(0.0),
+      samples(), sampleCount(0), sampleHead(0), lastStep(0),
+      ticksPerMicro(SDL_GetPerformanceFrequency() / 1000000.0) {
+}
+
+void ListView::SetCount(int c) {
+    count = std::max(c, 0);
+    selected = std::min(selected, std::max(count - 1, 0));
+    ScrollTo(offset);
+}
+
+void ListView::Reset() {
+    selected = 0;
+    offset = 0.0;
+    velocity = 0.0;
+    tracking = false;
+}
+
+void ListView::Select(int index) {
+    if (count == 0) return;
+    selected = std::min(std::max(index, 0), count - 1);
+    velocity = 0.0;
+
+    double rowTop = (double)selected * rowHeight;
+    if (rowTop < offset) {
+        ScrollTo(rowTop);
+    } else if (rowTop + rowHeight > offset + height) {
+        ScrollTo(rowTop + rowHeight - height);
+    }
+}
+
+int ListView::GetScroll() const {
+    return (int)(offset + 0.5);
+}
+
+int ListView::GetFirstVisible() const {
+    return std::min(GetScroll() / rowHeight, count);
+}
+
+int ListView::GetLastVisible() const {
+    return std::min((GetScroll() + height + rowHeight - 1) / rowHeight, count);
+}
+
+DrawRect ListView::GetClip() const {
+    return DrawRect{0, top, 960, height};
+}
+
+double ListView::MaxScroll() const {
+    return std::max(0.0, (double)count * rowHeight - height);
+}
+
+void ListView::ScrollTo(double position) {
+    offset = std::min(std::max(position, 0.0), MaxScroll());
+}
+
+int ListView::RowAt(int y) const {
+    if (y < top || y >= top + height) return -1;
+    int index = (int)((y - top + offset) / rowHeight);
+    return index < count ? index : -1;
+}
+
+int ListView::Update(const InputState& input) {
+    uint64_t now = (uint64_t)(SDL_GetPerformanceCounter() / ticksPerMicro);
+    int tapped = -1;
+
+    if (input.IsPressed(SCE_CTRL_DOWN)) {
+        Select(selected + 1);
+    }
+
+    if (input.IsPressed(SCE_CTRL_UP)) {
+        Select(selected - 1);
+    }
+
+    // A new touch in the list stops any fling and may become a drag or a tap
+    if (input.touchPressed && input.touchY >= top && input.touchY < top + height) {
+        tracking = true;
+        dragging = false;
+        caught = IsMoving();
+        velocity = 0.0;
+        touchStartY = input.touchY;
+        touchStartOffset = offset;
+        sampleCount = 0;
+        Track(now, input.touchY);
+    } else if (tracking && input.touch.reportNum > 0) {
+        if (!dragging && std::abs(input.touchY - touchStartY) > DRAG_SLOP) {
+            // Start from here so the list doesn't jump by the slop
+            dragging = true;
+            touchStartY = input.touchY;
+            touchStartOffset = offset;
+        }
+        if (dragging) {
+            ScrollTo(touchStartOffset + (touchStartY - input.touchY));
+        }
+        Track(now, input.touchY);
+    }
+
+    if (tracking && input.touchReleased) {
+        tracking = false;
+        if (dragging) {
+            velocity = TrackedVelocity();
+            lastStep = now;
+        } else if (!caught) {
+            tapped = RowAt(input.touchY);
+        }
+    }
+
+    if (!tracking && velocity != 0.0) {
+        Fling(now);
+    }
+
+    return tapped;
+}
+
+void ListView::Track(uint64_t now, int y) {
+    samples[sampleHead] = TouchSample{now, y};
+    sampleHead = (sampleHead + 1) % TRACK_SAMPLES;
+    if (sampleCount < TRACK_SAMPLES) sampleCount++;
+}
+
+double ListView::TrackedVelocity() const {
+    if (sampleCount < 2) return 0.0;
+
+    // Oldest sample inside the window, measured back from the newest
+    const TouchSample& newest = samples[(sampleHead - 1 + TRACK_SAMPLES) % TRACK_SAMPLES];
+    const TouchSample* oldest = &newest;
+    for (int age = 1; age < sampleCount; age++) {
+        const TouchSample& sample = samples[(sampleHead - 1 - age + TRACK_SAMPLES) % TRACK_SAMPLES];
+        if (newest.micros - sample.micros > (uint64_t)TRACK_WINDOW_US) break;
+        oldest = &sample;
+    }
+    if (oldest->micros == newest.micros) return 0.0;
+
+    // Finger moving up scrolls down
+    double seconds = (newest.micros - oldest->micros) / 1000000.0;
+    double speed = (oldest->y - newest.y) / seconds;
+    return std::min(std::max(speed, -MAX_VELOCITY), MAX_VELOCITY);
+}
+
+void ListView::Fling(uint64_t now) {
+    double seconds = std::min((now - lastStep) / 1000000.0, MAX_STEP_S);
+    lastStep = now;
+
+    ScrollTo(offset + velocity * seconds);
+    velocity *= std::exp(-FRICTION * seconds);
+
+    bool atEnd = (velocity < 0.0 && offset <= 0.0) || (velocity > 0.0 && offset >= MaxScroll());
+    if (atEnd || std::fabs(velocity) < STOP_VELOCITY) {
+        velocity = 0.0;
+    }
+}
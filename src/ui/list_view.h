@@ -0,0 +1,88 @@
+// list_view.h - Virtualized list of fixed-height rows with kinetic touch scrolling
+#pragma once
+#include <cstdint>
+#include "../utils/input.h"
+#include "draw_list.h"
+
+// Owns selection and scroll position for a list of any length; callers
+// draw only the rows from GetFirstVisible() to GetLastVisible(), so a frame
+// costs the same for six rows or fifty thousand.
+//
+// The offset is kept in pixels. The D-pad moves the selection and scrolls
+// just enough to show it. A touch that moves more than DRAG_SLOP pixels
+// drags the list; on release it keeps going at the finger's speed (taken
+// from the last TRACK_WINDOW_US of samples) and slows down on its own. A
+// touch that stays put is a tap, reported by Update. Touching a list that
+// is still moving only stops it.
+class ListView {
+public:
+    // Rows are rowHeight apart starting at y = top; height pixels of them
+    // are visible at once
+    ListView(int top, int height, int rowHeight);
+
+    // Call whenever the list's length may have changed; keeps the
+    // selection and offset in range
+    void SetCount(int count);
+    int GetCount() const { return count; }
+
+    // First row selected, scrolled to the top, motion stopped
+    void Reset();
+
+    // Handles D-pad up/down and touch; returns the row tapped this frame,
+    // or -1
+    int Update(const InputState& input);
+
+    // Selects index and scrolls it into view
+    void Select(int index);
+    int GetSelected() const { return selected; }
+
+    int GetScroll() const;                  // Pixels from the top of the list
+    bool IsMoving() const { return velocity != 0.0; }
+
+    // Rows [first, last) overlap the visible band
+    int GetFirstVisible() const;
+    int GetLastVisible() const;
+
+    // Screen y of row index at the current offset
+    int GetRowY(int index) const { return top + index * rowHeight - GetScroll(); }
+
+    // Visible band, for clipping rows that are partly scrolled out
+    DrawRect GetClip() const;
+
+    static const int DRAG_SLOP = 8;
+    static const int TRACK_WINDOW_US = 100000;
+
+private:
+    struct TouchSample {
+        uint64_t micros;
+        int y;
+    };
+    static const int TRACK_SAMPLES = 8;
+
+    double MaxScroll() const;
+    void ScrollTo(double offset);
+    void Track(uint64_t now, int y);
+    double TrackedVelocity() const;
+    void Fling(uint64_t now);
+    int RowAt(int y) const;
+
+    int top;
+    int height;
+    int rowHeight;
+    int count;
+    int selected;
+    double offset;
+    double velocity;                        // Pixels per second, positive scrolls down
+
+    // Touch state
+    bool tracking;
+    bool dragging;
+    bool caught;                            // Touch landed on a moving list
+    int touchStartY;
+    double touchStartOffset;
+    TouchSample samples[TRACK_SAMPLES];
+    int sampleCount;
+    int sampleHead;
+    uint64_t lastStep;                      // When the fling last advanced
+    double ticksPerMicro;
+};
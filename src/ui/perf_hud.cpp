@@ -0,0 +1,302 @@
+// perf_hud.cpp - Toggleable overlay of frame phase timings and per-frame counters
+#include "perf_hud.h"
+#include "../utils/colors.h"
+#include <psp2/touch.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Counting hooks. The Vita link wraps SDL_RenderFillRect and
+// SDL_RenderFillRects (see CMakeLists.txt) so every fill call goes through
+// here; operator new is replaced outright. Each is a relaxed increment.
+static std::atomic<uint64_t> fillRects(0);
+static std::atomic<uint64_t> allocations(0);
+
+extern "C" int __real_SDL_RenderFillRect(SDL_Renderer* renderer, const SDL_Rect* rect);
+extern "C" int __real_SDL_RenderFillRects(SDL_Renderer* renderer, const SDL_Rect* rects, int count);
+
+extern "C" int __wrap_SDL_RenderFillRect(SDL_Renderer* renderer, const SDL_Rect* rect) {
+    fillRects.fetch_add(1, std::memory_order_relaxed);
+    return __real_SDL_RenderFillRect(renderer, rect);
+}
+
+extern "C" int __wrap_SDL_RenderFillRects(SDL_Renderer* renderer, const SDL_Rect* rects, int count) {
+    fillRects.fetch_add(1, std::memory_order_relaxed);
+    return __real_SDL_RenderFillRects(renderer, rects, count);
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    while (true) {
+        void* block = std::malloc(size);
+        if (block) return block;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept {
+    std::free(block);
+}
+
+uint64_t PerfHud::GetFillRectCount() {
+    return fillRects.load(std::memory_order_relaxed);
+}
+
+uint64_t PerfHud::GetAllocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+static const char* PHASE_NAMES[] = {"events", "update", "render", "present"};
+static const char* COUNTER_NAMES[] = {"glyphs", "textures", "fill rects", "save reads", "allocations",
+                                      "dir scans", "dir cache hits", "input us"};
+
+// Layout
+static const int PANEL_X = 510;
+static const int PANEL_Y = 60;
+static const int PANEL_W = 440;
+static const int COLUMN_1 = PANEL_X + 310;     // Right edges of the number columns
+static const int COLUMN_2 = PANEL_X + PANEL_W - 12;
+static const int GRAPH_HEIGHT = 40;
+static const int GRAPH_BUCKETS = 34;            // 1 ms each, the last holds everything slower
+
+// Value at fraction (0..1) of n samples; reorders values
+static float Percentile(float* values, int n, double fraction) {
+    if (n == 0) return 0.0f;
+    int k = std::min(n - 1, (int)(fraction * n));
+    std::nth_element(values, values + k, values + n);
+    return values[k];
+}
+
+PerfHud::PerfHud(SDL_Renderer* r, TextRenderer* t)
+    : renderer(r), text(t), ticksPerMicro(SDL_GetPerformanceFrequency() / 1000000.0),
+      ringHead(0), ringCount(0), current(), phaseStart(0), totals(), haveTotals(false),
+      visible(false), redrawNow(false), lastDrawTicks(0), rearFingers(0), rearStartTicks(0),
+      captureRequested(false) {
+}
+
+void PerfHud::BeginFrame() {
+    current = FrameSample();
+    phaseStart = SDL_GetPerformanceCounter();
+}
+
+void PerfHud::Mark(PerfPhase phase) {
+    uint64_t now = SDL_GetPerformanceCounter();
+    current.phaseMicros[(int)phase] += (float)((now - phaseStart) / ticksPerMicro);
+    phaseStart = now;
+}
+
+void PerfHud::SetTotal(PerfCounter counter, uint64_t total) {
+    int c = (int)counter;
+    current.counters[c] = haveTotals ? (uint32_t)(total - totals[c]) : 0;
+    totals[c] = total;
+}
+
+void PerfHud::Set(PerfCounter counter, uint32_t value) {
+    current.counters[(int)counter] = value;
+}
+
+void PerfHud::EndFrame() {
+    haveTotals = true;
+    ring[ringHead] = current;
+    ringHead = (ringHead + 1) % HISTORY;
+    if (ringCount < HISTORY) ringCount++;
+}
+
+const PerfHud::FrameSample& PerfHud::Sample(int age) const {
+    return ring[(ringHead - 1 - age + HISTORY) % HISTORY];
+}
+
+void PerfHud::Update() {
+    SceTouchData touch;
+    sceTouchPeek(SCE_TOUCH_PORT_BACK, &touch, 1);
+    int fingers = (int)touch.reportNum;
+    if (fingers > 0) {
+        if (rearFingers == 0) rearStartTicks = SDL_GetTicks();
+        rearFingers = std::max(rearFingers, fingers);
+        return;
+    }
+    if (rearFingers == 0) return;
+
+    // Only short taps count; the rear pad is where hands rest
+    if (SDL_GetTicks() - rearStartTicks < (uint32_t)TAP_MS) {
+        if (rearFingers == 1) {
+            visible = !visible;
+        } else {
+            std::string path = Dump();
+            status = path.empty() ? "Dump failed" : "Dumped to " + path;
+            printf("PerfHud: %s\n", status.c_str());
+            captureRequested = true;
+        }
+        redrawNow = true;
+    }
+    rearFingers = 0;
+}
+
+bool PerfHud::NeedsDraw() const {
+    return redrawNow || (visible && SDL_GetTicks() - lastDrawTicks >= (uint32_t)REDRAW_MS);
+}
+
+void PerfHud::Render() {
+    redrawNow = false;
+    lastDrawTicks = SDL_GetTicks();
+    if (!visible) return;
+
+    int lineHeight = text->GetLineHeight();
+    int panelHeight = lineHeight * (9 + (int)PerfCounter::COUNT) + GRAPH_HEIGHT + 24;
+    SDL_Rect panel = {PANEL_X, PANEL_Y, PANEL_W, panelHeight};
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 200);
+    SDL_RenderFillRect(renderer, &panel);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    SDL_Color accent = Colors::Accent();
+    SDL_SetRenderDrawColor(renderer, accent.r, accent.g, accent.b, accent.a);
+    SDL_RenderDrawRect(renderer, &panel);
+
+    // Frame times, and the graph's buckets, before any text goes out
+    float values[HISTORY];
+    int buckets[GRAPH_BUCKETS] = {};
+    for (int i = 0; i < ringCount; i++) {
+        const FrameSample& sample = Sample(i);
+        float total = 0.0f;
+        for (float micros : sample.phaseMicros) total += micros;
+        values[i] = total / 1000.0f;
+        buckets[std::min(GRAPH_BUCKETS - 1, (int)values[i])]++;
+    }
+
+    int graphY = PANEL_Y + 8 + lineHeight * 7;
+    int barWidth = (PANEL_W - 20) / GRAPH_BUCKETS;
+    int tallest = std::max(1, *std::max_element(buckets, buckets + GRAPH_BUCKETS));
+    SDL_Color bar = Colors::AccentHover();
+    SDL_SetRenderDrawColor(renderer, bar.r, bar.g, bar.b, bar.a);
+    for (int b = 0; b < GRAPH_BUCKETS; b++) {
+        if (buckets[b] == 0) continue;
+        int height = std::max(1, buckets[b] * GRAPH_HEIGHT / tallest);
+        SDL_Rect rect = {PANEL_X + 10 + b * barWidth, graphY + GRAPH_HEIGHT - height, barWidth - 1, height};
+        SDL_RenderFillRect(renderer, &rect);
+    }
+    SDL_Color dim = Colors::TextDim();
+    SDL_SetRenderDrawColor(renderer, dim.r, dim.g, dim.b, dim.a);
+    SDL_Rect vsyncLine = {PANEL_X + 10 + barWidth * 50 / 3, graphY, 1, GRAPH_HEIGHT};     // 16.7 ms
+    SDL_RenderFillRect(renderer, &vsyncLine);
+
+    text->BeginBatch();
+    char line[96];
+    int x = PANEL_X + 10;
+    int y = PANEL_Y + 8;
+    SDL_Color white = Colors::Text();
+
+    snprintf(line, sizeof(line), "PERF  %d frames", ringCount);
+    text->Draw(line, x, y, accent);
+    text->DrawRight("avg ms", COLUMN_1, y, dim);
+    text->DrawRight("p95 ms", COLUMN_2, y, dim);
+    y += lineHeight;
+
+    float phase[HISTORY];
+    for (int p = 0; p < (int)PerfPhase::COUNT; p++) {
+        double sum = 0.0;
+        for (int i = 0; i < ringCount; i++) {
+            phase[i] = Sample(i).phaseMicros[p] / 1000.0f;
+            sum += phase[i];
+        }
+        text->Draw(PHASE_NAMES[p], x, y, white);
+        snprintf(line, sizeof(line), "%.2f", ringCount ? sum / ringCount : 0.0);
+        text->DrawRight(line, COLUMN_1, y, white);
+        snprintf(line, sizeof(line), "%.2f", Percentile(phase, ringCount, 0.95));
+        text->DrawRight(line, COLUMN_2, y, white);
+        y += lineHeight;
+    }
+
+    float p50 = Percentile(values, ringCount, 0.50);
+    float p95 = Percentile(values, ringCount, 0.95);
+    float p99 = Percentile(values, ringCount, 0.99);
+    snprintf(line, sizeof(line), "frame  p50 %.1f  p95 %.1f  p99 %.1f ms", p50, p95, p99);
+    text->Draw(line, x, y, accent);
+    y += lineHeight;
+    text->Draw("0", x, y, dim);
+    text->DrawRight("33+ ms", COLUMN_2, y, dim);
+    y = graphY + GRAPH_HEIGHT + 8;
+
+    text->Draw("per frame", x, y, dim);
+    text->DrawRight("avg", COLUMN_1, y, dim);
+    text->DrawRight("max", COLUMN_2, y, dim);
+    y += lineHeight;
+    for (int c = 0; c < (int)PerfCounter::COUNT; c++) {
+        // Latency is averaged over the frames that had input, not all of them
+        bool sparse = c == (int)PerfCounter::INPUT_LATENCY;
+        uint64_t sum = 0;
+        uint32_t most = 0;
+        int samples = 0;
+        for (int i = 0; i < ringCount; i++) {
+            uint32_t value = Sample(i).counters[c];
+            if (sparse && value == 0) continue;
+            sum += value;
+            most = std::max(most, value);
+            samples++;
+        }
+        text->Draw(COUNTER_NAMES[c], x, y, white);
+        snprintf(line, sizeof(line), "%.1f", samples ? (double)sum / samples : 0.0);
+        text->DrawRight(line, COLUMN_1, y, white);
+        snprintf(line, sizeof(line), "%u", (unsigned)most);
+        text->DrawRight(line, COLUMN_2, y, white);
+        y += lineHeight;
+    }
+
+    const char* help = status.empty() ? "Rear tap: hide | 2 fingers: dump" : status.c_str();
+    text->Draw(help, x, y, dim);
+    text->EndBatch();
+}
+
+bool PerfHud::TakeCaptureRequest() {
+    bool requested = captureRequested;
+    captureRequested = false;
+    return requested;
+}
+
+std::string PerfHud::FreePath(const char* prefix, const char* extension) {
+    char path[96];
+    for (int i = 0; i < 1000; i++) {
+        snprintf(path, sizeof(path), "ux0:/data/slimseditor/%s_%03d%s", prefix, i, extension);
+        FILE* existing = fopen(path, "rb");
+        if (!existing) return path;
+        fclose(existing);
+    }
+    return "";
+}
+
+std::string PerfHud::Dump() {
+    // A fresh file each time, so earlier dumps are kept
+    std::string path = FreePath("perf", ".csv");
+    FILE* file = path.empty() ? nullptr : fopen(path.c_str(), "wb");
+    if (!file) return "";
+
+    fprintf(file, "frame");
+    for (const char* name : PHASE_NAMES) fprintf(file, ",%s_us", name);
+    for (const char* name : COUNTER_NAMES) {
+        std::string column = name;
+        std::replace(column.begin(), column.end(), ' ', '_');
+        fprintf(file, ",%s", column.c_str());
+    }
+    fprintf(file, "\n");
+
+    for (int age = ringCount - 1; age >= 0; age--) {
+        const FrameSample& sample = Sample(age);
+        fprintf(file, "%d", ringCount - 1 - age);
+        for (float micros : sample.phaseMicros) fprintf(file, ",%.1f", micros);
+        for (uint32_t count : sample.counters) fprintf(file, ",%u", (unsigned)count);
+        fprintf(file, "\n");
+    }
+
+    bool ok = ferror(file) == 0;
+    ok = (fclose(file) == 0) && ok;
+    return ok ? path : std::string();
+}
@@ -0,0 +1,102 @@
+// perf_hud.h - Toggleable overlay of frame phase timings and per-frame counters
+#pragma once
+#include <cstdint>
+#include <string>
+#include <SDL2/SDL.h>
+#include "text_renderer.h"
+
+enum class PerfPhase {
+    EVENTS,         // SDL events and input sampling
+    UPDATE,
+    RENDER,         // Drawing changed layers into the frame
+    PRESENT,        // Frame to screen, HUD, SDL_RenderPresent (vsync wait)
+    COUNT
+};
+
+enum class PerfCounter {
+    GLYPHS,         // TTF rasterisations
+    TEXTURES,       // Textures created
+    FILL_RECTS,     // SDL_RenderFillRect(s) calls
+    SAVE_READS,     // SaveFile reads
+    ALLOCATIONS,    // C++ heap allocations, all threads
+    DIR_SCANS,      // Folders read by the file browser
+    DIR_CACHE_HITS, // Folders shown from its listing cache
+    INPUT_LATENCY,  // Microseconds from input to present; 0 = no input this frame
+    COUNT
+};
+
+// Keeps the last HISTORY frames in a ring: phase times and how much each
+// counter moved. Recording a frame is a few stores; the statistics are
+// only worked out when the overlay is redrawn, a few times a second, so
+// the HUD can stay on while profiling.
+//
+// A one-finger tap on the rear touchpad shows or hides the overlay; a
+// two-finger tap dumps the ring as CSV to ux0:/data/slimseditor.
+class PerfHud {
+public:
+    PerfHud(SDL_Renderer* renderer, TextRenderer* text);
+
+    // Frame timing: Mark closes a phase, timed from BeginFrame or the
+    // previous Mark
+    void BeginFrame();
+    void Mark(PerfPhase phase);
+
+    // Counter sources report running totals; a frame records the change
+    void SetTotal(PerfCounter counter, uint64_t total);
+    // Per-frame values are recorded as they are
+    void Set(PerfCounter counter, uint32_t value);
+    void EndFrame();
+
+    void Update();
+    bool IsVisible() const { return visible; }
+
+    // True when the visible overlay is due for a redraw
+    bool NeedsDraw() const;
+    void Render();
+
+    // Writes the ring, oldest frame first; returns the path or "" on failure
+    std::string Dump();
+
+    // True once after a dump; the app then captures the next frame's
+    // draw list as well
+    bool TakeCaptureRequest();
+
+    // First ux0:/data/slimseditor/<prefix>_NNN<extension> not yet taken, or ""
+    static std::string FreePath(const char* prefix, const char* extension);
+
+    // Totals kept by hooks in perf_hud.cpp
+    static uint64_t GetFillRectCount();
+    static uint64_t GetAllocationCount();
+
+    static const int HISTORY = 600;
+    static const int REDRAW_MS = 250;
+    static const int TAP_MS = 300;
+
+private:
+    struct FrameSample {
+        float phaseMicros[(int)PerfPhase::COUNT];
+        uint32_t counters[(int)PerfCounter::COUNT];
+    };
+
+    SDL_Renderer* renderer;
+    TextRenderer* text;
+    double ticksPerMicro;
+
+    FrameSample ring[HISTORY];
+    int ringHead;               // Next slot to write
+    int ringCount;
+    FrameSample current;
+    uint64_t phaseStart;
+    uint64_t totals[(int)PerfCounter::COUNT];
+    bool haveTotals;
+
+    bool visible;
+    bool redrawNow;
+    uint32_t lastDrawTicks;
+    int rearFingers;            // Most fingers seen in the current rear touch
+    uint32_t rearStartTicks;
+    std::string status;
+    bool captureRequested;
+
+    const FrameSample& Sample(int age) const;   // 0 = newest
+};
@@ -0,0 +1,76 @@
+// retained_frame.cpp - Cached screen composed from layers redrawn only on change
+#include "retained_frame.h"
+#include <cstdio>
+
+RetainedFrame::RetainedFrame(SDL_Renderer* r, DrawList* d, int width, int height, SDL_Color bg)
+    : renderer(r), draw(d), texture(nullptr), bounds{0, 0, width, height}, background(bg) {
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!texture) {
+        printf("RetainedFrame: no render target (%s), redrawing every frame\n", SDL_GetError());
+    }
+}
+
+RetainedFrame::~RetainedFrame() {
+    if (texture) SDL_DestroyTexture(texture);
+}
+
+bool RetainedFrame::Begin() {
+    redrawn.clear();
+    if (!texture) return false;
+
+    if (SDL_SetRenderTarget(renderer, texture) != 0) {
+        // Lost the target (e.g. device reset); fall back for good
+        printf("RetainedFrame: cannot render to target (%s)\n", SDL_GetError());
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool RetainedFrame::Layer(int id, const SDL_Rect& area, uint64_t key) {
+    bool redraw = !texture;
+
+    LayerState* state = nullptr;
+    for (LayerState& layer : layers) {
+        if (layer.id == id) state = &layer;
+    }
+    if (!state) {
+        layers.push_back(LayerState{id, key});
+        redraw = true;
+    } else if (state->key != key) {
+        state->key = key;
+        redraw = true;
+    }
+
+    for (const SDL_Rect& below : redrawn) {
+        if (SDL_HasIntersection(&below, &area)) redraw = true;
+    }
+    if (!redraw) return false;
+
+    redrawn.push_back(area);
+    draw->Clip(area);
+    if (texture) {
+        draw->Fill(area, background);
+    }
+    return true;
+}
+
+void RetainedFrame::EndLayer() {
+    draw->NoClip();
+}
+
+bool RetainedFrame::End() {
+    if (texture) SDL_SetRenderTarget(renderer, nullptr);
+    return !redrawn.empty();
+}
+
+void RetainedFrame::Compose() {
+    if (texture) {
+        SDL_RenderCopy(renderer, texture, nullptr, &bounds);
+    }
+}
+
+void RetainedFrame::Invalidate() {
+    layers.clear();
+}
@@ -0,0 +1,82 @@
+// retained_frame.h - Cached screen composed from layers redrawn only on change
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SDL2/SDL.h>
+#include "draw_list.h"
+
+// FNV-1a over whatever a layer's pixels depend on
+class LayerKey {
+public:
+    LayerKey() : hash(14695981039346656037ull) {}
+
+    LayerKey& Add(uint64_t value) {
+        for (int i = 0; i < 8; i++) Mix((uint8_t)(value >> (i * 8)));
+        return *this;
+    }
+
+    LayerKey& Add(const char* text) {
+        while (text && *text) Mix((uint8_t)*text++);
+        Mix(0);
+        return *this;
+    }
+
+    uint64_t Get() const { return hash; }
+
+private:
+    uint64_t hash;
+
+    void Mix(uint8_t byte) {
+        hash = (hash ^ byte) * 1099511628211ull;
+    }
+};
+
+// The screen is kept in one render-target texture. Each frame the screens
+// walk their layers bottom to top; a layer is drawn into the texture only
+// if its key changed, or if a layer below it was redrawn where they
+// overlap. A frame where nothing was redrawn needs no present at all.
+// Layers record their clip and clear into the frame's DrawList, which the
+// caller submits between Begin and End.
+//
+// Without render-target support every layer is drawn straight to the
+// screen each frame, as before.
+class RetainedFrame {
+public:
+    RetainedFrame(SDL_Renderer* renderer, DrawList* draw, int width, int height, SDL_Color background);
+    ~RetainedFrame();
+
+    // Starts a frame. Returns false when drawing goes straight to the
+    // screen (no render targets); the caller clears the screen then.
+    bool Begin();
+
+    // True if the layer must be drawn now; the area is then cleared to the
+    // background (when retained) and clipped until EndLayer
+    bool Layer(int id, const SDL_Rect& area, uint64_t key);
+    void EndLayer();
+
+    // Finishes the frame; true if anything was redrawn
+    bool End();
+
+    // Copies the frame to the screen, ready for overlays and the present
+    void Compose();
+
+    // Forget every layer, e.g. when switching screens
+    void Invalidate();
+
+    bool IsRetained() const { return texture != nullptr; }
+
+private:
+    struct LayerState {
+        int id;
+        uint64_t key;
+    };
+
+    SDL_Renderer* renderer;
+    DrawList* draw;
+    SDL_Texture* texture;
+    SDL_Rect bounds;
+    SDL_Color background;
+    std::vector<LayerState> layers;
+    std::vector<SDL_Rect> redrawn;      // Areas drawn this frame, for layers above
+};
@@ -1,16 +1,81 @@
 // save_editor.cpp - SIMPLIFIED - Max ammo only, no detection
 #include "save_editor.h"
 #include "../utils/colors.h"
+#include "../core/game_detect.h"
+#include "../core/offset_db.h"
 #include "../data/rac_vita_games_data.h"
 #include <algorithm>
 #include <cstdio>
 
-SaveEditor::SaveEditor(SDL_Renderer* r, TTF_Font* f) 
-    : renderer(r), font(f), saveFile(nullptr), 
+// Every version a save had before the editor overwrote it
+static const char* BACKUP_DIR = "ux0:/data/slimseditor/backups";
+
+static const int TAB_COUNT = (int)EditorTab::COUNT;
+
+// Each band is redrawn only when something it shows changes
+static const SDL_Rect HEADER_AREA = {0, 0, 960, 80};
+static const SDL_Rect TABS_AREA = {0, 80, 960, 40};
+static const SDL_Rect CONTENT_AREA = {0, 120, 960, 380};
+static const SDL_Rect OVERLAY_AREA = {98, 118, 764, 304};
+static const SDL_Rect FOOTER_AREA = {0, 500, 960, 44};
+
+// Table tabs: rows 60 px apart from y = 135, six to a screen, each drawn
+// 5 px into its slot
+static const int LIST_TOP = 135;
+static const int LIST_HEIGHT = 360;
+static const int ROW_HEIGHT = 60;
+static const int ROW_INSET = 5;
+
+// Hex view layout: 16 bytes per row, hex cells with a gap after the eighth,
+// then the ASCII column and a scrollbar
+static const int HEX_COLUMNS = 16;
+static const int HEX_ROWS = 14;
+static const int HEX_ROW_HEIGHT = 24;
+static const int HEX_TOP = 130;
+static const int HEX_OFFSET_X = 25;
+static const int HEX_BYTES_X = 120;
+static const int HEX_CELL_WIDTH = 30;
+static const int HEX_GROUP_GAP = 8;
+static const int HEX_ASCII_X = 635;
+static const int HEX_ASCII_WIDTH = 14;
+static const int HEX_SCROLLBAR_X = 920;
+static const int HEX_SCROLLBAR_WIDTH = 20;
+
+static int HexCellX(int column) {
+    return HEX_BYTES_X + column * HEX_CELL_WIDTH + (column >= HEX_COLUMNS / 2 ? HEX_GROUP_GAP : 0);
+}
+
+// Column under x in the hex or ASCII area, or -1
+static int HexColumnAt(int x) {
+    if (x >= HEX_ASCII_X && x < HEX_ASCII_X + HEX_COLUMNS * HEX_ASCII_WIDTH) {
+        return (x - HEX_ASCII_X) / HEX_ASCII_WIDTH;
+    }
+    for (int column = 0; column < HEX_COLUMNS; column++) {
+        if (x >= HexCellX(column) && x < HexCellX(column) + HEX_CELL_WIDTH) return column;
+    }
+    return -1;
+}
+
+static SDL_Color HexFieldColor(FieldKind kind) {
+    switch (kind) {
+        case FieldKind::VALUE: return {25, 72, 126, 255};
+        case FieldKind::EXTRA_VALUE: return {52, 60, 126, 255};
+        case FieldKind::WEAPON: return {110, 60, 30, 255};
+        case FieldKind::GADGET: return {30, 96, 76, 255};
+        case FieldKind::UNLOCKABLE: return {96, 40, 90, 255};
+    }
+    return Colors::Panel();
+}
+
+SaveEditor::SaveEditor(DrawList* d, TextRenderer* t) 
+    : draw(d), text(t), saveFile(nullptr), backups(BACKUP_DIR),
       currentGameType(GameType::UNKNOWN),
       currentGameData(), 
-      currentTab(EditorTab::VALUES), selectedIndex(0), scrollOffset(0), 
-      wantsBack(false), isEditing(false), editingValue(0), editingMultiplier(1) {
+      currentTab(EditorTab::VALUES), list(LIST_TOP, LIST_HEIGHT, ROW_HEIGHT), 
+      wantsBack(false), isEditing(false), editingValue(0), editingMultiplier(1),
+      editingKind(EditKind::VALUE), hexCursor(0), hexTopRow(0), hexHeldFrames(0),
+      hexTouchStartY(0), hexTouchStartRow(0), hexDragging(false), hexScrollbarDragging(false) {
+    saveWorker.SetBackupStore(&backups);
 }
 
 SaveEditor::~SaveEditor() {
@@ -21,25 +86,41 @@ void SaveEditor::SetSaveFile(SaveFile* save) {
     
     if (saveFile && saveFile->IsLoaded()) {
         // AUTO-DETECT GAME TYPE
-        std::vector<uint8_t> data;
-        data.resize(saveFile->GetSize());
-        for (size_t i = 0; i < saveFile->GetSize(); i++) {
-            data[i] = saveFile->ReadByte(i);
-        }
-        
-        currentGameType = DetectGameType(data);
-        currentGameData = GameData(currentGameType);
-        
-        selectedIndex = 0;
-        scrollOffset = 0;
+        currentGameType = DetectGameType(saveFile->GetView());
+        currentGameData = GameTables::Get(currentGameType);
+        fields.Build(currentGameData);
+        fieldIndex.Build(currentGameData);
+        
+        list.Reset();
+        hexCursor = 0;
+        hexTopRow = 0;
         currentTab = EditorTab::VALUES;
+        list.SetCount(GetListSize());
         isEditing = false;
     }
 }
 
+int SaveEditor::GetListSize() const {
+    switch (currentTab) {
+        case EditorTab::VALUES:
+            return currentGameData.values.size() + currentGameData.extra_values.size();
+        case EditorTab::WEAPONS:
+            return currentGameData.weapons.size();
+        case EditorTab::GADGETS:
+            return currentGameData.gadgets.size();
+        case EditorTab::UNLOCKABLES:
+            return currentGameData.unlockables.size();
+        default:
+            return 0;
+    }
+}
+
 void SaveEditor::Update(const InputState& input) {
     if (!saveFile) return;
     
+    // Pick up finished background saves
+    saveWorker.Poll(saveFile);
+    
     // If we're in editing mode, handle editing controls
     if (isEditing) {
         UpdateEditingMode(input);
@@ -51,9 +132,7 @@ void SaveEditor::Update(const InputState& input) {
         // Save button (720, 20, 100, 40)
         if (input.touchX >= 720 && input.touchX <= 820 &&
             input.touchY >= 20 && input.touchY <= 60) {
-            if (saveFile->Save()) {
-                // Successfully saved
-            }
+            saveWorker.RequestSave(saveFile);
             return;
         }
         
@@ -68,72 +147,39 @@ void SaveEditor::Update(const InputState& input) {
     // Tab switching with L/R
     if (input.IsPressed(SCE_CTRL_LTRIGGER)) {
         int tab = (int)currentTab;
-        tab = (tab - 1 + 4) % 4;
+        tab = (tab - 1 + TAB_COUNT) % TAB_COUNT;
         currentTab = (EditorTab)tab;
-        selectedIndex = 0;
-        scrollOffset = 0;
+        list.Reset();
     }
     
     if (input.IsPressed(SCE_CTRL_RTRIGGER)) {
         int tab = (int)currentTab;
-        tab = (tab + 1) % 4;
+        tab = (tab + 1) % TAB_COUNT;
         currentTab = (EditorTab)tab;
-        selectedIndex = 0;
-        scrollOffset = 0;
-    }
-    
-    // Get current list size
-    int listSize = 0;
-    switch (currentTab) {
-        case EditorTab::VALUES:
-            listSize = currentGameData.values.size() + currentGameData.extra_values.size();
-            break;
-        case EditorTab::WEAPONS:
-            listSize = currentGameData.weapons.size();
-            break;
-        case EditorTab::GADGETS:
-            listSize = currentGameData.gadgets.size();
-            break;
-        case EditorTab::UNLOCKABLES:
-            listSize = currentGameData.unlockables.size();
-            break;
+        list.Reset();
     }
     
-    if (listSize == 0) return;
-    
-    const int VISIBLE_ITEMS = 6;
-    int maxScroll = (listSize > VISIBLE_ITEMS) ? (listSize - VISIBLE_ITEMS) : 0;
-    
-    // Navigation
-    if (input.IsPressed(SCE_CTRL_DOWN)) {
-        selectedIndex++;
-        if (selectedIndex >= listSize) selectedIndex = listSize - 1;
-        
-        if (selectedIndex >= scrollOffset + VISIBLE_ITEMS) {
-            scrollOffset = selectedIndex - VISIBLE_ITEMS + 1;
+    // Touch tab switching
+    if (input.touchPressed && input.touchY >= 80 && input.touchY < 120) {
+        int tabIndex = input.touchX / (960 / TAB_COUNT);
+        if (tabIndex >= 0 && tabIndex < TAB_COUNT) {
+            currentTab = (EditorTab)tabIndex;
+            list.Reset();
         }
     }
     
-    if (input.IsPressed(SCE_CTRL_UP)) {
-        selectedIndex--;
-        if (selectedIndex < 0) selectedIndex = 0;
-        
-        if (selectedIndex < scrollOffset) {
-            scrollOffset = selectedIndex;
-        }
+    // Undo with TRIANGLE, redo with SQUARE
+    if (input.IsPressed(SCE_CTRL_TRIANGLE)) {
+        saveFile->Undo();
     }
     
-    if (scrollOffset > maxScroll) scrollOffset = maxScroll;
-    if (scrollOffset < 0) scrollOffset = 0;
-    
-    // Edit/Toggle with X
-    if (input.IsPressed(SCE_CTRL_CROSS)) {
-        HandleCrossPress();
+    if (input.IsPressed(SCE_CTRL_SQUARE)) {
+        saveFile->Redo();
     }
     
     // Save with START
     if (input.IsPressed(SCE_CTRL_START)) {
-        saveFile->Save();
+        saveWorker.RequestSave(saveFile);
     }
     
     // Back with CIRCLE
@@ -141,82 +187,65 @@ void SaveEditor::Update(const InputState& input) {
         wantsBack = true;
     }
     
-    // Touch tab switching
-    if (input.touchPressed && input.touchY >= 80 && input.touchY < 120) {
-        int tabIndex = input.touchX / 240;
-        if (tabIndex >= 0 && tabIndex < 4) {
-            currentTab = (EditorTab)tabIndex;
-            selectedIndex = 0;
-            scrollOffset = 0;
-        }
-    }
-    
-    // Touch item selection
-    if (input.touchPressed && input.touchY >= 140 && input.touchY < 500) {
-        int itemY = 140;
-        for (int i = scrollOffset; i < listSize && i < scrollOffset + VISIBLE_ITEMS; i++) {
-            if (input.touchY >= itemY && input.touchY < itemY + 60) {
-                selectedIndex = i;
-                
-                // For gadgets/unlockables, toggle on touch
-                if ((currentTab == EditorTab::GADGETS || currentTab == EditorTab::UNLOCKABLES) && 
-                    input.touchX >= 20 && input.touchX <= 50) {
-                    HandleCrossPress();
-                }
-                break;
-            }
-            itemY += 60;
-        }
+    if (currentTab == EditorTab::HEX) {
+        UpdateHexView(input);
+        return;
     }
     
-    // TOUCH SCROLLING
-    static int touchStartY = 0;
-    static int touchStartScroll = 0;
-    static bool wasTouching = false;
+    int listSize = GetListSize();
+    list.SetCount(listSize);
+    if (listSize == 0) return;
     
-    if (input.touchPressed && input.touchY >= 140 && input.touchY < 500) {
-        if (!wasTouching) {
-            touchStartY = input.touchY;
-            touchStartScroll = scrollOffset;
-            wasTouching = true;
-        }
-    }
+    // D-pad and touch scrolling; only a tap comes back
+    int tapped = list.Update(input);
     
-    if (wasTouching && input.touchY >= 140 && input.touchY < 500) {
-        int dragDistance = touchStartY - input.touchY;
-        int scrollDelta = dragDistance / 60;
-        
-        scrollOffset = touchStartScroll + scrollDelta;
-        
-        if (scrollOffset < 0) scrollOffset = 0;
-        if (scrollOffset > maxScroll) scrollOffset = maxScroll;
+    // Edit/Toggle with X
+    if (input.IsPressed(SCE_CTRL_CROSS)) {
+        HandleCrossPress();
     }
     
-    if (input.touchReleased) {
-        wasTouching = false;
+    // Tap selects; on gadgets/unlockables a tap on the checkbox toggles it
+    if (tapped >= 0) {
+        list.Select(tapped);
+        if ((currentTab == EditorTab::GADGETS || currentTab == EditorTab::UNLOCKABLES) && 
+            input.touchX >= 20 && input.touchX <= 50) {
+            HandleCrossPress();
+        }
     }
 }
 
 void SaveEditor::UpdateEditingMode(const InputState& input) {
-    // Change multiplier with L/R
-    if (input.IsPressed(SCE_CTRL_LTRIGGER)) {
-        if (editingMultiplier == 1) editingMultiplier = 1000000;
-        else if (editingMultiplier == 10) editingMultiplier = 1;
-        else if (editingMultiplier == 100) editingMultiplier = 10;
-        else if (editingMultiplier == 1000) editingMultiplier = 100;
-        else if (editingMultiplier == 10000) editingMultiplier = 1000;
-        else if (editingMultiplier == 100000) editingMultiplier = 10000;
-        else if (editingMultiplier == 1000000) editingMultiplier = 100000;
-    }
+    // Change multiplier with L/R; bytes and offsets step one hex digit
+    if (editingKind != EditKind::VALUE) {
+        int maxStep = 1;
+        while (maxStep <= editingMaxValue / 16) maxStep *= 16;
+        
+        if (input.IsPressed(SCE_CTRL_LTRIGGER)) {
+            editingMultiplier = editingMultiplier > 1 ? editingMultiplier / 16 : maxStep;
+        }
+        if (input.IsPressed(SCE_CTRL_RTRIGGER)) {
+            editingMultiplier = editingMultiplier < maxStep ? editingMultiplier * 16 : 1;
+        }
+    } else {
+        if (input.IsPressed(SCE_CTRL_LTRIGGER)) {
+            if (editingMultiplier == 1) editingMultiplier = 1000000;
+            else if (editingMultiplier == 10) editingMultiplier = 1;
+            else if (editingMultiplier == 100) editingMultiplier = 10;
+            else if (editingMultiplier == 1000) editingMultiplier = 100;
+            else if (editingMultiplier == 10000) editingMultiplier = 1000;
+            else if (editingMultiplier == 100000) editingMultiplier = 10000;
+            else if (editingMultiplier == 1000000) editingMultiplier = 100000;
+        }
     
-    if (input.IsPressed(SCE_CTRL_RTRIGGER)) {
-        if (editingMultiplier == 1) editingMultiplier = 10;
-        else if (editingMultiplier == 10) editingMultiplier = 100;
-        else if (editingMultiplier == 100) editingMultiplier = 1000;
-        else if (editingMultiplier == 1000) editingMultiplier = 10000;
-        else if (editingMultiplier == 10000) editingMultiplier = 100000;
-        else if (editingMultiplier == 100000) editingMultiplier = 1000000;
-        else if (editingMultiplier == 1000000) editingMultiplier = 1;
+        if (input.IsPressed(SCE_CTRL_RTRIGGER)) {
+            if (editingMultiplier == 1) editingMultiplier = 10;
+            else if (editingMultiplier == 10) editingMultiplier = 100;
+            else if (editingMultiplier == 100) editingMultiplier = 1000;
+            else if (editingMultiplier == 1000) editingMultiplier = 10000;
+            else if (editingMultiplier == 10000) editingMultiplier = 100000;
+            else if (editingMultiplier == 100000) editingMultiplier = 1000000;
+            else if (editingMultiplier == 1000000) editingMultiplier = 1;
+        }
     }
     
     // Adjust value with D-pad
@@ -265,10 +294,16 @@ void SaveEditor::HandleCrossPress() {
         case EditorTab::UNLOCKABLES:
             ToggleUnlockable();
             break;
+        case EditorTab::HEX:
+            EditHexByte();
+            break;
+        default:
+            break;
     }
 }
 
 void SaveEditor::EditValue() {
+    int selectedIndex = list.GetSelected();
     int totalValues = currentGameData.values.size() + currentGameData.extra_values.size();
     if (selectedIndex >= totalValues || !saveFile) return;
     
@@ -287,9 +322,11 @@ void SaveEditor::EditValue() {
     editingMaxValue = value->max_value;
     editingMultiplier = 1000;
     editingOffset = value->offset;
+    editingKind = EditKind::VALUE;
 }
 
 void SaveEditor::EditWeaponAmmo() {
+    int selectedIndex = list.GetSelected();
     if (selectedIndex >= (int)currentGameData.weapons.size() || !saveFile) return;
     
     const GameWeapon& weapon = currentGameData.weapons[selectedIndex];
@@ -301,15 +338,29 @@ void SaveEditor::EditWeaponAmmo() {
     editingMaxValue = weapon.max_ammo;  // Just use max_ammo directly!
     editingMultiplier = 10;
     editingOffset = weapon.ammo_offset;
+    editingKind = EditKind::VALUE;
 }
 
 void SaveEditor::SaveEditedValue() {
-    if (saveFile) {
+    if (!saveFile) return;
+    
+    if (editingKind == EditKind::JUMP) {
+        SetHexCursor(editingValue);
+        return;
+    }
+    
+    // Repeated edits of the same field undo as one step
+    saveFile->BeginTransaction(editingOffset + 1);
+    if (editingKind == EditKind::BYTE) {
+        saveFile->WriteByte(editingOffset, (uint8_t)editingValue);
+    } else {
         saveFile->WriteInt32(editingOffset, editingValue);
     }
+    saveFile->EndTransaction();
 }
 
 void SaveEditor::ToggleGadget() {
+    int selectedIndex = list.GetSelected();
     if (selectedIndex >= (int)currentGameData.gadgets.size() || !saveFile) return;
     
     const GameGadget& gadget = currentGameData.gadgets[selectedIndex];
@@ -318,6 +369,7 @@ void SaveEditor::ToggleGadget() {
 }
 
 void SaveEditor::ToggleUnlockable() {
+    int selectedIndex = list.GetSelected();
     if (selectedIndex >= (int)currentGameData.unlockables.size() || !saveFile) return;
     
     const GameUnlockable& unlockable = currentGameData.unlockables[selectedIndex];
@@ -325,166 +377,263 @@ void SaveEditor::ToggleUnlockable() {
     saveFile->WriteBool(unlockable.offset, !current, unlockable.bit_index);
 }
 
-void SaveEditor::Render() {
-    if (isEditing) {
-        RenderHeader();
-        RenderTabs();
-        RenderTabContent();
-        RenderEditingOverlay();
-        RenderFooter();
-    } else {
+void SaveEditor::UpdateHexView(const InputState& input) {
+    uint32_t size = saveFile->GetSize();
+    if (size == 0) return;
+    uint32_t totalRows = (size + HEX_COLUMNS - 1) / HEX_COLUMNS;
+    uint32_t maxTopRow = totalRows > (uint32_t)HEX_ROWS ? totalRows - HEX_ROWS : 0;
+    
+    // D-pad moves the cursor; held, it repeats after a short delay and
+    // doubles its stride every half second, so the far end of a 2 MB save
+    // is a few seconds away
+    const uint32_t DIRECTIONS = SCE_CTRL_UP | SCE_CTRL_DOWN | SCE_CTRL_LEFT | SCE_CTRL_RIGHT;
+    hexHeldFrames = (input.held & DIRECTIONS) ? hexHeldFrames + 1 : 0;
+    
+    int64_t step = 0;
+    if (input.pressed & DIRECTIONS) {
+        step = 1;
+    } else if (hexHeldFrames > 20) {
+        step = (int64_t)1 << std::min((hexHeldFrames - 20) / 30, 12);
+    }
+    
+    if (step > 0) {
+        int64_t delta = 0;
+        if (input.IsHeld(SCE_CTRL_UP)) delta -= step * HEX_COLUMNS;
+        if (input.IsHeld(SCE_CTRL_DOWN)) delta += step * HEX_COLUMNS;
+        if (input.IsHeld(SCE_CTRL_LEFT)) delta -= step;
+        if (input.IsHeld(SCE_CTRL_RIGHT)) delta += step;
+        if (delta != 0) SetHexCursor((int64_t)hexCursor + delta);
+    }
+    
+    // Edit the byte with X, go to an offset with SELECT
+    if (input.IsPressed(SCE_CTRL_CROSS)) {
+        EditHexByte();
+    }
+    
+    if (input.IsPressed(SCE_CTRL_SELECT)) {
+        OpenHexJump();
+    }
+    
+    // Touch: tap a byte to select it, drag to scroll, or drag the scrollbar
+    int hexBottom = HEX_TOP + HEX_ROWS * HEX_ROW_HEIGHT;
+    if (input.touchPressed && input.touchY >= HEX_TOP && input.touchY < hexBottom) {
+        if (input.touchX >= HEX_SCROLLBAR_X) {
+            hexScrollbarDragging = true;
+        } else {
+            int column = HexColumnAt(input.touchX);
+            if (column >= 0) {
+                uint32_t row = hexTopRow + (input.touchY - HEX_TOP) / HEX_ROW_HEIGHT;
+                uint64_t offset = (uint64_t)row * HEX_COLUMNS + column;
+                if (offset < size) hexCursor = (uint32_t)offset;
+            }
+            hexDragging = true;
+            hexTouchStartY = input.touchY;
+            hexTouchStartRow = hexTopRow;
+        }
+    }
+    
+    if (hexScrollbarDragging) {
+        int track = std::min(std::max(input.touchY - HEX_TOP, 0), hexBottom - HEX_TOP);
+        hexTopRow = (uint32_t)((uint64_t)maxTopRow * track / (hexBottom - HEX_TOP));
+    } else if (hexDragging) {
+        int64_t row = (int64_t)hexTouchStartRow + (hexTouchStartY - input.touchY) / HEX_ROW_HEIGHT;
+        hexTopRow = (uint32_t)std::min<int64_t>(std::max<int64_t>(row, 0), maxTopRow);
+    }
+    
+    if (input.touchReleased) {
+        hexDragging = false;
+        hexScrollbarDragging = false;
+    }
+}
+
+void SaveEditor::SetHexCursor(int64_t offset) {
+    uint32_t size = saveFile ? saveFile->GetSize() : 0;
+    if (size == 0) return;
+    
+    hexCursor = (uint32_t)std::min<int64_t>(std::max<int64_t>(offset, 0), size - 1);
+    
+    // Keep the cursor's row on screen
+    uint32_t row = hexCursor / HEX_COLUMNS;
+    if (row < hexTopRow) {
+        hexTopRow = row;
+    } else if (row >= hexTopRow + HEX_ROWS) {
+        hexTopRow = row - HEX_ROWS + 1;
+    }
+}
+
+void SaveEditor::EditHexByte() {
+    if (!saveFile || hexCursor >= saveFile->GetSize()) return;
+    
+    isEditing = true;
+    editingValue = saveFile->ReadByte(hexCursor);
+    editingMinValue = 0;
+    editingMaxValue = 0xFF;
+    editingMultiplier = 1;
+    editingOffset = hexCursor;
+    editingKind = EditKind::BYTE;
+}
+
+void SaveEditor::OpenHexJump() {
+    if (!saveFile || saveFile->GetSize() == 0) return;
+    
+    isEditing = true;
+    editingValue = hexCursor;
+    editingMinValue = 0;
+    editingMaxValue = saveFile->GetSize() - 1;
+    editingMultiplier = 0x1000;
+    editingOffset = hexCursor;
+    editingKind = EditKind::JUMP;
+}
+
+std::string SaveEditor::GetScreenName() const {
+    const char* tabNames[] = {"values", "weapons", "gadgets", "unlockables", "hex"};
+    std::string name = std::string("save_editor_") + tabNames[(int)currentTab];
+    if (isEditing) name += "_editing";
+    return name;
+}
+
+void SaveEditor::Render(RetainedFrame& frame) {
+    // Rows below read the snapshot; it only re-gathers after an edit
+    if (saveFile) {
+        fields.Refresh(*saveFile);
+    }
+    
+    // The editing overlay sits on top of the tab content, so it is
+    // redrawn whenever the content under it is
+    
+    SaveStatus saveStatus = saveWorker.GetStatus();
+    LayerKey headerKey;
+    headerKey.Add(isEditing).Add((uint64_t)currentGameType).Add((uint64_t)saveStatus)
+             .Add(saveFile && saveFile->IsModified()).Add(saveWorker.GetBackupFailures() > 0);
+    if (frame.Layer(0, HEADER_AREA, headerKey.Get())) {
         RenderHeader();
+        if (isEditing) DimBehindOverlay();
+        frame.EndLayer();
+    }
+    
+    if (frame.Layer(1, TABS_AREA, LayerKey().Add(isEditing).Add((uint64_t)currentTab).Get())) {
         RenderTabs();
+        if (isEditing) DimBehindOverlay();
+        frame.EndLayer();
+    }
+    
+    LayerKey contentKey;
+    contentKey.Add(isEditing).Add((uint64_t)currentTab).Add(list.GetScroll()).Add(list.GetSelected())
+              .Add((uint64_t)(uintptr_t)saveFile).Add(saveFile ? saveFile->GetVersion() : 0);
+    if (currentTab == EditorTab::HEX) {
+        contentKey.Add(hexCursor).Add(hexTopRow).Add(hexScrollbarDragging);
+    }
+    if (frame.Layer(2, CONTENT_AREA, contentKey.Get())) {
         RenderTabContent();
+        if (isEditing) DimBehindOverlay();
+        frame.EndLayer();
+    }
+    
+    if (isEditing) {
+        LayerKey overlayKey;
+        overlayKey.Add((uint64_t)editingKind).Add(editingValue).Add(editingMultiplier)
+                  .Add(editingMinValue).Add(editingMaxValue).Add(editingOffset);
+        if (frame.Layer(3, OVERLAY_AREA, overlayKey.Get())) {
+            RenderEditingOverlay();
+            frame.EndLayer();
+        }
+    }
+    
+    if (frame.Layer(4, FOOTER_AREA, LayerKey().Add((uint64_t)currentTab).Get())) {
         RenderFooter();
+        frame.EndLayer();
     }
 }
 
 void SaveEditor::RenderHeader() {
     SDL_Color panelTop = Colors::Panel();
-    SDL_SetRenderDrawColor(renderer, panelTop.r, panelTop.g, panelTop.b, panelTop.a);
     SDL_Rect headerRect = {0, 0, 960, 80};
-    SDL_RenderFillRect(renderer, &headerRect);
+    draw->Fill(headerRect, panelTop);
     
     SDL_Color accentColor = Colors::Accent();
-    SDL_SetRenderDrawColor(renderer, accentColor.r, accentColor.g, accentColor.b, accentColor.a);
     SDL_Rect borderRect = {0, 78, 960, 2};
-    SDL_RenderFillRect(renderer, &borderRect);
+    draw->Fill(borderRect, accentColor);
     
     // Game icon
     SDL_Color iconColor = Colors::Accent();
-    SDL_SetRenderDrawColor(renderer, iconColor.r, iconColor.g, iconColor.b, iconColor.a);
     SDL_Rect iconRect = {15, 15, 50, 50};
-    SDL_RenderFillRect(renderer, &iconRect);
+    draw->Fill(iconRect, iconColor);
     
     SDL_Color iconBorder = Colors::AccentHover();
-    SDL_SetRenderDrawColor(renderer, iconBorder.r, iconBorder.g, iconBorder.b, iconBorder.a);
-    SDL_RenderDrawRect(renderer, &iconRect);
+    draw->Outline(iconRect, iconBorder);
     
     // Game name
-    const char* gameName = currentGameData.name.c_str();
+    const char* gameName = currentGameData.name;
     if (currentGameType == GameType::UNKNOWN) {
         gameName = "UNKNOWN GAME";
     }
     
-    SDL_Surface* titleSurface = TTF_RenderUTF8_Blended(font, gameName, Colors::Text());
-    if (titleSurface) {
-        SDL_Texture* titleTexture = SDL_CreateTextureFromSurface(renderer, titleSurface);
-        SDL_Rect titleRect = {75, 15, titleSurface->w, titleSurface->h};
-        SDL_RenderCopy(renderer, titleTexture, nullptr, &titleRect);
-        SDL_DestroyTexture(titleTexture);
-        SDL_FreeSurface(titleSurface);
-    }
+    draw->Text(gameName, 75, 15, Colors::Text());
     
     // Status indicator
-    if (saveFile && saveFile->IsModified()) {
-        SDL_Color warningColor = Colors::Warning();
-        SDL_Surface* modSurface = TTF_RenderUTF8_Blended(font, "UNSAVED CHANGES", warningColor);
-        if (modSurface) {
-            SDL_Texture* modTexture = SDL_CreateTextureFromSurface(renderer, modSurface);
-            SDL_Rect modRect = {75, 45, modSurface->w, modSurface->h};
-            SDL_RenderCopy(renderer, modTexture, nullptr, &modRect);
-            SDL_DestroyTexture(modTexture);
-            SDL_FreeSurface(modSurface);
-        }
-    } else {
-        SDL_Color successColor = Colors::Success();
-        SDL_Surface* savedSurface = TTF_RenderUTF8_Blended(font, "ALL SAVED", successColor);
-        if (savedSurface) {
-            SDL_Texture* savedTexture = SDL_CreateTextureFromSurface(renderer, savedSurface);
-            SDL_Rect savedRect = {75, 45, savedSurface->w, savedSurface->h};
-            SDL_RenderCopy(renderer, savedTexture, nullptr, &savedRect);
-            SDL_DestroyTexture(savedTexture);
-            SDL_FreeSurface(savedSurface);
-        }
-    }
+    const char* statusText = "ALL SAVED";
+    SDL_Color statusColor = Colors::Success();
+    SaveStatus saveStatus = saveWorker.GetStatus();
+    
+    if (saveStatus == SaveStatus::SAVING) {
+        statusText = "SAVING...";
+        statusColor = Colors::AccentHover();
+    } else if (saveStatus == SaveStatus::FAILED) {
+        statusText = "SAVE FAILED";
+        statusColor = Colors::Error();
+    } else if (saveFile && saveFile->IsModified()) {
+        statusText = "UNSAVED CHANGES";
+        statusColor = Colors::Warning();
+    } else if (saveStatus == SaveStatus::SAVED && saveWorker.GetBackupFailures() > 0) {
+        statusText = "SAVED - BACKUP FAILED";
+        statusColor = Colors::Warning();
+    }
+    
+    draw->Text(statusText, 75, 45, statusColor);
     
     // SAVE button
     SDL_Rect saveBtn = {720, 20, 100, 40};
     SDL_Color saveBg = Colors::Success();
-    SDL_SetRenderDrawColor(renderer, saveBg.r, saveBg.g, saveBg.b, saveBg.a);
-    SDL_RenderFillRect(renderer, &saveBtn);
+    draw->Fill(saveBtn, saveBg);
     
     SDL_Color btnBorder = Colors::Border();
-    SDL_SetRenderDrawColor(renderer, btnBorder.r, btnBorder.g, btnBorder.b, btnBorder.a);
-    SDL_RenderDrawRect(renderer, &saveBtn);
-    
-    SDL_Surface* saveSurface = TTF_RenderUTF8_Blended(font, "SAVE", Colors::Text());
-    if (saveSurface) {
-        SDL_Texture* saveTexture = SDL_CreateTextureFromSurface(renderer, saveSurface);
-        SDL_Rect saveTextRect = {
-            saveBtn.x + (saveBtn.w - saveSurface->w) / 2,
-            saveBtn.y + (saveBtn.h - saveSurface->h) / 2,
-            saveSurface->w,
-            saveSurface->h
-        };
-        SDL_RenderCopy(renderer, saveTexture, nullptr, &saveTextRect);
-        SDL_DestroyTexture(saveTexture);
-        SDL_FreeSurface(saveSurface);
-    }
+    draw->Outline(saveBtn, btnBorder);
+    
+    draw->TextCentered("SAVE", saveBtn.x + saveBtn.w / 2, saveBtn.y + (saveBtn.h - text->GetLineHeight()) / 2, Colors::Text());
     
     // BACK button
     SDL_Rect backBtn = {830, 20, 100, 40};
     SDL_Color backBg = Colors::Error();
-    SDL_SetRenderDrawColor(renderer, backBg.r, backBg.g, backBg.b, backBg.a);
-    SDL_RenderFillRect(renderer, &backBtn);
+    draw->Fill(backBtn, backBg);
     
-    SDL_SetRenderDrawColor(renderer, btnBorder.r, btnBorder.g, btnBorder.b, btnBorder.a);
-    SDL_RenderDrawRect(renderer, &backBtn);
+    draw->Outline(backBtn, btnBorder);
     
-    SDL_Surface* backSurface = TTF_RenderUTF8_Blended(font, "BACK", Colors::Text());
-    if (backSurface) {
-        SDL_Texture* backTexture = SDL_CreateTextureFromSurface(renderer, backSurface);
-        SDL_Rect backTextRect = {
-            backBtn.x + (backBtn.w - backSurface->w) / 2,
-            backBtn.y + (backBtn.h - backSurface->h) / 2,
-            backSurface->w,
-            backSurface->h
-        };
-        SDL_RenderCopy(renderer, backTexture, nullptr, &backTextRect);
-        SDL_DestroyTexture(backTexture);
-        SDL_FreeSurface(backSurface);
-    }
+    draw->TextCentered("BACK", backBtn.x + backBtn.w / 2, backBtn.y + (backBtn.h - text->GetLineHeight()) / 2, Colors::Text());
 }
 
 void SaveEditor::RenderTabs() {
-    const char* tabNames[] = {"Values", "Weapons", "Gadgets", "Unlocks"};
-    int tabWidth = 240;
+    const char* tabNames[] = {"Values", "Weapons", "Gadgets", "Unlocks", "Hex"};
+    int tabWidth = 960 / TAB_COUNT;
     int tabY = 80;
     
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < TAB_COUNT; i++) {
         bool selected = ((int)currentTab == i);
         
         SDL_Color bgColor = selected ? Colors::Selected() : Colors::PanelDark();
-        SDL_SetRenderDrawColor(renderer, bgColor.r, bgColor.g, bgColor.b, bgColor.a);
         SDL_Rect tabRect = {i * tabWidth, tabY, tabWidth, 40};
-        SDL_RenderFillRect(renderer, &tabRect);
+        draw->Fill(tabRect, bgColor);
         
         if (selected) {
             SDL_Color indicatorColor = Colors::Accent();
-            SDL_SetRenderDrawColor(renderer, indicatorColor.r, indicatorColor.g, indicatorColor.b, indicatorColor.a);
             SDL_Rect indicator = {i * tabWidth, tabY + 37, tabWidth, 3};
-            SDL_RenderFillRect(renderer, &indicator);
+            draw->Fill(indicator, indicatorColor);
         }
         
         SDL_Color borderColor = Colors::Border();
-        SDL_SetRenderDrawColor(renderer, borderColor.r, borderColor.g, borderColor.b, borderColor.a);
-        SDL_RenderDrawRect(renderer, &tabRect);
+        draw->Outline(tabRect, borderColor);
         
         SDL_Color textColor = selected ? Colors::Accent() : Colors::Text();
-        SDL_Surface* textSurface = TTF_RenderUTF8_Blended(font, tabNames[i], textColor);
-        if (textSurface) {
-            SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-            SDL_Rect textRect = {
-                i * tabWidth + (tabWidth - textSurface->w) / 2,
-                tabY + (40 - textSurface->h) / 2,
-                textSurface->w,
-                textSurface->h
-            };
-            SDL_RenderCopy(renderer, textTexture, nullptr, &textRect);
-            SDL_DestroyTexture(textTexture);
-            SDL_FreeSurface(textSurface);
-        }
+        draw->TextCentered(tabNames[i], i * tabWidth + tabWidth / 2, tabY + (40 - text->GetLineHeight()) / 2, textColor);
     }
 }
 
@@ -502,17 +651,19 @@ void SaveEditor::RenderTabContent() {
         case EditorTab::UNLOCKABLES:
             RenderUnlockablesTab();
             break;
+        case EditorTab::HEX:
+            RenderHexTab();
+            break;
+        default:
+            break;
     }
 }
 
 void SaveEditor::RenderValuesTab() {
-    int y = 140;
-    int visibleCount = 0;
-    const int VISIBLE_ITEMS = 6;
-    
-    int totalValues = currentGameData.values.size() + currentGameData.extra_values.size();
+    draw->Clip(list.GetClip());
     
-    for (int i = scrollOffset; i < totalValues && visibleCount < VISIBLE_ITEMS; i++, visibleCount++) {
+    for (int i = list.GetFirstVisible(); i < list.GetLastVisible(); i++) {
+        int y = list.GetRowY(i) + ROW_INSET;
         const GameValue* value = nullptr;
         if (i < (int)currentGameData.values.size()) {
             value = &currentGameData.values[i];
@@ -520,346 +671,304 @@ void SaveEditor::RenderValuesTab() {
             value = &currentGameData.extra_values[i - currentGameData.values.size()];
         }
         
-        bool selected = (i == selectedIndex);
+        bool selected = (i == list.GetSelected());
         
         SDL_Color bgColor = selected ? Colors::SelectedLight() : Colors::Panel();
-        SDL_SetRenderDrawColor(renderer, bgColor.r, bgColor.g, bgColor.b, bgColor.a);
         SDL_Rect itemRect = {15, y - 5, 930, 55};
-        SDL_RenderFillRect(renderer, &itemRect);
+        draw->Fill(itemRect, bgColor);
         
         if (selected) {
             SDL_Color indicatorColor = Colors::Accent();
-            SDL_SetRenderDrawColor(renderer, indicatorColor.r, indicatorColor.g, indicatorColor.b, indicatorColor.a);
             SDL_Rect indicator = {15, y - 5, 5, 55};
-            SDL_RenderFillRect(renderer, &indicator);
+            draw->Fill(indicator, indicatorColor);
         }
         
         SDL_Color borderColor = selected ? Colors::Accent() : Colors::Border();
-        SDL_SetRenderDrawColor(renderer, borderColor.r, borderColor.g, borderColor.b, borderColor.a);
-        SDL_RenderDrawRect(renderer, &itemRect);
+        draw->Outline(itemRect, borderColor);
         
         SDL_Color textColor = selected ? Colors::Accent() : Colors::Text();
-        SDL_Surface* nameSurface = TTF_RenderUTF8_Blended(font, value->name.c_str(), textColor);
-        if (nameSurface) {
-            SDL_Texture* nameTexture = SDL_CreateTextureFromSurface(renderer, nameSurface);
-            SDL_Rect nameRect = {30, y + 5, nameSurface->w, nameSurface->h};
-            SDL_RenderCopy(renderer, nameTexture, nullptr, &nameRect);
-            SDL_DestroyTexture(nameTexture);
-            SDL_FreeSurface(nameSurface);
-        }
-        
-        int currentValue = saveFile->ReadInt32(value->offset);
-        char valueBuf[64];
-        snprintf(valueBuf, sizeof(valueBuf), "%d", currentValue);
+        draw->Text(value->name, 30, y + 5, textColor);
         
         SDL_Color valueColor = Colors::AccentHover();
-        SDL_Surface* valueSurface = TTF_RenderUTF8_Blended(font, valueBuf, valueColor);
-        if (valueSurface) {
-            SDL_Texture* valueTexture = SDL_CreateTextureFromSurface(renderer, valueSurface);
-            SDL_Rect valueRect = {920 - valueSurface->w, y + 5, valueSurface->w, valueSurface->h};
-            SDL_RenderCopy(renderer, valueTexture, nullptr, &valueRect);
-            SDL_DestroyTexture(valueTexture);
-            SDL_FreeSurface(valueSurface);
-        }
+        const char* valueText = fields.GetText(FieldGroup::VALUES, i);
+        draw->TextRight(valueText, 920, y + 5, valueColor);
         
         SDL_Color dimColor = Colors::TextDim();
-        SDL_Surface* descSurface = TTF_RenderUTF8_Blended(font, value->description.c_str(), dimColor);
-        if (descSurface) {
-            SDL_Texture* descTexture = SDL_CreateTextureFromSurface(renderer, descSurface);
-            SDL_Rect descRect = {30, y + 30, descSurface->w, descSurface->h};
-            SDL_RenderCopy(renderer, descTexture, nullptr, &descRect);
-            SDL_DestroyTexture(descTexture);
-            SDL_FreeSurface(descSurface);
-        }
-        
-        y += 60;
+        draw->Text(value->description, 30, y + 30, dimColor);
     }
+    draw->Clip(CONTENT_AREA);
 }
 
 void SaveEditor::RenderWeaponsTab() {
-    int y = 140;
-    int visibleCount = 0;
-    const int VISIBLE_ITEMS = 6;
+    draw->Clip(list.GetClip());
     
-    for (int i = scrollOffset; i < (int)currentGameData.weapons.size() && visibleCount < VISIBLE_ITEMS; i++, visibleCount++) {
+    for (int i = list.GetFirstVisible(); i < list.GetLastVisible(); i++) {
+        int y = list.GetRowY(i) + ROW_INSET;
         const GameWeapon& weapon = currentGameData.weapons[i];
-        bool selected = (i == selectedIndex);
+        bool selected = (i == list.GetSelected());
         
         SDL_Color bgColor = selected ? Colors::SelectedLight() : Colors::Panel();
-        SDL_SetRenderDrawColor(renderer, bgColor.r, bgColor.g, bgColor.b, bgColor.a);
         SDL_Rect itemRect = {15, y - 5, 930, 55};
-        SDL_RenderFillRect(renderer, &itemRect);
+        draw->Fill(itemRect, bgColor);
         
         if (selected) {
             SDL_Color indicatorColor = Colors::Accent();
-            SDL_SetRenderDrawColor(renderer, indicatorColor.r, indicatorColor.g, indicatorColor.b, indicatorColor.a);
             SDL_Rect indicator = {15, y - 5, 5, 55};
-            SDL_RenderFillRect(renderer, &indicator);
+            draw->Fill(indicator, indicatorColor);
         }
         
         SDL_Color borderColor = selected ? Colors::Accent() : Colors::Border();
-        SDL_SetRenderDrawColor(renderer, borderColor.r, borderColor.g, borderColor.b, borderColor.a);
-        SDL_RenderDrawRect(renderer, &itemRect);
+        draw->Outline(itemRect, borderColor);
         
         SDL_Color textColor = selected ? Colors::Accent() : Colors::Text();
-        SDL_Surface* nameSurface = TTF_RenderUTF8_Blended(font, weapon.name.c_str(), textColor);
-        if (nameSurface) {
-            SDL_Texture* nameTexture = SDL_CreateTextureFromSurface(renderer, nameSurface);
-            SDL_Rect nameRect = {30, y + 5, nameSurface->w, nameSurface->h};
-            SDL_RenderCopy(renderer, nameTexture, nullptr, &nameRect);
-            SDL_DestroyTexture(nameTexture);
-            SDL_FreeSurface(nameSurface);
-        }
+        draw->Text(weapon.name, 30, y + 5, textColor);
         
         // Simple display: current / max
-        int ammo = saveFile->ReadInt32(weapon.ammo_offset);
-        
-        char ammoBuf[64];
-        snprintf(ammoBuf, sizeof(ammoBuf), "%d / %d", ammo, weapon.max_ammo);
-        
         SDL_Color valueColor = Colors::AccentHover();
-        SDL_Surface* ammoSurface = TTF_RenderUTF8_Blended(font, ammoBuf, valueColor);
-        if (ammoSurface) {
-            SDL_Texture* ammoTexture = SDL_CreateTextureFromSurface(renderer, ammoSurface);
-            SDL_Rect ammoRect = {920 - ammoSurface->w, y + 5, ammoSurface->w, ammoSurface->h};
-            SDL_RenderCopy(renderer, ammoTexture, nullptr, &ammoRect);
-            SDL_DestroyTexture(ammoTexture);
-            SDL_FreeSurface(ammoSurface);
-        }
+        const char* ammoText = fields.GetText(FieldGroup::WEAPONS, i);
+        draw->TextRight(ammoText, 920, y + 5, valueColor);
         
         SDL_Color dimColor = Colors::TextDim();
-        SDL_Surface* descSurface = TTF_RenderUTF8_Blended(font, weapon.description.c_str(), dimColor);
-        if (descSurface) {
-            SDL_Texture* descTexture = SDL_CreateTextureFromSurface(renderer, descSurface);
-            SDL_Rect descRect = {30, y + 30, descSurface->w, descSurface->h};
-            SDL_RenderCopy(renderer, descTexture, nullptr, &descRect);
-            SDL_DestroyTexture(descTexture);
-            SDL_FreeSurface(descSurface);
-        }
-        
-        y += 60;
+        draw->Text(weapon.description, 30, y + 30, dimColor);
     }
+    draw->Clip(CONTENT_AREA);
 }
 
 void SaveEditor::RenderGadgetsTab() {
-    int y = 140;
-    int visibleCount = 0;
-    const int VISIBLE_ITEMS = 6;
+    draw->Clip(list.GetClip());
     
-    for (int i = scrollOffset; i < (int)currentGameData.gadgets.size() && visibleCount < VISIBLE_ITEMS; i++, visibleCount++) {
+    for (int i = list.GetFirstVisible(); i < list.GetLastVisible(); i++) {
+        int y = list.GetRowY(i) + ROW_INSET;
         const GameGadget& gadget = currentGameData.gadgets[i];
-        bool selected = (i == selectedIndex);
-        bool owned = saveFile->ReadBool(gadget.offset, gadget.bit_index);
+        bool selected = (i == list.GetSelected());
+        bool owned = fields.GetFlag(FieldGroup::GADGETS, i);
         
         SDL_Color bgColor = selected ? Colors::SelectedLight() : Colors::Panel();
-        SDL_SetRenderDrawColor(renderer, bgColor.r, bgColor.g, bgColor.b, bgColor.a);
         SDL_Rect itemRect = {15, y - 5, 930, 55};
-        SDL_RenderFillRect(renderer, &itemRect);
+        draw->Fill(itemRect, bgColor);
         
         if (selected) {
             SDL_Color indicatorColor = Colors::Accent();
-            SDL_SetRenderDrawColor(renderer, indicatorColor.r, indicatorColor.g, indicatorColor.b, indicatorColor.a);
             SDL_Rect indicator = {15, y - 5, 5, 55};
-            SDL_RenderFillRect(renderer, &indicator);
+            draw->Fill(indicator, indicatorColor);
         }
         
         SDL_Color borderColor = selected ? Colors::Accent() : Colors::Border();
-        SDL_SetRenderDrawColor(renderer, borderColor.r, borderColor.g, borderColor.b, borderColor.a);
-        SDL_RenderDrawRect(renderer, &itemRect);
+        draw->Outline(itemRect, borderColor);
         
         DrawCheckbox(30, y + 15, owned, selected);
         
         SDL_Color textColor = selected ? Colors::Accent() : Colors::Text();
-        SDL_Surface* nameSurface = TTF_RenderUTF8_Blended(font, gadget.name.c_str(), textColor);
-        if (nameSurface) {
-            SDL_Texture* nameTexture = SDL_CreateTextureFromSurface(renderer, nameSurface);
-            SDL_Rect nameRect = {75, y + 5, nameSurface->w, nameSurface->h};
-            SDL_RenderCopy(renderer, nameTexture, nullptr, &nameRect);
-            SDL_DestroyTexture(nameTexture);
-            SDL_FreeSurface(nameSurface);
-        }
+        draw->Text(gadget.name, 75, y + 5, textColor);
         
         SDL_Color dimColor = Colors::TextDim();
-        SDL_Surface* descSurface = TTF_RenderUTF8_Blended(font, gadget.description.c_str(), dimColor);
-        if (descSurface) {
-            SDL_Texture* descTexture = SDL_CreateTextureFromSurface(renderer, descSurface);
-            SDL_Rect descRect = {75, y + 30, descSurface->w, descSurface->h};
-            SDL_RenderCopy(renderer, descTexture, nullptr, &descRect);
-            SDL_DestroyTexture(descTexture);
-            SDL_FreeSurface(descSurface);
-        }
-        
-        y += 60;
+        draw->Text(gadget.description, 75, y + 30, dimColor);
     }
+    draw->Clip(CONTENT_AREA);
 }
 
 void SaveEditor::RenderUnlockablesTab() {
-    int y = 140;
-    int visibleCount = 0;
-    const int VISIBLE_ITEMS = 6;
+    draw->Clip(list.GetClip());
     
-    for (int i = scrollOffset; i < (int)currentGameData.unlockables.size() && visibleCount < VISIBLE_ITEMS; i++, visibleCount++) {
+    for (int i = list.GetFirstVisible(); i < list.GetLastVisible(); i++) {
+        int y = list.GetRowY(i) + ROW_INSET;
         const GameUnlockable& unlockable = currentGameData.unlockables[i];
-        bool selected = (i == selectedIndex);
-        bool owned = saveFile->ReadBool(unlockable.offset, unlockable.bit_index);
+        bool selected = (i == list.GetSelected());
+        bool owned = fields.GetFlag(FieldGroup::UNLOCKABLES, i);
         
         SDL_Color bgColor = selected ? Colors::SelectedLight() : Colors::Panel();
-        SDL_SetRenderDrawColor(renderer, bgColor.r, bgColor.g, bgColor.b, bgColor.a);
         SDL_Rect itemRect = {15, y - 5, 930, 55};
-        SDL_RenderFillRect(renderer, &itemRect);
+        draw->Fill(itemRect, bgColor);
         
         if (selected) {
             SDL_Color indicatorColor = Colors::Accent();
-            SDL_SetRenderDrawColor(renderer, indicatorColor.r, indicatorColor.g, indicatorColor.b, indicatorColor.a);
             SDL_Rect indicator = {15, y - 5, 5, 55};
-            SDL_RenderFillRect(renderer, &indicator);
+            draw->Fill(indicator, indicatorColor);
         }
         
         SDL_Color borderColor = selected ? Colors::Accent() : Colors::Border();
-        SDL_SetRenderDrawColor(renderer, borderColor.r, borderColor.g, borderColor.b, borderColor.a);
-        SDL_RenderDrawRect(renderer, &itemRect);
+        draw->Outline(itemRect, borderColor);
         
         DrawCheckbox(30, y + 15, owned, selected);
         
         SDL_Color textColor = selected ? Colors::Accent() : Colors::Text();
-        SDL_Surface* nameSurface = TTF_RenderUTF8_Blended(font, unlockable.name.c_str(), textColor);
-        if (nameSurface) {
-            SDL_Texture* nameTexture = SDL_CreateTextureFromSurface(renderer, nameSurface);
-            SDL_Rect nameRect = {75, y + 5, nameSurface->w, nameSurface->h};
-            SDL_RenderCopy(renderer, nameTexture, nullptr, &nameRect);
-            SDL_DestroyTexture(nameTexture);
-            SDL_FreeSurface(nameSurface);
-        }
+        draw->Text(unlockable.name, 75, y + 5, textColor);
         
         SDL_Color dimColor = Colors::TextDim();
-        SDL_Surface* descSurface = TTF_RenderUTF8_Blended(font, unlockable.description.c_str(), dimColor);
-        if (descSurface) {
-            SDL_Texture* descTexture = SDL_CreateTextureFromSurface(renderer, descSurface);
-            SDL_Rect descRect = {75, y + 30, descSurface->w, descSurface->h};
-            SDL_RenderCopy(renderer, descTexture, nullptr, &descRect);
-            SDL_DestroyTexture(descTexture);
-            SDL_FreeSurface(descSurface);
+        draw->Text(unlockable.description, 75, y + 30, dimColor);
+    }
+    draw->Clip(CONTENT_AREA);
+}
+
+void SaveEditor::RenderHexTab() {
+    uint32_t size = saveFile ? saveFile->GetSize() : 0;
+    if (size == 0) return;
+    
+    ByteView view = saveFile->GetView();
+    uint32_t totalRows = (size + HEX_COLUMNS - 1) / HEX_COLUMNS;
+    int visibleRows = (int)std::min<uint32_t>(HEX_ROWS, totalRows - hexTopRow);
+    
+    // Known fields behind their bytes, in both columns
+    for (int r = 0; r < visibleRows; r++) {
+        uint32_t rowOffset = (hexTopRow + r) * HEX_COLUMNS;
+        int rowBytes = (int)std::min<uint32_t>(HEX_COLUMNS, size - rowOffset);
+        int y = HEX_TOP + r * HEX_ROW_HEIGHT;
+        
+        hexHits.clear();
+        fieldIndex.Find(rowOffset, rowBytes, hexHits);
+        for (const FieldRef* field : hexHits) {
+            int first = (int)(std::max(field->offset, rowOffset) - rowOffset);
+            int last = (int)(std::min<uint64_t>((uint64_t)field->offset + field->length, rowOffset + rowBytes) - rowOffset) - 1;
+            SDL_Color fieldColor = HexFieldColor(field->kind);
+            SDL_Rect hexRect = {HexCellX(first) - 2, y, HexCellX(last) + HEX_CELL_WIDTH - 4 - HexCellX(first), HEX_ROW_HEIGHT - 2};
+            draw->Fill(hexRect, fieldColor);
+            SDL_Rect asciiRect = {HEX_ASCII_X + first * HEX_ASCII_WIDTH, y, (last - first + 1) * HEX_ASCII_WIDTH, HEX_ROW_HEIGHT - 2};
+            draw->Fill(asciiRect, fieldColor);
+        }
+    }
+    
+    // Every cell of every row, back to back so the draw list submits them
+    // as one text batch
+    for (int r = 0; r < visibleRows; r++) {
+        uint32_t rowOffset = (hexTopRow + r) * HEX_COLUMNS;
+        int rowBytes = (int)std::min<uint32_t>(HEX_COLUMNS, size - rowOffset);
+        int y = HEX_TOP + r * HEX_ROW_HEIGHT;
+        
+        char cell[8];
+        snprintf(cell, sizeof(cell), "%06X", rowOffset);
+        draw->Text(cell, HEX_OFFSET_X, y, Colors::TextDim());
+        
+        const uint8_t* bytes = view.data() + rowOffset;
+        for (int c = 0; c < rowBytes; c++) {
+            // Zero bytes fill most of a save; dim them so the data stands out
+            snprintf(cell, sizeof(cell), "%02X", bytes[c]);
+            draw->Text(cell, HexCellX(c), y, bytes[c] ? Colors::Text() : Colors::TextDim());
+            
+            cell[0] = bytes[c] >= 0x20 && bytes[c] <= 0x7E ? (char)bytes[c] : '.';
+            cell[1] = 0;
+            draw->Text(cell, HEX_ASCII_X + c * HEX_ASCII_WIDTH, y, Colors::TextDim());
         }
-        
-        y += 60;
     }
+    
+    if (hexCursor / HEX_COLUMNS >= hexTopRow && hexCursor / HEX_COLUMNS < hexTopRow + visibleRows) {
+        int c = hexCursor % HEX_COLUMNS;
+        int y = HEX_TOP + (int)(hexCursor / HEX_COLUMNS - hexTopRow) * HEX_ROW_HEIGHT;
+        SDL_Color cursorColor = Colors::Accent();
+        SDL_Rect hexCursorRect = {HexCellX(c) - 3, y - 1, HEX_CELL_WIDTH - 2, HEX_ROW_HEIGHT};
+        draw->Outline(hexCursorRect, cursorColor);
+        SDL_Rect asciiCursorRect = {HEX_ASCII_X + c * HEX_ASCII_WIDTH - 1, y - 1, HEX_ASCII_WIDTH + 2, HEX_ROW_HEIGHT};
+        draw->Outline(asciiCursorRect, cursorColor);
+    }
+    
+    // Scrollbar: thumb position and height in proportion to the file
+    int trackHeight = HEX_ROWS * HEX_ROW_HEIGHT;
+    SDL_Color trackColor = Colors::PanelDark();
+    SDL_Rect trackRect = {HEX_SCROLLBAR_X, HEX_TOP, HEX_SCROLLBAR_WIDTH, trackHeight};
+    draw->Fill(trackRect, trackColor);
+    
+    int thumbHeight = std::max(16, (int)((uint64_t)trackHeight * HEX_ROWS / std::max<uint32_t>(totalRows, HEX_ROWS)));
+    uint32_t maxTopRow = totalRows > (uint32_t)HEX_ROWS ? totalRows - HEX_ROWS : 0;
+    int thumbY = HEX_TOP + (maxTopRow ? (int)((uint64_t)(trackHeight - thumbHeight) * hexTopRow / maxTopRow) : 0);
+    SDL_Color thumbColor = hexScrollbarDragging ? Colors::AccentHover() : Colors::Accent();
+    SDL_Rect thumbRect = {HEX_SCROLLBAR_X + 3, thumbY, HEX_SCROLLBAR_WIDTH - 6, thumbHeight};
+    draw->Fill(thumbRect, thumbColor);
+    
+    // What is under the cursor
+    char info[160];
+    int length = snprintf(info, sizeof(info), "0x%06X: 0x%02X  (%u)   int32 %d", hexCursor, view[hexCursor],
+                          view[hexCursor], saveFile->ReadInt32(hexCursor));
+    hexHits.clear();
+    fieldIndex.Find(hexCursor, 1, hexHits);
+    if (!hexHits.empty() && length > 0 && length < (int)sizeof(info)) {
+        snprintf(info + length, sizeof(info) - length, "   %s (%s)", hexHits[0]->name, FieldIndex::KindName(hexHits[0]->kind));
+    }
+    
+    draw->Text(info, HEX_OFFSET_X, HEX_TOP + trackHeight + 6, Colors::TextDim());
 }
 
-void SaveEditor::RenderEditingOverlay() {
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 200);
+void SaveEditor::DimBehindOverlay() {
+    // Clipped to the layer being drawn, so each band dims only itself
     SDL_Rect overlay = {0, 0, 960, 544};
-    SDL_RenderFillRect(renderer, &overlay);
-    
+    SDL_Color dim = {0, 0, 0, 200};
+    draw->Blend(overlay, dim);
+}
+
+void SaveEditor::RenderEditingOverlay() {
     SDL_Color panelColor = Colors::Panel();
-    SDL_SetRenderDrawColor(renderer, panelColor.r, panelColor.g, panelColor.b, 255);
     SDL_Rect panel = {100, 120, 760, 300};
-    SDL_RenderFillRect(renderer, &panel);
+    draw->Fill(panel, panelColor);
     
     SDL_Color borderColor = Colors::Accent();
-    SDL_SetRenderDrawColor(renderer, borderColor.r, borderColor.g, borderColor.b, 255);
     for (int i = 0; i < 3; i++) {
         SDL_Rect border = {100 - i, 120 - i, 760 + i*2, 300 + i*2};
-        SDL_RenderDrawRect(renderer, &border);
+        draw->Outline(border, borderColor);
     }
     
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    const char* title = "EDIT VALUE";
+    if (editingKind == EditKind::BYTE) title = "EDIT BYTE";
+    else if (editingKind == EditKind::JUMP) title = "GO TO OFFSET";
     
-    SDL_Surface* titleSurf = TTF_RenderUTF8_Blended(font, "EDIT VALUE", Colors::Accent());
-    if (titleSurf) {
-        SDL_Texture* titleTex = SDL_CreateTextureFromSurface(renderer, titleSurf);
-        SDL_Rect titleRect = {480 - titleSurf->w/2, 145, titleSurf->w, titleSurf->h};
-        SDL_RenderCopy(renderer, titleTex, nullptr, &titleRect);
-        SDL_DestroyTexture(titleTex);
-        SDL_FreeSurface(titleSurf);
-    }
+    draw->TextCentered(title, 480, 145, Colors::Accent());
     
     char valueBuf[64];
-    snprintf(valueBuf, sizeof(valueBuf), "%d", editingValue);
-    
-    SDL_Surface* valueSurf = TTF_RenderUTF8_Blended(font, valueBuf, Colors::AccentHover());
-    if (valueSurf) {
-        SDL_Texture* valueTex = SDL_CreateTextureFromSurface(renderer, valueSurf);
-        SDL_Rect valueRect = {480 - valueSurf->w/2, 200, valueSurf->w, valueSurf->h};
-        SDL_RenderCopy(renderer, valueTex, nullptr, &valueRect);
-        SDL_DestroyTexture(valueTex);
-        SDL_FreeSurface(valueSurf);
+    if (editingKind == EditKind::BYTE) {
+        snprintf(valueBuf, sizeof(valueBuf), "0x%02X  (%d)  at 0x%06X", editingValue, editingValue, editingOffset);
+    } else if (editingKind == EditKind::JUMP) {
+        snprintf(valueBuf, sizeof(valueBuf), "0x%06X", editingValue);
+    } else {
+        snprintf(valueBuf, sizeof(valueBuf), "%d", editingValue);
     }
     
-    char multBuf[64];
-    snprintf(multBuf, sizeof(multBuf), "Step: +/-%d", editingMultiplier);
+    draw->TextCentered(valueBuf, 480, 200, Colors::AccentHover());
     
-    SDL_Surface* multSurf = TTF_RenderUTF8_Blended(font, multBuf, Colors::TextDim());
-    if (multSurf) {
-        SDL_Texture* multTex = SDL_CreateTextureFromSurface(renderer, multSurf);
-        SDL_Rect multRect = {480 - multSurf->w/2, 245, multSurf->w, multSurf->h};
-        SDL_RenderCopy(renderer, multTex, nullptr, &multRect);
-        SDL_DestroyTexture(multTex);
-        SDL_FreeSurface(multSurf);
+    char multBuf[64];
+    if (editingKind != EditKind::VALUE) {
+        snprintf(multBuf, sizeof(multBuf), "Step: +/-0x%X", editingMultiplier);
+    } else {
+        snprintf(multBuf, sizeof(multBuf), "Step: +/-%d", editingMultiplier);
     }
     
-    char rangeBuf[64];
-    snprintf(rangeBuf, sizeof(rangeBuf), "Range: %d - %d", editingMinValue, editingMaxValue);
+    draw->TextCentered(multBuf, 480, 245, Colors::TextDim());
     
-    SDL_Surface* rangeSurf = TTF_RenderUTF8_Blended(font, rangeBuf, Colors::TextDim());
-    if (rangeSurf) {
-        SDL_Texture* rangeTex = SDL_CreateTextureFromSurface(renderer, rangeSurf);
-        SDL_Rect rangeRect = {480 - rangeSurf->w/2, 280, rangeSurf->w, rangeSurf->h};
-        SDL_RenderCopy(renderer, rangeTex, nullptr, &rangeRect);
-        SDL_DestroyTexture(rangeTex);
-        SDL_FreeSurface(rangeSurf);
+    char rangeBuf[64];
+    if (editingKind != EditKind::VALUE) {
+        snprintf(rangeBuf, sizeof(rangeBuf), "Range: 0x%X - 0x%X", editingMinValue, editingMaxValue);
+    } else {
+        snprintf(rangeBuf, sizeof(rangeBuf), "Range: %d - %d", editingMinValue, editingMaxValue);
     }
     
+    draw->TextCentered(rangeBuf, 480, 280, Colors::TextDim());
+    
     const char* controls1 = "UP/DOWN: Adjust | LEFT: Min | RIGHT: Max";
-    SDL_Surface* ctrl1Surf = TTF_RenderUTF8_Blended(font, controls1, Colors::Text());
-    if (ctrl1Surf) {
-        SDL_Texture* ctrl1Tex = SDL_CreateTextureFromSurface(renderer, ctrl1Surf);
-        SDL_Rect ctrl1Rect = {480 - ctrl1Surf->w/2, 335, ctrl1Surf->w, ctrl1Surf->h};
-        SDL_RenderCopy(renderer, ctrl1Tex, nullptr, &ctrl1Rect);
-        SDL_DestroyTexture(ctrl1Tex);
-        SDL_FreeSurface(ctrl1Surf);
-    }
+    draw->TextCentered(controls1, 480, 335, Colors::Text());
     
-    const char* controls2 = "L/R: Change Step | X: Save | O: Cancel";
-    SDL_Surface* ctrl2Surf = TTF_RenderUTF8_Blended(font, controls2, Colors::Text());
-    if (ctrl2Surf) {
-        SDL_Texture* ctrl2Tex = SDL_CreateTextureFromSurface(renderer, ctrl2Surf);
-        SDL_Rect ctrl2Rect = {480 - ctrl2Surf->w/2, 365, ctrl2Surf->w, ctrl2Surf->h};
-        SDL_RenderCopy(renderer, ctrl2Tex, nullptr, &ctrl2Rect);
-        SDL_DestroyTexture(ctrl2Tex);
-        SDL_FreeSurface(ctrl2Surf);
-    }
+    const char* controls2 = editingKind == EditKind::JUMP ? "L/R: Change Step | X: Go | O: Cancel"
+                                                          : "L/R: Change Step | X: Save | O: Cancel";
+    draw->TextCentered(controls2, 480, 365, Colors::Text());
 }
 
 void SaveEditor::RenderFooter() {
     SDL_Color panelColor = Colors::PanelDark();
-    SDL_SetRenderDrawColor(renderer, panelColor.r, panelColor.g, panelColor.b, panelColor.a);
     SDL_Rect footerRect = {0, 500, 960, 44};
-    SDL_RenderFillRect(renderer, &footerRect);
+    draw->Fill(footerRect, panelColor);
     
-    const char* controls = "X: Edit/Toggle | O: Back | START: Save | L/R: Switch Tabs";
+    const char* controls = "X: Edit/Toggle | O: Back | START: Save | L/R: Tabs | TRI/SQR: Undo/Redo";
+    if (currentTab == EditorTab::HEX) {
+        controls = "X: Edit Byte | SELECT: Go To | O: Back | START: Save | L/R: Tabs | TRI/SQR: Undo/Redo";
+    }
     
     SDL_Color dimColor = Colors::TextDim();
-    SDL_Surface* controlsSurface = TTF_RenderUTF8_Blended(font, controls, dimColor);
-    if (controlsSurface) {
-        SDL_Texture* controlsTexture = SDL_CreateTextureFromSurface(renderer, controlsSurface);
-        SDL_Rect controlsRect = {480 - controlsSurface->w/2, 510, controlsSurface->w, controlsSurface->h};
-        SDL_RenderCopy(renderer, controlsTexture, nullptr, &controlsRect);
-        SDL_DestroyTexture(controlsTexture);
-        SDL_FreeSurface(controlsSurface);
-    }
+    draw->TextCentered(controls, 480, 510, dimColor);
 }
 
 void SaveEditor::DrawCheckbox(int x, int y, bool checked, bool hovered) {
     SDL_Color borderColor = hovered ? Colors::Accent() : Colors::Border();
-    SDL_SetRenderDrawColor(renderer, borderColor.r, borderColor.g, borderColor.b, borderColor.a);
     SDL_Rect boxRect = {x, y, 30, 30};
-    SDL_RenderDrawRect(renderer, &boxRect);
+    draw->Outline(boxRect, borderColor);
     
     if (checked) {
         SDL_Color fillColor = Colors::Success();
-        SDL_SetRenderDrawColor(renderer, fillColor.r, fillColor.g, fillColor.b, fillColor.a);
         SDL_Rect fillRect = {x + 4, y + 4, 22, 22};
-        SDL_RenderFillRect(renderer, &fillRect);
+        draw->Fill(fillRect, fillColor);
     }
 }
\ No newline at end of file
@@ -1,34 +1,56 @@
 // save_editor.h - SIMPLIFIED
 #pragma once
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
+#include "../core/field_snapshot.h"
+#include "../core/save_diff.h"
 #include "../core/save_file.h"
+#include "../core/save_worker.h"
 #include "../data/rac_vita_games_data.h"
 #include "../utils/input.h"
+#include "draw_list.h"
+#include "list_view.h"
+#include "text_renderer.h"
+#include "retained_frame.h"
 
 enum class EditorTab {
     VALUES,
     WEAPONS,
     GADGETS,
-    UNLOCKABLES
+    UNLOCKABLES,
+    HEX,            // Every byte of the save, table fields highlighted
+    COUNT
+};
+
+// What the D-pad editor overlay is changing
+enum class EditKind {
+    VALUE,          // A table field (int32)
+    BYTE,           // One byte in the hex view
+    JUMP            // The hex view's cursor offset
 };
 
 class SaveEditor {
 public:
-    SaveEditor(SDL_Renderer* renderer, TTF_Font* font);
+    SaveEditor(DrawList* draw, TextRenderer* text);
     ~SaveEditor();
     
     void SetSaveFile(SaveFile* save);
     void Update(const InputState& input);
-    void Render();
+    void Render(RetainedFrame& frame);
     
     bool WantsToGoBack() const { return wantsBack; }
     void ResetBackFlag() { wantsBack = false; }
     
+    // Waits for queued background saves; call before the SaveFile is reloaded
+    void FlushSaves() { saveWorker.Flush(saveFile); }
+    
     GameType GetCurrentGameType() const { return currentGameType; }
     std::string GetGameName() const { return currentGameData.name; }
     
+    // Names the current view, e.g. for draw list captures
+    std::string GetScreenName() const;
+    
 private:
+    int GetListSize() const;        // Rows in the current table tab
     void UpdateEditingMode(const InputState& input);
     void HandleCrossPress();
     void EditValue();
@@ -37,6 +59,13 @@ private:
     void ToggleGadget();
     void ToggleUnlockable();
     
+    // Hex view: only the visible rows are ever touched, so scrolling and
+    // jumps cost the same anywhere in the file
+    void UpdateHexView(const InputState& input);
+    void SetHexCursor(int64_t offset);
+    void EditHexByte();
+    void OpenHexJump();
+    
     void RenderHeader();
     void RenderTabs();
     void RenderTabContent();
@@ -44,21 +73,26 @@ private:
     void RenderWeaponsTab();
     void RenderGadgetsTab();
     void RenderUnlockablesTab();
+    void RenderHexTab();
+    void DimBehindOverlay();
     void RenderEditingOverlay();
     void RenderFooter();
     
     void DrawCheckbox(int x, int y, bool checked, bool hovered);
     
-    SDL_Renderer* renderer;
-    TTF_Font* font;
+    DrawList* draw;
+    TextRenderer* text;        // Metrics for layout; drawing goes through draw
     SaveFile* saveFile;
+    BackupStore backups;
+    SaveWorker saveWorker;
     
     GameType currentGameType;
     GameData currentGameData;
+    FieldSnapshot fields;
+    FieldIndex fieldIndex;
     
     EditorTab currentTab;
-    int selectedIndex;
-    int scrollOffset;
+    ListView list;              // Rows of the current table tab
     bool wantsBack;
     
     // D-pad editor state
@@ -68,4 +102,15 @@ private:
     int editingMaxValue;
     int editingMultiplier;
     uint32_t editingOffset;
+    EditKind editingKind;
+    
+    // Hex view state
+    uint32_t hexCursor;
+    uint32_t hexTopRow;
+    int hexHeldFrames;
+    int hexTouchStartY;
+    uint32_t hexTouchStartRow;
+    bool hexDragging;
+    bool hexScrollbarDragging;
+    std::vector<const FieldRef*> hexHits;
 };
\ No newline at end of file
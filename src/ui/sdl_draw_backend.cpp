@@ -0,0 +1,54 @@
+// sdl_draw_backend.cpp - Plays DrawLists into the SDL renderer
+#include "sdl_draw_backend.h"
+#include <cstddef>
+
+// DrawRect arrays are handed to SDL as they are
+static_assert(sizeof(DrawRect) == sizeof(SDL_Rect) && offsetof(DrawRect, w) == offsetof(SDL_Rect, w),
+              "DrawRect must match SDL_Rect");
+
+SdlDrawBackend::SdlDrawBackend(SDL_Renderer* r, TextRenderer* t)
+    : renderer(r), text(t) {
+}
+
+void SdlDrawBackend::SetClip(const DrawRect* clip) {
+    SDL_RenderSetClipRect(renderer, (const SDL_Rect*)clip);
+}
+
+void SdlDrawBackend::SetColor(DrawColor color) {
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+}
+
+void SdlDrawBackend::SetBlend(bool blend) {
+    SDL_SetRenderDrawBlendMode(renderer, blend ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+}
+
+void SdlDrawBackend::FillRects(const DrawRect* rects, int count) {
+    if (count == 1) {
+        SDL_RenderFillRect(renderer, (const SDL_Rect*)rects);
+    } else {
+        SDL_RenderFillRects(renderer, (const SDL_Rect*)rects, count);
+    }
+}
+
+void SdlDrawBackend::OutlineRect(const DrawRect& rect) {
+    SDL_RenderDrawRect(renderer, (const SDL_Rect*)&rect);
+}
+
+void SdlDrawBackend::BeginText() {
+    text->BeginBatch();
+}
+
+void SdlDrawBackend::Text(const char* run, int x, int y, TextAlign align, DrawColor color) {
+    SDL_Color sdlColor = {color.r, color.g, color.b, color.a};
+    if (align == TextAlign::CENTER) {
+        text->DrawCentered(run, x, y, sdlColor);
+    } else if (align == TextAlign::RIGHT) {
+        text->DrawRight(run, x, y, sdlColor);
+    } else {
+        text->Draw(run, x, y, sdlColor);
+    }
+}
+
+void SdlDrawBackend::EndText() {
+    text->EndBatch();
+}
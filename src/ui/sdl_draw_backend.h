@@ -0,0 +1,26 @@
+// sdl_draw_backend.h - Plays DrawLists into the SDL renderer
+#pragma once
+#include <SDL2/SDL.h>
+#include "draw_list.h"
+#include "text_renderer.h"
+
+// Fill batches go out as SDL_RenderFillRects, text batches through one
+// TextRenderer batch
+class SdlDrawBackend : public DrawBackend {
+public:
+    SdlDrawBackend(SDL_Renderer* renderer, TextRenderer* text);
+
+    void SetClip(const DrawRect* clip) override;
+    void SetColor(DrawColor color) override;
+    void SetBlend(bool blend) override;
+    void FillRects(const DrawRect* rects, int count) override;
+    void OutlineRect(const DrawRect& rect) override;
+
+    void BeginText() override;
+    void Text(const char* text, int x, int y, TextAlign align, DrawColor color) override;
+    void EndText() override;
+
+private:
+    SDL_Renderer* renderer;
+    TextRenderer* text;
+};
@@ -0,0 +1,100 @@
+// soft_draw_backend.cpp - Headless software rasteriser for replaying DrawLists
+#include "soft_draw_backend.h"
+#include <algorithm>
+
+SoftDrawBackend::SoftDrawBackend(int w, int h)
+    : width(w), height(h), pixels((size_t)w * h, 0), clip{0, 0, w, h},
+      color{255, 255, 255, 255}, blend(false) {
+}
+
+void SoftDrawBackend::SetClip(const DrawRect* rect) {
+    clip = rect ? *rect : DrawRect{0, 0, width, height};
+}
+
+void SoftDrawBackend::SetColor(DrawColor c) {
+    color = c;
+}
+
+void SoftDrawBackend::SetBlend(bool b) {
+    blend = b;
+}
+
+void SoftDrawBackend::Fill(const DrawRect& rect, DrawColor fill, bool blended) {
+    int x0 = std::max({rect.x, clip.x, 0});
+    int y0 = std::max({rect.y, clip.y, 0});
+    int x1 = std::min({rect.x + rect.w, clip.x + clip.w, width});
+    int y1 = std::min({rect.y + rect.h, clip.y + clip.h, height});
+    if (x0 >= x1 || y0 >= y1) return;
+
+    if (!blended || fill.a == 255) {
+        uint32_t argb = ((uint32_t)fill.a << 24) | ((uint32_t)fill.r << 16) | ((uint32_t)fill.g << 8) | fill.b;
+        for (int y = y0; y < y1; y++) {
+            std::fill(&pixels[(size_t)y * width + x0], &pixels[(size_t)y * width + x1], argb);
+        }
+        return;
+    }
+
+    // dst = src * a + dst * (1 - a), alpha kept opaque as on a screen
+    uint32_t a = fill.a, inverse = 255 - a;
+    for (int y = y0; y < y1; y++) {
+        uint32_t* row = &pixels[(size_t)y * width];
+        for (int x = x0; x < x1; x++) {
+            uint32_t dst = row[x];
+            uint32_t r = (fill.r * a + ((dst >> 16) & 0xFF) * inverse) / 255;
+            uint32_t g = (fill.g * a + ((dst >> 8) & 0xFF) * inverse) / 255;
+            uint32_t b = (fill.b * a + (dst & 0xFF) * inverse) / 255;
+            row[x] = 0xFF000000u | (r << 16) | (g << 8) | b;
+        }
+    }
+}
+
+void SoftDrawBackend::FillRects(const DrawRect* rects, int count) {
+    for (int i = 0; i < count; i++) {
+        Fill(rects[i], color, blend);
+    }
+}
+
+void SoftDrawBackend::OutlineRect(const DrawRect& rect) {
+    if (rect.w <= 0 || rect.h <= 0) return;
+    Fill(DrawRect{rect.x, rect.y, rect.w, 1}, color, blend);
+    if (rect.h > 1) Fill(DrawRect{rect.x, rect.y + rect.h - 1, rect.w, 1}, color, blend);
+    if (rect.h > 2) {
+        Fill(DrawRect{rect.x, rect.y + 1, 1, rect.h - 2}, color, blend);
+        if (rect.w > 1) Fill(DrawRect{rect.x + rect.w - 1, rect.y + 1, 1, rect.h - 2}, color, blend);
+    }
+}
+
+int SoftDrawBackend::Measure(const char* text) {
+    int glyphs = 0;
+    for (const char* p = text; *p; p++) {
+        if (((uint8_t)*p & 0xC0) != 0x80) glyphs++;     // Skip UTF-8 continuation bytes
+    }
+    return glyphs * GLYPH_ADVANCE;
+}
+
+void SoftDrawBackend::Text(const char* text, int x, int y, TextAlign align, DrawColor textColor) {
+    if (align == TextAlign::CENTER) x -= Measure(text) / 2;
+    else if (align == TextAlign::RIGHT) x -= Measure(text);
+
+    for (const char* p = text; *p; p++) {
+        uint8_t byte = (uint8_t)*p;
+        if ((byte & 0xC0) == 0x80) continue;
+        if (byte != ' ') Fill(DrawRect{x, y + GLYPH_TOP, GLYPH_WIDTH, GLYPH_HEIGHT}, textColor, true);
+        x += GLYPH_ADVANCE;
+    }
+}
+
+void SoftDrawBackend::Clear(DrawColor c) {
+    DrawRect savedClip = clip;
+    clip = DrawRect{0, 0, width, height};
+    Fill(clip, c, false);
+    clip = savedClip;
+}
+
+uint64_t SoftDrawBackend::Checksum() const {
+    uint64_t hash = 14695981039346656037ull;
+    for (uint32_t pixel : pixels) {
+        hash = (hash ^ pixel) * 1099511628211ull;
+    }
+    return hash;
+}
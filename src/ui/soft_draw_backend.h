@@ -0,0 +1,47 @@
+// soft_draw_backend.h - Headless software rasteriser for replaying DrawLists
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "draw_list.h"
+
+// Draws into an ARGB8888 buffer in memory, with SDL's rules for fills,
+// outlines, blending and clipping. Text has no font: each glyph is a
+// GLYPH_WIDTH x GLYPH_HEIGHT box on a fixed advance, which costs about
+// what copying a glyph from an atlas would. Used by the host tools to time
+// and compare captured frames without a Vita.
+class SoftDrawBackend : public DrawBackend {
+public:
+    SoftDrawBackend(int width, int height);
+
+    void SetClip(const DrawRect* clip) override;
+    void SetColor(DrawColor color) override;
+    void SetBlend(bool blend) override;
+    void FillRects(const DrawRect* rects, int count) override;
+    void OutlineRect(const DrawRect& rect) override;
+
+    void BeginText() override {}
+    void Text(const char* text, int x, int y, TextAlign align, DrawColor color) override;
+    void EndText() override {}
+
+    void Clear(DrawColor color);
+
+    // FNV-1a of the pixels, for checking two replays drew the same frame
+    uint64_t Checksum() const;
+
+    static int Measure(const char* text);
+
+    static const int GLYPH_ADVANCE = 9;
+    static const int GLYPH_WIDTH = 7;
+    static const int GLYPH_HEIGHT = 13;
+    static const int GLYPH_TOP = 5;     // Below the top of the line box
+
+private:
+    int width;
+    int height;
+    std::vector<uint32_t> pixels;
+    DrawRect clip;
+    DrawColor color;
+    bool blend;
+
+    void Fill(const DrawRect& rect, DrawColor fill, bool blended);
+};
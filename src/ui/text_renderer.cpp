@@ -0,0 +1,191 @@
+// text_renderer.cpp - Glyph-atlas text drawing shared by every screen
+#include "text_renderer.h"
+#include <cstdio>
+
+// Decodes one UTF-8 sequence and advances text past it; malformed bytes
+// come out as '?'
+static uint32_t NextCodepoint(const char*& text) {
+    const uint8_t* p = (const uint8_t*)text;
+    uint32_t codepoint = '?';
+    int length = 1;
+    if (p[0] < 0x80) {
+        codepoint = p[0];
+    } else if ((p[0] & 0xE0) == 0xC0 && (p[1] & 0xC0) == 0x80) {
+        codepoint = ((p[0] & 0x1F) << 6) | (p[1] & 0x3F);
+        length = 2;
+    } else if ((p[0] & 0xF0) == 0xE0 && (p[1] & 0xC0) == 0x80 && (p[2] & 0xC0) == 0x80) {
+        codepoint = ((p[0] & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        length = 3;
+    } else if ((p[0] & 0xF8) == 0xF0 && (p[1] & 0xC0) == 0x80 && (p[2] & 0xC0) == 0x80 && (p[3] & 0xC0) == 0x80) {
+        codepoint = ((p[0] & 0x07) << 18) | ((p[1] & 0x3F) << 12) | ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+        length = 4;
+    }
+    text += length;
+    return codepoint;
+}
+
+TextRenderer::TextRenderer(SDL_Renderer* r, TTF_Font* f)
+    : renderer(r), font(f), lineHeight(TTF_FontHeight(f)), batching(false),
+      texturesCreated(0), glyphsRasterised(0) {
+}
+
+TextRenderer::~TextRenderer() {
+    for (Page& page : pages) {
+        SDL_DestroyTexture(page.texture);
+    }
+}
+
+bool TextRenderer::AddPage() {
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                             PAGE_SIZE, PAGE_SIZE);
+    if (!texture) {
+        printf("TextRenderer: cannot create atlas page: %s\n", SDL_GetError());
+        return false;
+    }
+    texturesCreated++;
+
+    // Start fully transparent so filtering at glyph edges picks up nothing
+    std::vector<uint32_t> clear(PAGE_SIZE * PAGE_SIZE, 0);
+    SDL_UpdateTexture(texture, nullptr, clear.data(), PAGE_SIZE * 4);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    Page page;
+    page.texture = texture;
+    page.penX = 1;
+    page.penY = 1;
+    page.rowHeight = 0;
+    pages.push_back(page);
+    return true;
+}
+
+void TextRenderer::Rasterise(uint32_t codepoint, Glyph& glyph) {
+    glyph.cached = true;
+
+    // The 16-bit glyph API is in every SDL_ttf the VitaSDK has shipped
+    if (codepoint > 0xFFFF || !TTF_GlyphIsProvided(font, (uint16_t)codepoint)) codepoint = '?';
+    int minX, maxX, minY, maxY, advance;
+    if (TTF_GlyphMetrics(font, (uint16_t)codepoint, &minX, &maxX, &minY, &maxY, &advance) == 0) {
+        glyph.advance = (int16_t)advance;
+    }
+    if (codepoint == ' ') return;
+
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface* surface = TTF_RenderGlyph_Blended(font, (uint16_t)codepoint, white);
+    if (!surface) return;
+    if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(surface);
+        surface = converted;
+        if (!surface) return;
+    }
+    glyphsRasterised++;
+
+    // Shelf packing: left to right, a new row when this one is full, a new
+    // page when the rows are. A pixel of padding keeps neighbours apart.
+    int w = surface->w, h = surface->h;
+    if (w + 2 <= PAGE_SIZE && h + 2 <= PAGE_SIZE) {
+        Page* page = pages.empty() ? nullptr : &pages.back();
+        if (page && page->penX + w + 1 > PAGE_SIZE) {
+            page->penX = 1;
+            page->penY += page->rowHeight + 1;
+            page->rowHeight = 0;
+        }
+        if (!page || page->penY + h + 1 > PAGE_SIZE) {
+            page = AddPage() ? &pages.back() : nullptr;
+        }
+        if (page) {
+            SDL_Rect target = {page->penX, page->penY, w, h};
+            SDL_LockSurface(surface);
+            SDL_UpdateTexture(page->texture, &target, surface->pixels, surface->pitch);
+            SDL_UnlockSurface(surface);
+
+            glyph.page = (int16_t)(pages.size() - 1);
+            glyph.source = target;
+            page->penX += w + 1;
+            if (h > page->rowHeight) page->rowHeight = h;
+        }
+    }
+    SDL_FreeSurface(surface);
+}
+
+const TextRenderer::Glyph& TextRenderer::Lookup(uint32_t codepoint) {
+    Glyph& glyph = codepoint < 128 ? ascii[codepoint] : others[codepoint];
+    if (!glyph.cached) Rasterise(codepoint, glyph);
+    return glyph;
+}
+
+void TextRenderer::Emit(const Glyph& glyph, int x, int y, SDL_Color color) {
+    Page& page = pages[glyph.page];
+    const SDL_Rect& src = glyph.source;
+
+#ifdef TEXT_RENDERER_GEOMETRY
+    float u0 = (float)src.x / PAGE_SIZE, v0 = (float)src.y / PAGE_SIZE;
+    float u1 = (float)(src.x + src.w) / PAGE_SIZE, v1 = (float)(src.y + src.h) / PAGE_SIZE;
+    float x0 = (float)x, y0 = (float)y, x1 = (float)(x + src.w), y1 = (float)(y + src.h);
+
+    int base = (int)page.vertices.size();
+    page.vertices.push_back(SDL_Vertex{{x0, y0}, color, {u0, v0}});
+    page.vertices.push_back(SDL_Vertex{{x1, y0}, color, {u1, v0}});
+    page.vertices.push_back(SDL_Vertex{{x1, y1}, color, {u1, v1}});
+    page.vertices.push_back(SDL_Vertex{{x0, y1}, color, {u0, v1}});
+    const int QUAD[6] = {0, 1, 2, 0, 2, 3};
+    for (int i : QUAD) page.indices.push_back(base + i);
+#else
+    SDL_SetTextureColorMod(page.texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(page.texture, color.a);
+    SDL_Rect target = {x, y, src.w, src.h};
+    SDL_RenderCopy(renderer, page.texture, &src, &target);
+#endif
+}
+
+void TextRenderer::Flush() {
+#ifdef TEXT_RENDERER_GEOMETRY
+    for (Page& page : pages) {
+        if (page.indices.empty()) continue;
+        SDL_RenderGeometry(renderer, page.texture, page.vertices.data(), (int)page.vertices.size(),
+                           page.indices.data(), (int)page.indices.size());
+        page.vertices.clear();
+        page.indices.clear();
+    }
+#endif
+}
+
+int TextRenderer::Draw(const char* text, int x, int y, SDL_Color color) {
+    if (!text) return 0;
+
+    int penX = x;
+    while (*text) {
+        const Glyph& glyph = Lookup(NextCodepoint(text));
+        if (glyph.page >= 0) Emit(glyph, penX, y, color);
+        penX += glyph.advance;
+    }
+    if (!batching) Flush();
+    return penX - x;
+}
+
+int TextRenderer::DrawCentered(const char* text, int centerX, int y, SDL_Color color) {
+    return Draw(text, centerX - Measure(text) / 2, y, color);
+}
+
+int TextRenderer::DrawRight(const char* text, int rightX, int y, SDL_Color color) {
+    return Draw(text, rightX - Measure(text), y, color);
+}
+
+void TextRenderer::BeginBatch() {
+    batching = true;
+}
+
+void TextRenderer::EndBatch() {
+    batching = false;
+    Flush();
+}
+
+int TextRenderer::Measure(const char* text) {
+    if (!text) return 0;
+
+    int width = 0;
+    while (*text) {
+        width += Lookup(NextCodepoint(text)).advance;
+    }
+    return width;
+}
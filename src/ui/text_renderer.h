@@ -0,0 +1,84 @@
+// text_renderer.h - Glyph-atlas text drawing shared by every screen
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define TEXT_RENDERER_GEOMETRY 1
+#endif
+
+// Each glyph is rasterised once, the first time it is drawn, into a
+// 512x512 atlas page; after that a string is a run of quads from the
+// atlas. Quads go out through SDL_RenderGeometry (one call per string, or
+// per batch) where SDL has it, and as SDL_RenderCopy calls from one texture
+// otherwise. Once the glyphs on screen have been seen, drawing creates no
+// textures and rasterises nothing.
+//
+// Layout follows the font's advances; kerning is not applied (the system
+// fonts the app uses have none).
+class TextRenderer {
+public:
+    TextRenderer(SDL_Renderer* renderer, TTF_Font* font);
+    ~TextRenderer();
+
+    // Draw UTF-8 text with the top of its line box at y; each returns the
+    // width drawn
+    int Draw(const char* text, int x, int y, SDL_Color color);
+    int DrawCentered(const char* text, int centerX, int y, SDL_Color color);
+    int DrawRight(const char* text, int rightX, int y, SDL_Color color);
+
+    // Draws between Begin and End are submitted together at End; nothing
+    // else may be drawn in between if it has to layer with the text
+    void BeginBatch();
+    void EndBatch();
+
+    // Width from cached glyph metrics
+    int Measure(const char* text);
+    int GetLineHeight() const { return lineHeight; }
+
+    size_t GetTexturesCreated() const { return texturesCreated; }
+    size_t GetGlyphsRasterised() const { return glyphsRasterised; }
+
+    static const int PAGE_SIZE = 512;
+
+private:
+    struct Glyph {
+        bool cached = false;
+        int16_t page = -1;          // -1: nothing to draw (space, missing glyph)
+        int16_t advance = 0;
+        SDL_Rect source = {0, 0, 0, 0};
+    };
+
+    struct Page {
+        SDL_Texture* texture;
+        int penX;
+        int penY;
+        int rowHeight;
+#ifdef TEXT_RENDERER_GEOMETRY
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+#endif
+    };
+
+    SDL_Renderer* renderer;
+    TTF_Font* font;
+    int lineHeight;
+    bool batching;
+
+    Glyph ascii[128];
+    std::unordered_map<uint32_t, Glyph> others;
+    std::vector<Page> pages;
+
+    size_t texturesCreated;
+    size_t glyphsRasterised;
+
+    const Glyph& Lookup(uint32_t codepoint);
+    void Rasterise(uint32_t codepoint, Glyph& glyph);
+    bool AddPage();
+    void Emit(const Glyph& glyph, int x, int y, SDL_Color color);
+    void Flush();
+};